@@ -0,0 +1,182 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// build/host/bank_scanner_check.cpp
+//
+// Host check for the Buttons scanning core, used by build/scripts/host_check.sh.
+// Drives VerticalDebouncer and BankScanner with a simulated pair of GPIO input
+// registers and checks the debounce contract: a level held for fewer than COUNT
+// samples never shows, a held level flips on exactly the COUNT-th sample, only
+// tracked pins are reported, and each bank is read at most once per scan.
+//
+// Exits non-zero and names the failed check when something is off.
+
+#include "Modules/Hardware/Buttons/BankScanner.h"
+
+#include <array>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using xewe::input::BankScanner;
+using xewe::input::VerticalDebouncer;
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const char* what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    failures++;
+}
+
+constexpr uint8_t COUNT = VerticalDebouncer::COUNT;
+
+// two banks of simulated input registers, like GPIO_IN_REG / GPIO_IN1_REG
+struct Registers {
+    std::array<uint32_t, 2> words   {};
+    std::array<uint32_t, 2> reads   {};
+
+    void set(uint8_t pin, bool level) {
+        if (level) words[pin / 32] |=  (1UL << (pin % 32));
+        else       words[pin / 32] &= ~(1UL << (pin % 32));
+    }
+};
+
+using changes_t = std::vector<std::pair<uint8_t, bool>>;
+
+changes_t scan(BankScanner<2>& scanner, Registers& regs) {
+    changes_t changes;
+    scanner.scan([&regs](size_t bank) { regs.reads[bank]++; return regs.words[bank]; },
+                 [&changes](uint8_t pin, bool level) { changes.emplace_back(pin, level); });
+    return changes;
+}
+
+void check_debouncer() {
+    VerticalDebouncer debouncer;
+    const uint32_t bit = 1U << 7;
+
+    // bounce: the new level for COUNT - 1 samples, then back; never reported
+    for (int burst = 0; burst < 3; burst++) {
+        for (uint8_t i = 0; i + 1 < COUNT; i++) expect(debouncer.sample(bit) == 0, "bounce shorter than COUNT is rejected");
+        expect(debouncer.sample(0) == 0, "returning to the old level reports nothing");
+    }
+    expect(debouncer.state() == 0, "state unchanged after bounces");
+
+    // held: flips on exactly the COUNT-th sample, and only once
+    for (uint8_t i = 1; i < COUNT; i++) expect(debouncer.sample(bit) == 0, "no flip before COUNT samples");
+    expect(debouncer.sample(bit) == bit, "flip on the COUNT-th sample");
+    expect(debouncer.state() == bit, "state follows the flip");
+    expect(debouncer.sample(bit) == 0, "a steady level reports nothing more");
+
+    // and back down the same way
+    for (uint8_t i = 1; i < COUNT; i++) expect(debouncer.sample(0) == 0, "no release before COUNT samples");
+    expect(debouncer.sample(0) == bit, "release on the COUNT-th sample");
+
+    // inputs count independently within the word
+    const uint32_t other = 1U << 20;
+    debouncer.sample(other);
+    uint32_t flipped = 0;
+    for (uint8_t i = 1; i < COUNT; i++) flipped |= debouncer.sample(bit | other);
+    expect(flipped == other, "an input that started earlier flips first");
+    expect(debouncer.sample(bit | other) == bit, "the later input flips COUNT samples after it started");
+
+    // preset sets the state silently and drops a running count
+    VerticalDebouncer preset;
+    for (uint8_t i = 1; i < COUNT; i++) preset.sample(bit);
+    preset.preset(bit, 0);
+    expect(preset.sample(bit) == 0, "preset restarts the count");
+    preset.preset(bit, bit);
+    expect(preset.state() == bit, "preset sets the level");
+    expect(preset.sample(bit) == 0, "preset reports no change");
+}
+
+void check_scanner() {
+    BankScanner<2> scanner;
+    Registers regs;
+
+    expect(!scanner.tracking(), "a new scanner tracks nothing");
+    scan(scanner, regs);
+    expect(regs.reads[0] == 0 && regs.reads[1] == 0, "no bank is read with nothing tracked");
+
+    // pin 40 is already high when it starts being tracked: no change reported
+    regs.set(40, true);
+    scanner.track(4, false);
+    scanner.track(40, true);
+    expect(scanner.tracking(), "tracking after track()");
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "preset level is not reported");
+    expect(regs.reads[0] == 2 * COUNT && regs.reads[1] == 2 * COUNT, "each bank read once per scan");
+
+    // an untracked pin in a tracked bank is masked out
+    regs.set(9, true);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "untracked pins are not reported");
+
+    // a bounce on pin 4 shorter than COUNT scans is rejected
+    for (uint8_t i = 0; i + 1 < COUNT; i++) {
+        regs.set(4, true);
+        expect(scan(scanner, regs).empty(), "bounce on a tracked pin is not reported");
+    }
+    regs.set(4, false);
+    expect(scan(scanner, regs).empty(), "bounce ends without a change");
+
+    // held for COUNT scans: one change, on the last of them
+    regs.set(4, true);
+    for (uint8_t i = 1; i < COUNT; i++) expect(scan(scanner, regs).empty(), "no change before COUNT scans");
+    const changes_t pressed = scan(scanner, regs);
+    expect(pressed.size() == 1 && pressed[0] == std::make_pair(uint8_t{4}, true), "pin 4 reported high after COUNT scans");
+
+    // the high bank reports its own pin numbers
+    regs.set(40, false);
+    for (uint8_t i = 1; i < COUNT; i++) scan(scanner, regs);
+    const changes_t released = scan(scanner, regs);
+    expect(released.size() == 1 && released[0] == std::make_pair(uint8_t{40}, false), "pin 40 reported low after COUNT scans");
+
+    // untracking a pin that is high while another pin keeps its bank scanned: the
+    // masked raw bit reads 0 from then on, which must not come out as a release
+    regs.set(5, true);
+    scanner.track(5, true);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "pin 5 tracked at its preset level");
+    scanner.untrack(5);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "an untracked high pin is not reported falling");
+    scanner.track(5, true);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "re-tracked high pin starts at its preset level");
+    scanner.untrack(5);
+
+    // untracking the only pin in a bank stops reads of that bank
+    scanner.untrack(40);
+    const uint32_t bank1_reads = regs.reads[1];
+    regs.set(40, true);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "untracked pin is not reported");
+    expect(regs.reads[1] == bank1_reads, "a bank with nothing tracked is not read");
+
+    // re-tracking presets the level, so the pin picks up where the register is
+    scanner.track(40, true);
+    for (uint8_t i = 0; i < 2 * COUNT; i++) expect(scan(scanner, regs).empty(), "re-tracked pin starts at its preset level");
+
+    // out of range pins are ignored
+    scanner.track(BankScanner<2>::PINS, true);
+    scanner.untrack(BankScanner<2>::PINS);
+
+    scanner.clear();
+    expect(!scanner.tracking(), "clear() untracks everything");
+}
+
+} // namespace
+
+int main() {
+    check_debouncer();
+    check_scanner();
+    if (failures) {
+        std::printf("bank_scanner_check: %d failed\n", failures);
+        return 1;
+    }
+    std::printf("bank_scanner_check: ok\n");
+    return 0;
+}
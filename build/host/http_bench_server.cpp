@@ -0,0 +1,261 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// build/host/http_bench_server.cpp
+//
+// Host stand-in for WebInterface, used by build/scripts/host_bench.sh. It runs the
+// real HttpServer on a loopback socket with the same routes and the same response
+// shapes as the firmware: the embedded pages (gzip + ETag), /cmd, /api/cmd,
+// /api/modules, /metrics and /events. Commands are echoed instead of parsed, so
+// numbers measure the HTTP path, not the modules behind it; --cmd-cost-us adds a
+// busy wait per command to stand in for a real parse.
+//
+// On exit it prints the server counters, per-route stats and the process RSS high
+// water, the host analogue of the heap high water the firmware reports.
+
+#include "HttpServer.h"
+#include "web_assets.h"
+#include "XeWeJson.h"
+#include "XeWeMetrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> running {true};
+
+uint32_t now_ms() {
+    using namespace std::chrono;
+    static const auto start = steady_clock::now();
+    return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now() - start).count());
+}
+
+// peak resident set size; Linux reports KiB, macOS bytes
+uint64_t max_rss_bytes() {
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024ULL;
+#endif
+}
+
+void spin_us(uint32_t us) {
+    if (!us) return;
+    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < until) {}
+}
+
+const char* const MODULE_NAMES[] = {
+    "System", "Serial_Port", "Nvs", "Command_Parser", "Wifi", "Web_Interface", "Buttons", "Pins", "Led_Strip", "Timers",
+};
+
+} // namespace
+
+class BenchServer {
+public:
+    BenchServer(uint16_t port, uint32_t cmd_cost_us) : http_server(port), cmd_cost_us(cmd_cost_us) {}
+
+    bool begin() {
+        http_server.on("/", HTTP_GET, [this] { serve_asset(WEB_ASSET_INDEX_HTML); });
+        http_server.on("/provision", HTTP_GET, [this] { serve_asset(WEB_ASSET_PROVISION_HTML); });
+        http_server.on("/cmd", HTTP_GET, [this] { handle_command_request(); });
+        http_server.on("/api/cmd", HTTP_POST, [this] { handle_api_command_batch(); });
+        http_server.on("/api/modules", HTTP_GET, [this] { handle_api_modules(); });
+        http_server.on("/metrics", HTTP_GET, [this] { handle_metrics(); });
+        http_server.on_event_stream("/events", [this](uint8_t client) {
+            http_server.sse_send(client, "snapshot", telemetry_json());
+        });
+        http_server.onNotFound([this] { http_server.send(404, "text/plain", "Not found: " + http_server.uri()); });
+        return http_server.begin();
+    }
+
+    void loop() {
+        if (now_ms() - last_telemetry_ms >= 1000) {
+            last_telemetry_ms = now_ms();
+            if (http_server.sse_clients()) http_server.sse_broadcast("telemetry", telemetry_json());
+        }
+        http_server.handleClient();
+        loop_iterations++;
+    }
+
+    void report() const {
+        const HttpServer::Stats& http = http_server.stats();
+        std::printf("\n--- http_bench_server ---\n");
+        std::printf("connections : %lu accepted, %lu rejected, peak %u open\n",
+                    (unsigned long)http.accepted, (unsigned long)http.rejected, unsigned(http.peak_open));
+        std::printf("requests    : %lu (%lu timed out, %lu too large)\n",
+                    (unsigned long)http.requests, (unsigned long)http.timeouts, (unsigned long)http.oversize);
+        std::printf("high water  : %zu bytes buffered, %.1f MiB RSS\n",
+                    http.peak_buffered, max_rss_bytes() / 1048576.0);
+        std::printf("%-18s %8s %6s %6s %12s %8s %8s %8s\n", "route", "reqs", "4xx", "5xx", "out bytes", "p50 us", "p90 us", "max us");
+        const auto row = [](const HttpServer::RouteStats& r) {
+            if (!r.requests) return;
+            std::printf("%-18s %8lu %6lu %6lu %12llu %8ld %8ld %8ld\n", r.label.c_str(), (unsigned long)r.requests,
+                        (unsigned long)r.responses[3], (unsigned long)r.responses[4], (unsigned long long)r.bytes_out,
+                        (long)r.latency_us.percentile(50), (long)r.latency_us.percentile(90), (long)r.latency_us.max());
+        };
+        for (const auto& route : http_server.route_stats()) row(route);
+        row(http_server.unmatched_stats());
+    }
+
+private:
+    void serve_asset(const WebAsset& asset) {
+        http_server.sendHeader("ETag", asset.etag);
+        http_server.sendHeader("Cache-Control", "no-cache");
+        http_server.sendHeader("Vary", "Accept-Encoding");
+
+        const std::string if_none_match = http_server.header("If-None-Match");
+        if (!if_none_match.empty()
+            && (if_none_match == "*" || if_none_match.find(asset.etag) != std::string::npos)) {
+            http_server.send(304);
+            return;
+        }
+        http_server.sendHeader("Content-Encoding", "gzip");
+        http_server.send_P(200, asset.content_type, reinterpret_cast<const char*>(asset.data), asset.length);
+    }
+
+    std::string run(const std::string& command_text) {
+        spin_us(cmd_cost_us);
+        return "ran: " + command_text + "\n";
+    }
+
+    void handle_command_request() {
+        if (!http_server.hasArg("c")) {
+            http_server.send(400, "text/plain", "Empty Command");
+            return;
+        }
+        http_server.sendHeader("X-Command-Status", "ok");
+        http_server.sendHeader("X-Exit-Code", "0");
+        http_server.send(200, "text/plain", run(http_server.arg("c")));
+    }
+
+    void handle_api_command_batch() {
+        std::vector<std::string> commands;
+        if (!xewe::json::parse_string_array(http_server.arg("plain"), commands, 16)) {
+            http_server.send(400, "application/json", "{\"error\":\"expected a JSON array of up to 16 command strings\"}");
+            return;
+        }
+        http_server.begin_stream(200, "application/json");
+        xewe::json::Writer out([this](std::string_view text) { http_server.stream(text); });
+        out.begin_object();
+        out.begin_array("results");
+        for (const auto& command_text : commands) {
+            out.begin_object();
+            out.field("command", command_text);
+            out.field("status", "ok");
+            out.field("exit_code", 0);
+            out.field("output", run(command_text));
+            out.field("truncated", false);
+            out.end_object();
+        }
+        out.end_array();
+        out.field("executed", commands.size());
+        out.field("failed", 0);
+        out.end_object();
+    }
+
+    void handle_api_modules() {
+        http_server.begin_stream(200, "application/json");
+        xewe::json::Writer out([this](std::string_view text) { http_server.stream(text); });
+        out.begin_object();
+        out.field("uptime_ms", now_ms());
+        out.begin_array("modules");
+        for (const char* name : MODULE_NAMES) {
+            out.begin_object();
+            out.field("name", name);
+            out.field("enabled", true);
+            out.begin_object("status");
+            out.field("text", std::string(name) + " running, nothing to report");
+            out.end_object();
+            out.end_object();
+        }
+        out.end_array();
+        out.end_object();
+    }
+
+    void handle_metrics() {
+        http_server.begin_stream(200, "text/plain; version=0.0.4");
+        xewe::metrics::Writer out([this](std::string_view text) { http_server.stream(text); });
+        const HttpServer::Stats& http = http_server.stats();
+        out.gauge("uptime_seconds", "Time since start.", now_ms() / 1000U);
+        out.gauge("process_max_rss_bytes", "Peak resident set size of the host process.", max_rss_bytes());
+        out.counter("loop_iterations_total", "Main loop passes.", loop_iterations);
+        out.counter("http_connections_total", "Accepted HTTP connections.", http.accepted);
+        out.counter("http_rejected_total", "Connections turned away with 503.", http.rejected);
+        out.counter("http_requests_total", "HTTP requests dispatched.", http.requests);
+        out.gauge("http_open_connections", "Open HTTP connections.", http.open);
+        out.gauge("http_peak_connections", "Most HTTP connections open at once.", http.peak_open);
+        out.gauge("http_peak_buffered_bytes", "Most bytes held in HTTP request and response buffers at once.", http.peak_buffered);
+        out.family("http_route_requests_total", "counter", "Requests dispatched, by route.");
+        for (const auto& r : http_server.route_stats()) out.sample("http_route_requests_total", "route", r.label, r.requests);
+    }
+
+    std::string telemetry_json() const {
+        std::string body;
+        xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+        out.begin_object();
+        out.field("t", now_ms());
+        out.field("loop_iterations", loop_iterations);
+        out.field("max_rss", max_rss_bytes());
+        out.end_object();
+        return body;
+    }
+
+    HttpServer                  http_server;
+    uint32_t                    cmd_cost_us;
+    uint32_t                    last_telemetry_ms           {0};
+    uint64_t                    loop_iterations             {0};
+};
+
+int main(int argc, char** argv) {
+    uint16_t port        = 8080;
+    uint32_t seconds     = 0;
+    uint32_t cmd_cost_us = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if      (!std::strcmp(argv[i], "--port"))        port        = static_cast<uint16_t>(std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--seconds"))     seconds     = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--cmd-cost-us")) cmd_cost_us = static_cast<uint32_t>(std::atoi(argv[i + 1]));
+        else {
+            std::fprintf(stderr, "usage: %s [--port 8080] [--seconds 0] [--cmd-cost-us 0]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::signal(SIGINT,  [](int) { running = false; });
+    std::signal(SIGTERM, [](int) { running = false; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    BenchServer server(port, cmd_cost_us);
+    if (!server.begin()) {
+        std::perror("http_bench_server: listen");
+        return 1;
+    }
+    std::printf("http_bench_server listening on 127.0.0.1:%u\n", unsigned(port));
+    std::fflush(stdout);
+
+    // the firmware polls once per main loop pass; sleep briefly when idle so the
+    // stand-in doesn't pin a core, like the loop's own yield on the device
+    while (running && (!seconds || now_ms() < seconds * 1000U)) {
+        server.loop();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    server.report();
+    return 0;
+}
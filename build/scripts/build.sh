@@ -148,6 +148,11 @@ cat > "${BUILD_INFO_H}" <<EOF
 EOF
 echo "📝 Wrote ${BUILD_INFO_H}"
 
+# ---------- Embed gzipped web assets BEFORE compile ----------
+"${VENV_DIR}/bin/python" "${SCRIPT_DIR}/embed_assets.py" \
+  --assets "${PROJECT_ROOT}/src/Modules/Software/WebInterface/assets" \
+  --out "${PROJECT_ROOT}/src/Modules/Software/WebInterface/web_assets.h" || { echo "❌ Asset embedding failed"; exit 1; }
+
 # ---------- Decide phases (port optional) ----------
 DO_UPLOAD=0
 DO_MONITOR_FINAL=0
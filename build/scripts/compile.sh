@@ -27,6 +27,8 @@ set -euo pipefail
 # Notes:
 # - No version state is modified here.
 # - We upload a merged image; if the core doesn't produce it, we merge via esptool.
+# - Two OTA app slots (min_spiffs) so devices can update over HTTP (POST /ota).
+#   The manifest part carries a sha256 of the image, which the device checks.
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 
@@ -119,7 +121,7 @@ EraseFlash=all,\
 FlashMode=qio,\
 FlashSize=4M,\
 JTAGAdapter=default,\
-PartitionScheme=no_ota,\
+PartitionScheme=min_spiffs,\
 UploadSpeed=921600\
 "
 FQBN_OPTS="${FQBN_OPTS_DEFAULT}${FQBN_EXTRA_OPTS:+,${FQBN_EXTRA_OPTS}}"
@@ -254,6 +256,16 @@ MERGED_BIN_FILENAME="${VERSION_NEXT}-${CHIP_FAMILY}-${PROJECT_NAME}.bin"
 cp -a "${MERGED_BIN}" "${BINARY_DIR}/${MERGED_BIN_FILENAME}"
 
 # ---------- Manifest (ESP Web Tools v10) ----------
+# sha256 is ignored by ESP Web Tools; OTA uploads are verified against it
+sha256_of() {
+  if command -v sha256sum >/dev/null 2>&1; then
+    sha256sum "$1" | cut -d' ' -f1
+  else
+    shasum -a 256 "$1" | cut -d' ' -f1
+  fi
+}
+MERGED_BIN_SHA256="$(sha256_of "${BINARY_DIR}/${MERGED_BIN_FILENAME}")"
+
 cat > "${BINARY_DIR}/manifest.json" <<EOF
 {
   "name": "${MANIFEST_NAME}",
@@ -263,7 +275,7 @@ cat > "${BINARY_DIR}/manifest.json" <<EOF
     {
       "chipFamily": "${CHIP_FAMILY}",
       "parts": [
-        { "path": "${MERGED_BIN_FILENAME}", "offset": 0 }
+        { "path": "${MERGED_BIN_FILENAME}", "offset": 0, "sha256": "${MERGED_BIN_SHA256}" }
       ]
     }
   ]
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""embed_assets.py — gzip web UI assets into a PROGMEM header.
+
+Every file in --assets becomes a gzip-compressed byte array plus a WebAsset
+descriptor (content type, length, strong ETag from the SHA-256 of the
+uncompressed file). Output is deterministic (gzip mtime is zeroed), so an
+unchanged asset yields an unchanged header and ETag.
+
+Usage:
+  embed_assets.py --assets <dir> --out <header.h>
+"""
+
+import argparse
+import gzip
+import hashlib
+import pathlib
+import re
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css":  "text/css",
+    ".js":   "application/javascript",
+    ".json": "application/json",
+    ".svg":  "image/svg+xml",
+    ".ico":  "image/x-icon",
+    ".png":  "image/png",
+}
+
+HEADER_PREAMBLE = """\
+#pragma once
+// Auto-generated by build/scripts/embed_assets.py — DO NOT EDIT.
+// Sources: src/Modules/Software/WebInterface/assets/
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#define PROGMEM
+#endif
+
+struct WebAsset {
+    const char*     content_type;
+    const uint8_t*  data;           // gzip
+    size_t          length;
+    const char*     etag;           // quoted, strong
+};
+"""
+
+
+def symbol_for(path: pathlib.Path) -> str:
+    return "WEB_ASSET_" + re.sub(r"[^A-Za-z0-9]", "_", path.name).upper()
+
+
+def render(path: pathlib.Path) -> str:
+    raw = path.read_bytes()
+    packed = gzip.compress(raw, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(raw).hexdigest()[:16]
+    content_type = CONTENT_TYPES.get(path.suffix.lower(), "application/octet-stream")
+    symbol = symbol_for(path)
+
+    rows = []
+    for i in range(0, len(packed), 16):
+        rows.append("    " + ", ".join(f"0x{b:02x}" for b in packed[i:i + 16]) + ",")
+    body = "\n".join(rows)
+
+    return (
+        f"\n// {path.name}: {len(raw)} -> {len(packed)} bytes\n"
+        f"static const uint8_t {symbol}_GZ[] PROGMEM = {{\n{body}\n}};\n"
+        f"static const WebAsset {symbol} = {{\"{content_type}\", {symbol}_GZ, sizeof({symbol}_GZ), \"\\\"{etag}\\\"\"}};\n"
+    )
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--assets", required=True, type=pathlib.Path)
+    parser.add_argument("--out", required=True, type=pathlib.Path)
+    args = parser.parse_args()
+
+    files = sorted(p for p in args.assets.iterdir() if p.is_file() and not p.name.startswith("."))
+    if not files:
+        print(f"❌ No assets in {args.assets}", file=sys.stderr)
+        return 1
+
+    text = HEADER_PREAMBLE + "".join(render(p) for p in files)
+    if args.out.exists() and args.out.read_text() == text:
+        print(f"📦 Web assets unchanged ({len(files)} files)")
+        return 0
+    args.out.write_text(text)
+    print(f"📦 Wrote {args.out} ({len(files)} files)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# host_bench.sh — Builds the host stand-in of the web interface and load tests it.
+#
+# build/host/http_bench_server.cpp runs the firmware's HttpServer on a loopback
+# socket with the same routes as WebInterface; loadtest.py then drives it through
+# every scenario. Needs a C++17 compiler and python3, nothing from the ESP32 toolchain.
+# The server prints its own counters, per-route latency and RSS high water on exit.
+#
+# Usage examples:
+#   ./host_bench.sh
+#   ./host_bench.sh -d 5 -c 6 -s static,cmd
+#   ./host_bench.sh --cmd-cost-us 2000        # make each command as slow as a real parse
+#
+# Flags:
+#   -p, --port         Loopback port (default: 18080)
+#   -d, --duration     Seconds per scenario (default: 10)
+#   -c, --concurrency  Parallel connections (default: 4)
+#   -s, --scenarios    Comma-separated scenario names or "all" (default: all)
+#       --cmd-cost-us  Busy wait per command in the stand-in (default: 0)
+#       --no-keepalive One request per connection
+#   -h, --help
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "${SCRIPT_DIR}/../.." && pwd)"
+WEB_DIR="${PROJECT_ROOT}/src/Modules/Software/WebInterface"
+BIN_DIR="${PROJECT_ROOT}/build/host/bin"
+SERVER_BIN="${BIN_DIR}/http_bench_server"
+
+usage() {
+  sed -n '1,25p' "$0" | sed 's/^# \{0,1\}//'
+  exit 0
+}
+
+PORT=18080
+DURATION=10
+CONCURRENCY=4
+SCENARIOS="all"
+CMD_COST_US=0
+LOADTEST_EXTRA=()
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -p|--port)        PORT="${2:-}"; shift 2 ;;
+    -d|--duration)    DURATION="${2:-}"; shift 2 ;;
+    -c|--concurrency) CONCURRENCY="${2:-}"; shift 2 ;;
+    -s|--scenarios)   SCENARIOS="${2:-}"; shift 2 ;;
+    --cmd-cost-us)    CMD_COST_US="${2:-}"; shift 2 ;;
+    --no-keepalive)   LOADTEST_EXTRA+=(--no-keepalive); shift ;;
+    -h|--help)        usage ;;
+    *) echo "Unknown arg: $1"; usage ;;
+  esac
+done
+
+CXX="${CXX:-c++}"
+command -v "${CXX}"  >/dev/null 2>&1 || { echo "❌ C++ compiler not found (set CXX)"; exit 1; }
+command -v python3 >/dev/null 2>&1 || { echo "❌ python3 not found"; exit 1; }
+
+# ---------- Build ----------
+mkdir -p "${BIN_DIR}"
+echo "🔨 Building ${SERVER_BIN#${PROJECT_ROOT}/}"
+"${CXX}" -std=c++17 -O2 -Wall -Wextra \
+  -I"${WEB_DIR}" -I"${PROJECT_ROOT}/src" \
+  "${PROJECT_ROOT}/build/host/http_bench_server.cpp" "${WEB_DIR}/HttpServer.cpp" \
+  -o "${SERVER_BIN}"
+
+# ---------- Run ----------
+"${SERVER_BIN}" --port "${PORT}" --cmd-cost-us "${CMD_COST_US}" &
+SERVER_PID=$!
+trap 'kill "${SERVER_PID}" 2>/dev/null || true' EXIT
+
+for _ in $(seq 1 50); do
+  (exec 3<>"/dev/tcp/127.0.0.1/${PORT}") 2>/dev/null && break
+  sleep 0.1
+done
+
+STATUS=0
+python3 "${SCRIPT_DIR}/loadtest.py" --host 127.0.0.1 --port "${PORT}" \
+  --scenarios "${SCENARIOS}" --duration "${DURATION}" --concurrency "${CONCURRENCY}" \
+  ${LOADTEST_EXTRA[@]+"${LOADTEST_EXTRA[@]}"} || STATUS=$?
+
+kill -INT "${SERVER_PID}" 2>/dev/null || true
+wait "${SERVER_PID}" 2>/dev/null || true
+trap - EXIT
+exit "${STATUS}"
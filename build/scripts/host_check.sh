@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# host_check.sh — Builds and runs the host checks in build/host.
+#
+# bank_scanner_check.cpp drives the Buttons scanning core (BankScanner.h) with a
+# simulated GPIO input register. Needs a C++17 compiler, nothing from the ESP32
+# toolchain. Exits non-zero if any check fails.
+#
+# Usage examples:
+#   ./host_check.sh
+#   CXX=clang++ ./host_check.sh
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(cd "${SCRIPT_DIR}/../.." && pwd)"
+BIN_DIR="${PROJECT_ROOT}/build/host/bin"
+
+CXX="${CXX:-c++}"
+command -v "${CXX}" >/dev/null 2>&1 || { echo "❌ C++ compiler not found (set CXX)"; exit 1; }
+
+mkdir -p "${BIN_DIR}"
+STATUS=0
+for CHECK in bank_scanner_check; do
+  echo "🔨 Building build/host/bin/${CHECK}"
+  "${CXX}" -std=c++17 -O2 -Wall -Wextra -Werror \
+    -I"${PROJECT_ROOT}/src" \
+    "${PROJECT_ROOT}/build/host/${CHECK}.cpp" \
+    -o "${BIN_DIR}/${CHECK}"
+  "${BIN_DIR}/${CHECK}" || STATUS=1
+done
+exit "${STATUS}"
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""loadtest.py — HTTP load generator for the web interface.
+
+Runs one or more scenarios from loadtest_scenarios.json against a device or the
+host stand-in (see host_bench.sh). Each worker holds one connection (keep-alive
+unless --no-keepalive) and sends requests back to back for --duration seconds.
+Reports throughput, latency percentiles and status codes per scenario, plus the
+memory high-water marks the target exports on /metrics: heap on a device, RSS on
+the host stand-in, and the HTTP server's peak connections and buffered bytes.
+
+Keep --concurrency at or below HttpServer::MAX_CONNECTIONS (6); extra connections
+are answered 503 and counted as rejected. On a device, lift the /cmd rate limit
+first ($web_interface rate_limit 0 1) or the command scenarios measure 429s.
+
+Usage:
+  loadtest.py --host <addr> [--port 80] [--scenarios static,cmd|all]
+              [--concurrency 4] [--duration 10] [--no-keepalive] [--json]
+"""
+
+import argparse
+import asyncio
+import json
+import pathlib
+import random
+import sys
+import time
+from collections import Counter
+
+SCENARIO_FILE = pathlib.Path(__file__).with_name("loadtest_scenarios.json")
+
+# /metrics samples reported as high-water marks, when the target exports them
+MEMORY_METRICS = {
+    "xewe_heap_min_free_bytes":      "heap min free",
+    "xewe_heap_free_bytes":          "heap free",
+    "xewe_process_max_rss_bytes":    "host max RSS",
+    "xewe_http_peak_buffered_bytes": "http peak buffered",
+    "xewe_http_peak_connections":    "http peak connections",
+}
+
+
+class Response:
+    __slots__ = ("status", "headers", "body_bytes", "keep_alive")
+
+
+async def read_response(reader: asyncio.StreamReader, head_only: bool) -> Response:
+    line = await reader.readline()
+    if not line:
+        raise ConnectionError("connection closed")
+    parts = line.decode("latin-1").split(" ", 2)
+    resp = Response()
+    resp.status = int(parts[1])
+    resp.headers = {}
+    while True:
+        line = await reader.readline()
+        if line in (b"\r\n", b"\n", b""):
+            break
+        name, _, value = line.decode("latin-1").partition(":")
+        resp.headers[name.strip().lower()] = value.strip()
+
+    resp.body_bytes = 0
+    no_body = head_only or resp.status in (204, 304) or 100 <= resp.status < 200
+    if no_body:
+        pass
+    elif resp.headers.get("transfer-encoding", "").lower() == "chunked":
+        while True:
+            size = int((await reader.readline()).split(b";")[0], 16)
+            if size == 0:
+                while (await reader.readline()) not in (b"\r\n", b"\n", b""):
+                    pass
+                break
+            await reader.readexactly(size + 2)
+            resp.body_bytes += size
+    elif "content-length" in resp.headers:
+        length = int(resp.headers["content-length"])
+        await reader.readexactly(length)
+        resp.body_bytes = length
+    else:
+        resp.body_bytes = len(await reader.read())
+        resp.headers["connection"] = "close"
+
+    resp.keep_alive = resp.headers.get("connection", "").lower() != "close"
+    return resp
+
+
+def build_request(req: dict, host: str, keep_alive: bool, etag: str) -> bytes:
+    body = req.get("body", "").encode()
+    headers = {"Host": host, "User-Agent": "xewe-loadtest"}
+    headers.update(req.get("headers", {}))
+    if req.get("revalidate") and etag:
+        headers["If-None-Match"] = etag
+    if body:
+        headers["Content-Length"] = str(len(body))
+    headers["Connection"] = "keep-alive" if keep_alive else "close"
+    head = f"{req['method']} {req['path']} HTTP/1.1\r\n" + "".join(f"{k}: {v}\r\n" for k, v in headers.items())
+    return head.encode("latin-1") + b"\r\n" + body
+
+
+class Result:
+    def __init__(self):
+        self.latencies = []
+        self.statuses = Counter()
+        self.errors = Counter()
+        self.bytes = 0
+
+
+async def worker(args, requests, weights, deadline: float, result: Result, etags: dict):
+    reader = writer = None
+    while time.monotonic() < deadline:
+        req = random.choices(requests, weights)[0] if len(requests) > 1 else requests[0]
+        try:
+            if writer is None:
+                reader, writer = await asyncio.wait_for(
+                    asyncio.open_connection(args.host, args.port), args.timeout)
+            started = time.perf_counter()
+            writer.write(build_request(req, args.host, args.keepalive, etags.get(req["path"], "")))
+            await writer.drain()
+            resp = await asyncio.wait_for(read_response(reader, req["method"] == "HEAD"), args.timeout)
+            result.latencies.append(time.perf_counter() - started)
+            result.statuses[resp.status] += 1
+            result.bytes += resp.body_bytes
+            if "etag" in resp.headers:
+                etags[req["path"]] = resp.headers["etag"]
+            if resp.status == 503 or not (args.keepalive and resp.keep_alive):
+                writer.close()
+                writer = None
+            if resp.status in (429, 503):
+                # honour the server's back-off instead of hammering it
+                await asyncio.sleep(min(float(resp.headers.get("retry-after", "1") or 1), 1.0))
+        except (OSError, ConnectionError, asyncio.IncompleteReadError, asyncio.TimeoutError, ValueError) as e:
+            result.errors[type(e).__name__] += 1
+            if writer is not None:
+                writer.close()
+            writer = None
+            await asyncio.sleep(0.05)
+    if writer is not None:
+        writer.close()
+
+
+def percentile(sorted_values, p: float) -> float:
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, max(0, int(round(p / 100.0 * len(sorted_values) + 0.5)) - 1))
+    return sorted_values[k]
+
+
+async def scrape_memory(args) -> dict:
+    """Reads the memory samples from /metrics; empty if the target has none."""
+    try:
+        reader, writer = await asyncio.wait_for(asyncio.open_connection(args.host, args.port), args.timeout)
+        writer.write(build_request({"method": "GET", "path": "/metrics"}, args.host, False, ""))
+        await writer.drain()
+        status_line = await reader.readline()
+        raw = await asyncio.wait_for(reader.read(), args.timeout)
+        writer.close()
+    except (OSError, asyncio.TimeoutError):
+        return {}
+    if b" 200 " not in status_line:
+        return {}
+    head, _, body = raw.partition(b"\r\n\r\n")
+    if b"chunked" in head.lower():
+        text, rest = b"", body
+        while rest:
+            size_line, _, rest = rest.partition(b"\r\n")
+            size = int(size_line.split(b";")[0] or b"0", 16)
+            if size == 0:
+                break
+            text, rest = text + rest[:size], rest[size + 2:]
+        body = text
+    samples = {}
+    for line in body.decode("utf-8", "replace").splitlines():
+        name, _, value = line.partition(" ")
+        if name in MEMORY_METRICS:
+            samples[name] = float(value)
+    return samples
+
+
+async def run_scenario(args, name: str, scenario: dict) -> dict:
+    requests = scenario["requests"]
+    weights = [r.get("weight", 1) for r in requests]
+    result = Result()
+    etags = {}
+    started = time.monotonic()
+    deadline = started + args.duration
+    await asyncio.gather(*(worker(args, requests, weights, deadline, result, etags)
+                           for _ in range(args.concurrency)))
+    elapsed = time.monotonic() - started
+    memory = await scrape_memory(args)
+
+    lat = sorted(result.latencies)
+    done = len(lat)
+    return {
+        "scenario": name,
+        "requests": done,
+        "seconds": round(elapsed, 2),
+        "rps": round(done / elapsed, 1) if elapsed else 0.0,
+        "kib_per_s": round(result.bytes / 1024.0 / elapsed, 1) if elapsed else 0.0,
+        "p50_ms": round(percentile(lat, 50) * 1e3, 2),
+        "p90_ms": round(percentile(lat, 90) * 1e3, 2),
+        "p99_ms": round(percentile(lat, 99) * 1e3, 2),
+        "max_ms": round(lat[-1] * 1e3, 2) if lat else 0.0,
+        "statuses": {str(k): v for k, v in sorted(result.statuses.items())},
+        "errors": dict(result.errors),
+        "memory": memory,
+    }
+
+
+def print_report(results, args):
+    print(f"\n🎯 {args.host}:{args.port}  concurrency={args.concurrency}  duration={args.duration}s  "
+          f"keep-alive={'on' if args.keepalive else 'off'}")
+    print(f"{'scenario':<12} {'reqs':>7} {'req/s':>8} {'KiB/s':>8} {'p50 ms':>8} {'p90 ms':>8} "
+          f"{'p99 ms':>8} {'max ms':>8}  status / errors")
+    for r in results:
+        codes = " ".join(f"{k}:{v}" for k, v in r["statuses"].items())
+        errs = " ".join(f"{k}:{v}" for k, v in r["errors"].items())
+        print(f"{r['scenario']:<12} {r['requests']:>7} {r['rps']:>8} {r['kib_per_s']:>8} {r['p50_ms']:>8} "
+              f"{r['p90_ms']:>8} {r['p99_ms']:>8} {r['max_ms']:>8}  {codes} {errs}".rstrip())
+
+    # high-water marks only grow, so the last scrape carries the run's peaks
+    memory = results[-1]["memory"] if results else {}
+    if memory:
+        print("\n📈 Memory high water (from /metrics after the run)")
+        for name, label in MEMORY_METRICS.items():
+            if name in memory:
+                value = memory[name]
+                shown = f"{value / 1024:.1f} KiB" if name.endswith("_bytes") else f"{value:.0f}"
+                print(f"  {label:<22} {shown}")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", required=True, help="device address or 127.0.0.1 for the host stand-in")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--scenarios", default="all", help="comma-separated names from the scenario file, or 'all'")
+    parser.add_argument("--scenario-file", type=pathlib.Path, default=SCENARIO_FILE)
+    parser.add_argument("--concurrency", type=int, default=4, help="parallel connections")
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds per scenario")
+    parser.add_argument("--timeout", type=float, default=5.0, help="per-request timeout in seconds")
+    parser.add_argument("--no-keepalive", dest="keepalive", action="store_false", help="one request per connection")
+    parser.add_argument("--json", action="store_true", help="print results as JSON instead of a table")
+    args = parser.parse_args()
+
+    scenarios = json.loads(args.scenario_file.read_text())
+    names = list(scenarios) if args.scenarios == "all" else [s.strip() for s in args.scenarios.split(",") if s.strip()]
+    unknown = [n for n in names if n not in scenarios]
+    if unknown:
+        print(f"❌ Unknown scenario(s): {', '.join(unknown)}; have: {', '.join(scenarios)}", file=sys.stderr)
+        return 1
+
+    results = []
+    for name in names:
+        if not args.json:
+            print(f"▶ {name}: {scenarios[name].get('description', '')}", flush=True)
+        results.append(asyncio.run(run_scenario(args, name, scenarios[name])))
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+    else:
+        print_report(results, args)
+    failed = sum(sum(r["errors"].values()) for r in results)
+    return 1 if failed and not any(r["requests"] for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
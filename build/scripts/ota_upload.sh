@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# ota_upload.sh — Update a running device over Wi-Fi from a build's manifest.json.
+# The image is streamed (chunked POST) to http://<host>/ota together with the
+# sha256, offset and chip from the manifest; the device writes it to its inactive
+# OTA partition, verifies it and restarts. Progress shows on the device console.
+#
+# Required:
+#   -H, --host        Device address (IP or <hostname>.local)
+#   -m, --manifest    Path to manifest.json (…/builds/<build>/binary/manifest.json)
+#   -t, --token       OTA token set on the device with `$web_interface ota_token`
+#                     (or XEWE_OTA_TOKEN in the environment)
+#
+# Optional:
+#   -c, --chip        chipFamily to pick from the manifest (default: first build)
+
+DEVICE_HOST=""
+MANIFEST=""
+CHIP_FAMILY=""
+OTA_TOKEN="${XEWE_OTA_TOKEN:-}"
+
+usage() {
+  cat <<'EOF'
+Usage: ota_upload.sh -H <host> -m <manifest.json> -t <token> [-c <ESP32-C3|ESP32-C6|ESP32-S3>]
+EOF
+  exit 1
+}
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -H|--host)      DEVICE_HOST="${2:-}"; shift 2 ;;
+    -m|--manifest)  MANIFEST="${2:-}"; shift 2 ;;
+    -c|--chip)      CHIP_FAMILY="${2:-}"; shift 2 ;;
+    -t|--token)     OTA_TOKEN="${2:-}"; shift 2 ;;
+    -h|--help)      usage ;;
+    *) echo "Unknown arg: $1"; usage ;;
+  esac
+done
+
+[[ -z "${DEVICE_HOST}" ]] && usage
+[[ -z "${MANIFEST}"    ]] && usage
+[[ -z "${OTA_TOKEN}"   ]] && usage
+[[ -f "${MANIFEST}"    ]] || { echo "❌ Manifest not found: ${MANIFEST}"; exit 1; }
+command -v curl    >/dev/null 2>&1 || { echo "❌ curl not found"; exit 1; }
+command -v python3 >/dev/null 2>&1 || { echo "❌ python3 not found"; exit 1; }
+
+# ---------- Pick the image from the manifest ----------
+# prints: <path> <offset> <sha256> <chipFamily>
+read -r PART_PATH PART_OFFSET PART_SHA256 PART_CHIP < <(python3 - "${MANIFEST}" "${CHIP_FAMILY}" <<'PYEOF'
+import json, sys
+manifest, chip = json.load(open(sys.argv[1])), sys.argv[2]
+builds = [b for b in manifest.get("builds", []) if not chip or b.get("chipFamily") == chip]
+if not builds or not builds[0].get("parts"):
+    sys.exit("no matching build in manifest")
+build = builds[0]
+part = build["parts"][0]
+print(part["path"], part.get("offset", 0), part.get("sha256", "-"), build.get("chipFamily", "-"))
+PYEOF
+)
+
+IMAGE="$(cd "$(dirname "${MANIFEST}")" && pwd)/${PART_PATH}"
+[[ -f "${IMAGE}" ]] || { echo "❌ Image not found: ${IMAGE}"; exit 1; }
+if [[ "${PART_SHA256}" == "-" ]]; then
+  echo "❌ Manifest has no sha256 (built before OTA support); rebuild, or flash over USB with upload.sh"
+  exit 1
+fi
+
+echo "📄 Image       : ${IMAGE}"
+echo "🔧 Chip        : ${PART_CHIP}"
+echo "📍 Offset      : ${PART_OFFSET}"
+echo "🔑 SHA-256     : ${PART_SHA256}"
+echo "📡 Device      : ${DEVICE_HOST}"
+
+# ---------- Stream ----------
+URL="http://${DEVICE_HOST}/ota?sha256=${PART_SHA256}&offset=${PART_OFFSET}&chip=${PART_CHIP}"
+HTTP_CODE="$(curl --silent --show-error --output /dev/stderr --write-out '%{http_code}' \
+  --request POST --header 'Transfer-Encoding: chunked' --header 'Content-Type: application/octet-stream' \
+  --header "X-OTA-Token: ${OTA_TOKEN}" \
+  --upload-file "${IMAGE}" "${URL}")"
+
+if [[ "${HTTP_CODE}" == "200" ]]; then
+  echo "✅ Update accepted; the device is restarting into the new firmware."
+else
+  echo "❌ Update failed (HTTP ${HTTP_CODE})"
+  exit 1
+fi
@@ -110,6 +110,9 @@ cat > "${BUILD_INFO_H}" <<EOF
 #define BUILD_VERSION   ${INPUT_VER}
 #define BUILD_TIMESTAMP ${TS_ISO}
 EOF
+"${DEFAULT_VENV}/bin/python" "${SCRIPT_DIR}/embed_assets.py" \
+  --assets "${PROJECT_ROOT}/src/Modules/Software/WebInterface/assets" \
+  --out "${PROJECT_ROOT}/src/Modules/Software/WebInterface/web_assets.h" || { echo "❌ Asset embedding failed"; exit 1; }
 
 chip_to_family() { case "$1" in c3) echo "ESP32-C3";; c6) echo "ESP32-C6";; s3) echo "ESP32-S3";; esac; }
 
@@ -19,6 +19,8 @@
 #define DEBUG_CommandParser     0
 #define DEBUG_Wifi              0
 #define DEBUG_WebInterface      0
+#define DEBUG_RemoteConsole     0
+#define DEBUG_Buttons           0
 
 
 #define DBG_ENABLED(cls)      (DEBUG_##cls)
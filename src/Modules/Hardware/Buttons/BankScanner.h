@@ -0,0 +1,113 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Hardware/Buttons/BankScanner.h
+#pragma once
+
+// Debouncing for many inputs at once. The inputs of a 32-bit word (a GPIO bank's
+// input register, a keypad row) are debounced together with a vertical counter: bit
+// i of cnt0/cnt1 is a 2-bit counter for input i, so one sample of all 32 inputs is
+// a handful of bitwise operations, whatever the number of inputs in use.
+//
+// Nothing here touches hardware: the caller hands in each sampled word, so the same
+// code runs on the host against a simulated register.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace xewe::input {
+
+// An input's debounced state flips after it reads the other level on COUNT
+// consecutive samples; any sample at the current level restarts its count.
+class VerticalDebouncer {
+public:
+    static constexpr uint8_t    COUNT                       = 4;
+
+    // Feeds one sample; returns the inputs whose debounced state flipped on it.
+    uint32_t sample(uint32_t raw) {
+        const uint32_t delta = raw ^ state_bits;
+        cnt1 = (cnt1 ^ cnt0) & delta;
+        cnt0 = ~cnt0 & delta;
+        const uint32_t toggled = delta & ~(cnt0 | cnt1);    // counter wrapped: COUNT in a row
+        state_bits ^= toggled;
+        return toggled;
+    }
+
+    // Sets inputs' debounced state without reporting a change, e.g. when they start
+    // being tracked, and drops whatever count they had.
+    void preset(uint32_t mask, uint32_t levels) {
+        state_bits = (state_bits & ~mask) | (levels & mask);
+        cnt0 &= ~mask;
+        cnt1 &= ~mask;
+    }
+
+    uint32_t state() const { return state_bits; }
+
+private:
+    uint32_t                    state_bits                  {0};
+    uint32_t                    cnt0                        {0};
+    uint32_t                    cnt1                        {0};
+};
+
+
+// Tracks a set of pins spread over BANKS 32-bit input words (pin / 32 picks the
+// bank). scan() reads each bank that has a tracked pin once and reports the pins
+// whose debounced level changed.
+template <size_t BANKS>
+class BankScanner {
+public:
+    static constexpr size_t     PINS                        = BANKS * 32;
+
+    void track(uint8_t pin, bool level) {
+        if (pin >= PINS) return;
+        const uint32_t bit = 1UL << (pin % 32);
+        masks[pin / 32] |= bit;
+        debouncers[pin / 32].preset(bit, level ? bit : 0);
+    }
+
+    // also resets the pin's debounced state, so a pin left high (an idle pull-up) is
+    // not seen falling once the mask zeroes its raw bit
+    void untrack(uint8_t pin) {
+        if (pin >= PINS) return;
+        const uint32_t bit = 1UL << (pin % 32);
+        masks[pin / 32] &= ~bit;
+        debouncers[pin / 32].preset(bit, 0);
+    }
+
+    void clear() {
+        masks.fill(0);
+        for (auto& debouncer : debouncers) debouncer.preset(~0U, 0);
+    }
+
+    bool tracking() const {
+        for (const uint32_t mask : masks) if (mask) return true;
+        return false;
+    }
+
+    // read_bank(bank) -> uint32_t raw input word; changed(pin, level) per debounced change.
+    template <typename ReadBank, typename Changed>
+    void scan(ReadBank&& read_bank, Changed&& changed) {
+        for (size_t bank = 0; bank < BANKS; bank++) {
+            if (!masks[bank]) continue;
+            uint32_t toggled = debouncers[bank].sample(read_bank(bank) & masks[bank]) & masks[bank];
+            while (toggled) {
+                const uint8_t bit = static_cast<uint8_t>(__builtin_ctz(toggled));
+                toggled &= toggled - 1;
+                changed(static_cast<uint8_t>(bank * 32 + bit), (debouncers[bank].state() >> bit) & 1U);
+            }
+        }
+    }
+
+private:
+    std::array<uint32_t, BANKS>             masks           {};
+    std::array<VerticalDebouncer, BANKS>    debouncers      {};
+};
+
+} // namespace xewe::input
@@ -13,6 +13,10 @@
 #include "Buttons.h"
 #include "../../../SystemController/SystemController.h"
 
+#include "driver/gpio.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc_caps.h"
+
 
 Buttons::Buttons(SystemController& controller)
       : Module(controller,
@@ -25,61 +29,569 @@ Buttons::Buttons(SystemController& controller)
 {
     commands_storage.push_back({
         "add",
-        "Add a button mapping: <pin> \"<$cmd ...>\" [pullup|pulldown] [on_press|on_release|on_change] [debounce_ms]",
+        "Add a button mapping: <pin|r<row>c<col>> \"<$cmd ...>\" [pullup|pulldown] <trigger> [debounce_ms]; triggers: "
+        "on_press, on_release, on_change, click[=window_ms], double_click[=window_ms], triple_click[=window_ms], "
+        "long_press[=ms], repeat[=delay_ms/interval_ms], chord=<pin>[+<pin>...]",
         std::string("$") + lower(module_name) + " add 9 \"$system reboot\" pullup on_press 50",
         5,
         [this](std::string_view args){ button_add_cli(args); }
     });
     commands_storage.push_back({
         "remove",
-        "Remove a button mapping by pin",
+        "Remove every mapping on a pin",
         std::string("$") + lower(module_name) + " remove 9",
         1,
         [this](std::string_view args){ button_remove_cli(args); }
     });
+    commands_storage.push_back({
+        "scan",
+        "Sample buttons by GPIO bank every <ms> (1-50, 4-sample debounce) instead of edge interrupts; 0 goes back to interrupts",
+        std::string("$") + lower(module_name) + " scan 5",
+        1,
+        [this](std::string_view args){ button_scan_cli(args); }
+    });
+    commands_storage.push_back({
+        "matrix",
+        "Set up a keypad matrix: <row pins> <column pins>, comma separated, up to 8 each; bind keys as r<row>c<col>",
+        std::string("$") + lower(module_name) + " matrix 12,13,14,15 16,17,18,19",
+        2,
+        [this](std::string_view args){ button_matrix_cli(args); }
+    });
+    commands_storage.push_back({
+        "matrix_clear",
+        "Remove the keypad matrix and release its pins; key mappings stay but stop firing",
+        std::string("$") + lower(module_name) + " matrix_clear",
+        0,
+        [this](std::string_view args){ button_matrix_clear_cli(args); }
+    });
 }
 
 void Buttons::begin_routines_regular (const ModuleConfig& cfg) {
+    scan_ms = controller.nvs.read_uint8(nvs_key, "scan_ms", 0);
+    if (scan_ms > MAX_SCAN_MS) scan_ms = 0;
+    if (is_enabled() && matrix_rows.empty()) {
+        const std::string rows = controller.nvs.read_str(nvs_key, "mx_rows");
+        const std::string cols = controller.nvs.read_str(nvs_key, "mx_cols");
+        if (!rows.empty() && !cols.empty() && !set_matrix(rows, cols)) {
+            DBG_PRINTF(Buttons, "begin_routines_regular(): stored matrix refused: %s\n", add_error);
+        }
+    }
     if (is_enabled() && !loaded_from_nvs) {
         load_from_nvs();
     }
 }
 
+EdgeRing<Buttons::EDGE_RING_SIZE> Buttons::edges;
+
+// Runs in interrupt context: queue the pin and the time, nothing else. The level is
+// not needed here; settle() reads it once the line has gone quiet.
+void IRAM_ATTR Buttons::on_edge(void* arg) {
+    const uint8_t pin = static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg));
+    edges.push({pin, static_cast<uint32_t>(micros())});
+}
+
 void Buttons::loop () {
+    if (resolved_generation != controller.command_parser.table_generation()) resolve_all();
+    if (!scan_ms && edges.dropped() != dropped_seen) resync();
+
+    const uint32_t now_ms = millis();
+    const bool bank_due   = scan_ms && now_ms - last_scan_ms >= scan_ms;
+    const bool matrix_due = !matrix_rows.empty() && now_ms - last_matrix_ms >= MATRIX_SCAN_MS;
+    const bool edges_due  = !scan_ms && (!edges.empty() || settling_count);
+    if (!bank_due && !matrix_due && !edges_due && timing_count == 0) return;
+
+    if (edges_due) drain_edges();
+    // taken after draining, so no edge seen above is newer than now
+    const uint32_t now = micros();
+    bool changed = false;
+    if (edges_due) changed |= settle(now);
+    if (bank_due) {
+        last_scan_ms = now_ms;
+        changed |= scan_banks(now);
+    }
+    if (matrix_due) {
+        last_matrix_ms = now_ms;
+        changed |= scan_matrix(now);
+    }
+    if (changed || timing_count) timing_count = tick(now);
+
+    // commands run once the pass is over: one may add or remove buttons
+    if (!pending_commands.empty()) {
+        std::vector<CompiledCommand> commands;
+        commands.swap(pending_commands);
+        for (auto& command : commands) controller.command_parser.run(command);
+    }
+}
+
+void Buttons::drain_edges() {
+    EdgeRing<EDGE_RING_SIZE>::Edge edge;
+    while (edges.pop(edge)) {
+        edges_seen++;
+        for (auto& button : buttons) {
+            if (button.pin != edge.pin) continue;
+            if (!button.settling) {
+                button.settling = true;
+                button.first_edge_us = edge.us;
+                settling_count++;
+            }
+            button.last_edge_us = edge.us;
+            break;
+        }
+    }
+}
+
+bool Buttons::settle(uint32_t now_us) {
+    bool changed = false;
     for (auto& button : buttons) {
-        int current_state = digitalRead(button.pin);
+        if (!button.settling) continue;
+        if (now_us - button.last_edge_us < button.debounce_interval * 1000UL) continue;
+
+        button.settling = false;
+        settling_count--;
+        // quiet for a whole interval: the pin now reads its settled level
+        const int level = digitalRead(button.pin);
+        if (level != button.last_steady_state) {
+            commit(button, level, button.first_edge_us);
+            changed = true;
+        }
+    }
+    return changed;
+}
 
-        if (current_state != button.last_flicker_state) {
-            button.last_debounce_time = millis();
+// One input register read per bank, however many buttons sit on it. A change is
+// reported COUNT samples after the pin first read the new level, so it is stamped
+// that far back.
+bool Buttons::scan_banks(uint32_t now_us) {
+    scans++;
+    bool changed = false;
+    const uint32_t settle_us = (xewe::input::VerticalDebouncer::COUNT - 1) * scan_ms * 1000UL;
+    scanner.scan(read_bank, [&](uint8_t pin, bool level) {
+        for (auto& button : buttons) {
+            if (button.pin != pin) continue;
+            if (static_cast<int>(level) != button.last_steady_state) {
+                commit(button, level, now_us - settle_us);
+                changed = true;
+            }
+            break;
         }
-        button.last_flicker_state = current_state;
+    });
+    return changed;
+}
 
-        if ((millis() - button.last_debounce_time) > button.debounce_interval) {
-            if (current_state != button.last_steady_state) {
-                button.last_steady_state = current_state;
+// Each row is pulled low in turn (rows are open drain, so a released row floats and
+// two pressed keys on one column never short two driven rows) and all columns are
+// read at once from the input registers. Keys read low while pressed.
+bool Buttons::scan_matrix(uint32_t now_us) {
+    matrix_scans++;
+    std::array<uint32_t, MATRIX_MAX * MATRIX_MAX / 32> raw;
+    raw.fill(~0U);
+    std::array<uint8_t, MATRIX_MAX> down {};    // per row, the columns reading low
+    for (size_t r = 0; r < matrix_rows.size(); r++) {
+        digitalWrite(matrix_rows[r], LOW);
+        delayMicroseconds(MATRIX_SETTLE_US);
+        const uint32_t bank0 = read_bank(0);
+        const uint32_t bank1 = matrix_high_bank ? read_bank(1) : 0;
+        digitalWrite(matrix_rows[r], HIGH);
+
+        for (size_t c = 0; c < matrix_cols.size(); c++) {
+            const uint8_t pin = matrix_cols[c];
+            const uint32_t level = (pin < 32 ? bank0 >> pin : bank1 >> (pin - 32)) & 1U;
+            if (level) continue;
+            const size_t bit = r * MATRIX_MAX + c;
+            down[r] |= static_cast<uint8_t>(1U << c);
+            raw[bit / 32] &= ~(1UL << (bit % 32));
+        }
+    }
 
-                bool is_pressed = (button.type == InputMode::BUTTON_PULLUP) ? (current_state == LOW) : (current_state == HIGH);
+    // Without diodes, three keys on the corners of a rectangle make the fourth read as
+    // pressed too: two rows sharing two or more columns can't be told apart from that,
+    // so the whole sample is dropped and every key keeps its debounced state.
+    for (size_t r1 = 0; r1 < matrix_rows.size(); r1++) {
+        if (!down[r1]) continue;
+        for (size_t r2 = r1 + 1; r2 < matrix_rows.size(); r2++) {
+            if (__builtin_popcount(down[r1] & down[r2]) >= 2) {
+                ghost_scans++;
+                return false;
+            }
+        }
+    }
 
-                bool should_trigger = false;
-                if (button.event == TriggerEvent::BUTTON_ON_CHANGE) {
-                    should_trigger = true;
-                } else if (button.event == TriggerEvent::BUTTON_ON_PRESS && is_pressed) {
-                    should_trigger = true;
-                } else if (button.event == TriggerEvent::BUTTON_ON_RELEASE && !is_pressed) {
-                    should_trigger = true;
-                }
+    bool changed = false;
+    const uint32_t settle_us = (xewe::input::VerticalDebouncer::COUNT - 1) * MATRIX_SCAN_MS * 1000UL;
+    key_scanner.scan([&raw](size_t bank) { return raw[bank]; }, [&](uint8_t bit, bool level) {
+        const uint8_t id = static_cast<uint8_t>(KEY_BASE + bit);
+        for (auto& button : buttons) {
+            if (button.pin != id) continue;
+            if (static_cast<int>(level) != button.last_steady_state) {
+                commit(button, level, now_us - settle_us);
+                changed = true;
+            }
+            break;
+        }
+    });
+    return changed;
+}
+
+bool Buttons::set_matrix(const std::string& rows_str, const std::string& cols_str) {
+    add_error = nullptr;
+    std::vector<uint8_t> rows;
+    std::vector<uint8_t> cols;
+    // rows are driven low while scanning, so they need output-capable GPIOs
+    auto parse_pins = [](const std::string& list, std::vector<uint8_t>& out, bool output) {
+        for (const auto& item : split_by_token(list, ",")) {
+            uint8_t pin = 0;
+            if (!parse_int(item, pin) || !GPIO_IS_VALID_GPIO(pin)) return false;
+            if (output && !GPIO_IS_VALID_OUTPUT_GPIO(pin)) return false;
+            if (std::find(out.begin(), out.end(), pin) != out.end()) return false;
+            out.push_back(pin);
+        }
+        return !out.empty() && out.size() <= MATRIX_MAX;
+    };
+    if (!parse_pins(rows_str, rows, true) || !parse_pins(cols_str, cols, false)) {
+        add_error = "Rows and columns each take 1-8 distinct GPIOs of this chip, comma separated; rows must be output-capable.";
+        return false;
+    }
+    for (uint8_t pin : rows) {
+        if (std::find(cols.begin(), cols.end(), pin) != cols.end()) {
+            add_error = "A pin can't be both a row and a column.";
+            return false;
+        }
+    }
+    for (const auto& button : buttons) {
+        if (is_key(button.pin)) continue;
+        if (std::find(rows.begin(), rows.end(), button.pin) != rows.end()
+            || std::find(cols.begin(), cols.end(), button.pin) != cols.end()) {
+            add_error = "A matrix pin is already mapped as a button.";
+            return false;
+        }
+    }
+
+    clear_matrix();
+    matrix_rows = std::move(rows);
+    matrix_cols = std::move(cols);
+    matrix_high_bank = false;
+    for (uint8_t pin : matrix_rows) {
+        pinMode(pin, OUTPUT_OPEN_DRAIN);
+        digitalWrite(pin, HIGH);
+    }
+    for (uint8_t pin : matrix_cols) {
+        pinMode(pin, INPUT_PULLUP);
+        if (pin >= 32) matrix_high_bank = true;
+    }
+    return true;
+}
+
+// Releases the matrix pins. Keys held at that moment are let go quietly: no release
+// gestures, since nothing was actually released.
+void Buttons::clear_matrix() {
+    for (uint8_t pin : matrix_rows) pinMode(pin, INPUT);
+    matrix_rows.clear();
+    matrix_cols.clear();
+    for (auto& button : buttons) {
+        if (!is_key(button.pin) || !button.pressed) continue;
+        button.pressed = false;
+        button.clicks = 0;
+        button.last_steady_state = HIGH;
+        held_mask.reset(button.pin);
+        key_scanner.track(button.pin - KEY_BASE, true);
+    }
+}
+
+bool Buttons::in_matrix(uint8_t id) const {
+    const uint8_t key = id - KEY_BASE;
+    return key / MATRIX_MAX < matrix_rows.size() && key % MATRIX_MAX < matrix_cols.size();
+}
+
+bool Buttons::matrix_uses(uint8_t pin) const {
+    return std::find(matrix_rows.begin(), matrix_rows.end(), pin) != matrix_rows.end()
+        || std::find(matrix_cols.begin(), matrix_cols.end(), pin) != matrix_cols.end();
+}
+
+uint32_t Buttons::read_bank(size_t bank) {
+#if SOC_GPIO_PIN_COUNT > 32
+    return REG_READ(bank == 0 ? GPIO_IN_REG : GPIO_IN1_REG);
+#else
+    return bank == 0 ? REG_READ(GPIO_IN_REG) : 0;
+#endif
+}
+
+void Buttons::commit(Button& button, int level, uint32_t at_us) {
+    button.last_steady_state = level;
+    button.last_change_us = at_us;
+
+    bool is_pressed = (button.type == InputMode::BUTTON_PULLUP) ? (level == LOW) : (level == HIGH);
+
+    for (auto& listener : button_listeners) {
+        if (listener) listener(button.pin, is_pressed, at_us);
+    }
+
+    if (is_pressed) press(button, at_us);
+    else            release(button, at_us);
+}
+
+/* --- Gestures --- */
+
+void Buttons::press(Button& button, uint32_t at_us) {
+    button.pressed = true;
+    button.pressed_us = at_us;
+    button.consumed = false;
+    held_mask.set(button.pin);
+
+    for (auto& binding : button.bindings) {
+        if (binding.event == BUTTON_ON_PRESS || binding.event == BUTTON_ON_CHANGE) fire(binding);
+        if (binding.event == BUTTON_LONG_PRESS) binding.fired = false;
+    }
+
+    // a chord fires on the press that completes it, once per hold, and takes the hold
+    // from every member so none of them also counts a click or a long press
+    for (auto& owner : buttons) {
+        for (auto& binding : owner.bindings) {
+            if (binding.event != BUTTON_CHORD || binding.fired || !binding.chord_mask.test(button.pin)) continue;
+            if ((held_mask & binding.chord_mask) != binding.chord_mask) continue;
+            binding.fired = true;
+            fire(binding);
+            for (auto& member : buttons) {
+                if (!binding.chord_mask.test(member.pin)) continue;
+                member.consumed = true;
+                member.clicks = 0;
+            }
+        }
+    }
+    if (button.consumed) return;
+
+    for (auto& binding : button.bindings) {
+        if (binding.event != BUTTON_REPEAT) continue;
+        fire(binding);
+        button.next_repeat_us = at_us + binding.hold_ms * 1000UL;
+    }
+}
+
+void Buttons::release(Button& button, uint32_t at_us) {
+    button.pressed = false;
+    button.released_us = at_us;
+    held_mask.reset(button.pin);
 
-                if (should_trigger) {
-                    controller.command_parser.parse(button.command);
+    for (auto& binding : button.bindings) {
+        if (binding.event == BUTTON_ON_RELEASE || binding.event == BUTTON_ON_CHANGE) fire(binding);
+    }
+    // a chord re-arms as soon as any member lets go
+    for (auto& owner : buttons) {
+        for (auto& binding : owner.bindings) {
+            if (binding.event == BUTTON_CHORD && binding.chord_mask.test(button.pin)) binding.fired = false;
+        }
+    }
+
+    if (button.consumed || button.max_clicks == 0) return;
+    button.clicks++;
+    // nothing waits for more clicks than this: no reason to hold the window open
+    if (button.clicks >= button.max_clicks) resolve_clicks(button);
+}
+
+// Advances long press, repeat and click window timers. Returns how many buttons still
+// have one running; while that is zero and no edge arrives, loop() does nothing.
+uint8_t Buttons::tick(uint32_t now_us) {
+    uint8_t running = 0;
+    for (auto& button : buttons) {
+        bool waiting = false;
+        if (button.pressed) {
+            if (button.consumed) continue;
+            for (auto& binding : button.bindings) {
+                if (binding.event == BUTTON_LONG_PRESS && !binding.fired) {
+                    if (now_us - button.pressed_us < binding.hold_ms * 1000UL) { waiting = true; continue; }
+                    binding.fired = true;
+                    button.consumed = true;
+                    button.clicks = 0;
+                    fire(binding);
+                } else if (binding.event == BUTTON_REPEAT && !button.consumed) {
+                    waiting = true;
+                    if (static_cast<int32_t>(now_us - button.next_repeat_us) < 0) continue;
+                    fire(binding);
+                    button.next_repeat_us += binding.interval_ms * 1000UL;
+                    // after a stall, repeat from now rather than firing the backlog
+                    if (static_cast<int32_t>(now_us - button.next_repeat_us) >= 0) {
+                        button.next_repeat_us = now_us + binding.interval_ms * 1000UL;
+                    }
                 }
             }
+            if (button.consumed) waiting = false;
+        } else if (button.clicks) {
+            if (now_us - button.released_us >= button.click_window_us) resolve_clicks(button);
+            else waiting = true;
+        }
+        if (waiting) running++;
+    }
+    return running;
+}
+
+void Buttons::resolve_clicks(Button& button) {
+    const TriggerEvent wanted = button.clicks == 1 ? BUTTON_CLICK
+                              : button.clicks == 2 ? BUTTON_DOUBLE_CLICK
+                              :                      BUTTON_TRIPLE_CLICK;
+    button.clicks = 0;
+    for (const auto& binding : button.bindings) {
+        if (binding.event == wanted) fire(binding);
+    }
+}
+
+void Buttons::fire(const Binding& binding) {
+    gestures_fired++;
+    pending_commands.push_back(binding.action);
+}
+
+// Runs once the command table exists (bindings loaded at boot come before it) and
+// after every rebuild. A binding that doesn't resolve is kept, so a command from a
+// module that comes back later still works, but it is reported now, not on a press.
+void Buttons::resolve_all() {
+    resolved_generation = controller.command_parser.table_generation();
+    for (auto& button : buttons) {
+        for (auto& binding : button.bindings) {
+            const ParseStatus status = controller.command_parser.compile(string(binding.action.source), binding.action, false);
+            if (status == ParseStatus::OK) continue;
+            controller.serial_port.printf("Warning: button on pin %u (%s): \"%s\" does not resolve: %s",
+                                          static_cast<unsigned>(button.pin), describe(binding).c_str(),
+                                          binding.action.source.c_str(), CommandParser::status_name(status));
         }
     }
 }
 
+// A binding added once the table exists is checked right away and refused if its
+// command doesn't resolve; the parser prints why. Earlier ones wait for resolve_all().
+bool Buttons::resolve(Binding& binding) {
+    if (controller.command_parser.table_generation() == 0) return true;
+    if (controller.command_parser.compile(string(binding.action.source), binding.action) == ParseStatus::OK) return true;
+    add_error = "The command does not resolve.";
+    return false;
+}
+
+void Buttons::refresh_gestures(Button& button) {
+    button.max_clicks = 0;
+    button.click_window_us = 0;
+    for (const auto& binding : button.bindings) {
+        uint8_t clicks = 0;
+        if      (binding.event == BUTTON_CLICK)         clicks = 1;
+        else if (binding.event == BUTTON_DOUBLE_CLICK)  clicks = 2;
+        else if (binding.event == BUTTON_TRIPLE_CLICK)  clicks = 3;
+        if (!clicks) continue;
+        button.max_clicks = std::max(button.max_clicks, clicks);
+        button.click_window_us = std::max<uint32_t>(button.click_window_us, binding.hold_ms * 1000UL);
+    }
+}
+
+bool Buttons::same_trigger(const Binding& a, const Binding& b) {
+    if (a.event != b.event) return false;
+    return a.event != BUTTON_CHORD || a.chord_mask == b.chord_mask;
+}
+
+std::string Buttons::describe(const Binding& binding) {
+    switch (binding.event) {
+        case BUTTON_ON_PRESS:       return "on_press";
+        case BUTTON_ON_RELEASE:     return "on_release";
+        case BUTTON_ON_CHANGE:      return "on_change";
+        case BUTTON_CLICK:          return "click=" + std::to_string(binding.hold_ms);
+        case BUTTON_DOUBLE_CLICK:   return "double_click=" + std::to_string(binding.hold_ms);
+        case BUTTON_TRIPLE_CLICK:   return "triple_click=" + std::to_string(binding.hold_ms);
+        case BUTTON_LONG_PRESS:     return "long_press=" + std::to_string(binding.hold_ms);
+        case BUTTON_REPEAT:         return "repeat=" + std::to_string(binding.hold_ms) + "/" + std::to_string(binding.interval_ms);
+        case BUTTON_CHORD: {
+            std::string s = "chord=";
+            for (size_t id = 0; id < MAX_IDS; id++) {
+                if (!binding.chord_mask.test(id)) continue;
+                if (s.back() != '=') s += "+";
+                s += id_name(static_cast<uint8_t>(id));
+            }
+            return s;
+        }
+    }
+    return "";
+}
+
+std::string Buttons::id_name(uint8_t id) {
+    if (!is_key(id)) return std::to_string(id);
+    const uint8_t key = id - KEY_BASE;
+    return "r" + std::to_string(key / MATRIX_MAX) + "c" + std::to_string(key % MATRIX_MAX);
+}
+
+// A GPIO number, or r<row>c<col> for a keypad key (both from 0).
+bool Buttons::parse_id(const std::string& token, uint8_t& id) {
+    const std::string t = to_lower(token);
+    if (!t.empty() && t[0] == 'r') {
+        const auto c = t.find('c');
+        uint8_t row = 0;
+        uint8_t col = 0;
+        if (c == std::string::npos || !parse_int(t.substr(1, c - 1), row) || !parse_int(t.substr(c + 1), col)) return false;
+        if (row >= MATRIX_MAX || col >= MATRIX_MAX) return false;
+        id = static_cast<uint8_t>(KEY_BASE + row * MATRIX_MAX + col);
+        return true;
+    }
+    uint8_t pin = 0;
+    if (!parse_int(t, pin) || !GPIO_IS_VALID_GPIO(pin)) return false;
+    id = pin;
+    return true;
+}
+
+// Some edges are gone (the ring overflowed, or interrupts were off while scanning):
+// restart debouncing on every pin from its current level rather than trusting a
+// partial edge history.
+void Buttons::resync() {
+    dropped_seen = edges.dropped();
+    DBG_PRINTF(Buttons, "resync(): re-reading all pins, %lu edges dropped so far\n", (unsigned long)dropped_seen);
+    const uint32_t now = micros();
+    settling_count = 0;
+    for (auto& button : buttons) {
+        if (is_key(button.pin)) continue;
+        button.settling = true;
+        button.first_edge_us = now;
+        button.last_edge_us = now;
+        settling_count++;
+    }
+}
+
+void Buttons::attach(const Button& button) {
+    if (is_key(button.pin)) {
+        key_scanner.track(button.pin - KEY_BASE, button.last_steady_state == HIGH);
+        return;
+    }
+    if (scan_ms) {
+        scanner.track(button.pin, button.last_steady_state == HIGH);
+        return;
+    }
+    attachInterruptArg(digitalPinToInterrupt(button.pin), &Buttons::on_edge,
+                       reinterpret_cast<void*>(static_cast<uintptr_t>(button.pin)), CHANGE);
+}
+
+void Buttons::detach(const Button& button) {
+    if (is_key(button.pin)) key_scanner.untrack(button.pin - KEY_BASE);
+    else if (scan_ms)       scanner.untrack(button.pin);
+    else         detachInterrupt(digitalPinToInterrupt(button.pin));
+}
+
+// Moves every button between edge interrupts and bank scanning. Levels carry over;
+// on interrupts each pin is re-read once, since edges from the scanning period are lost.
+void Buttons::set_scan_period(uint8_t ms) {
+    for (const auto& btn : buttons) detach(btn);
+    scan_ms = ms;
+    for (const auto& btn : buttons) attach(btn);
+    if (!scan_ms) resync();
+}
+
+void Buttons::on_button_event(button_listener_t listener) {
+    button_listeners.push_back(std::move(listener));
+}
+
 void Buttons::reset (const bool verbose, const bool do_restart, const bool keep_enabled) {
     nvs_clear_all();
+    for (const auto& btn : buttons) detach(btn);
     buttons.clear();
+    scanner.clear();
+    key_scanner.clear();
+    clear_matrix();
+    scan_ms = 0;
+    controller.nvs.write_uint8(nvs_key, "scan_ms", 0);
+    controller.nvs.remove(nvs_key, "mx_rows");
+    controller.nvs.remove(nvs_key, "mx_cols");
+    settling_count = 0;
+    timing_count = 0;
+    held_mask.reset();
     Module::reset(verbose, do_restart, keep_enabled);
 }
 
@@ -92,53 +604,159 @@ std::string Buttons::status (const bool verbose) const {
     } else {
         s = "--- Active Button Instances (Live) ---\n";
         for (const auto& btn : buttons) {
-            s += "  - Pin: " + std::to_string(btn.pin) + ", CMD: \"" + btn.command + "\"\n";
+            if (is_key(btn.pin)) {
+                s += "  - Key: " + id_name(btn.pin) + (in_matrix(btn.pin) ? "\n" : " (inactive, outside the keypad matrix)\n");
+            } else {
+                s += "  - Pin: " + std::to_string(btn.pin) + (btn.type == BUTTON_PULLUP ? " (pullup, " : " (pulldown, ")
+                   + std::to_string(btn.debounce_interval) + " ms)\n";
+            }
+            for (const auto& binding : btn.bindings) {
+                s += "      " + describe(binding) + ": \"" + binding.action.source + "\"\n";
+            }
+        }
+        if (scan_ms) {
+            s += "  Input: GPIO bank scan every " + std::to_string(scan_ms) + " ms, " + std::to_string(scans) + " scans\n";
+        } else {
+            s += "  Input: edge interrupts; edges: " + std::to_string(edges_seen) + " handled, " + std::to_string(edges.dropped()) + " dropped\n";
         }
+        if (!matrix_rows.empty()) {
+            s += "  Matrix: " + std::to_string(matrix_rows.size()) + "x" + std::to_string(matrix_cols.size()) + " every "
+               + std::to_string(MATRIX_SCAN_MS) + " ms, " + std::to_string(matrix_scans) + " scans, "
+               + std::to_string(ghost_scans) + " dropped for ghosting\n";
+        }
+        s += "  Gestures fired: " + std::to_string(gestures_fired) + "\n";
         s += "------------------------------------";
     }
     if (verbose) controller.serial_port.print(s);
     return s;
 }
 
+void Buttons::status_json(xewe::json::Writer& out) const {
+    out.begin_array("buttons");
+    for (const auto& btn : buttons) {
+        for (const auto& binding : btn.bindings) {
+            out.begin_object();
+            if (is_key(btn.pin)) out.field("key", id_name(btn.pin));
+            else                 out.field("pin", btn.pin);
+            out.field("trigger", describe(binding)).field("command", binding.action.source).end_object();
+        }
+    }
+    out.end_array();
+    out.field("scan_ms", scan_ms);
+    out.field("scans", scans);
+    out.field("edges", edges_seen);
+    out.field("edges_dropped", edges.dropped());
+    out.field("gestures_fired", gestures_fired);
+    out.begin_object("matrix");
+    out.begin_array("rows");
+    for (uint8_t pin : matrix_rows) out.value(pin);
+    out.end_array();
+    out.begin_array("cols");
+    for (uint8_t pin : matrix_cols) out.value(pin);
+    out.end_array();
+    out.field("scans", matrix_scans);
+    out.field("ghosted", ghost_scans);
+    out.end_object();
+}
+
 void Buttons::load_configs(const std::vector<std::string>& configs) {
     if (is_disabled()) return;
 
+    for (const auto& btn : buttons) detach(btn);
     buttons.clear();
+    settling_count = 0;
+    timing_count = 0;
+    held_mask.reset();
     for (const auto& cfg : configs) {
-        if (!cfg.empty()) add_button_from_config(cfg);
+        if (cfg.empty() || add_button_from_config(cfg, true)) continue;
+        controller.serial_port.printf("Warning: stored button mapping \"%s\" refused: %s", cfg.c_str(),
+                                      add_error ? add_error : "Invalid button configuration string.");
     }
     loaded_from_nvs = true;
 }
 
-bool Buttons::add_button_from_config(const std::string& config) {
+// Bindings on a pin already in use join that button; they must agree on its mode and
+// debounce and can't repeat a trigger it already has. Stored key mappings are restored
+// even without a matrix covering them, so they stay inactive until one is set up again.
+bool Buttons::add_button_from_config(const std::string& config, bool restoring) {
     if (is_disabled()) return false;
 
-    Button new_button;
-    if (parse_config_string(config, new_button)) {
+    add_error = nullptr;
+    Button new_button{};
+    Binding binding{};
+    if (!parse_config_string(config, new_button, binding)) {
+        add_error = "Invalid button configuration string.";
+        return false;
+    }
+
+    if (is_key(new_button.pin)) {
+        // keys read low while pressed and are debounced by the matrix scan
+        new_button.type = BUTTON_PULLUP;
+        new_button.debounce_interval = 0;
+        if (!restoring && !in_matrix(new_button.pin)) {
+            add_error = "The key is outside the keypad matrix.";
+            return false;
+        }
+    } else if (matrix_uses(new_button.pin)) {
+        add_error = "The pin is used by the keypad matrix.";
+        return false;
+    }
+
+    for (auto& button : buttons) {
+        if (button.pin != new_button.pin) continue;
+        if (button.type != new_button.type || button.debounce_interval != new_button.debounce_interval) {
+            add_error = "The pin is already mapped with a different mode or debounce.";
+            return false;
+        }
+        for (const auto& existing : button.bindings) {
+            if (same_trigger(existing, binding)) {
+                add_error = "The pin already has a mapping for this trigger.";
+                return false;
+            }
+        }
+        if (!resolve(binding)) return false;
+        button.bindings.push_back(std::move(binding));
+        refresh_gestures(button);
+        return true;
+    }
+    if (!resolve(binding)) return false;
+
+    if (is_key(new_button.pin)) {
+        new_button.last_steady_state = HIGH;
+    } else {
         if (new_button.type == InputMode::BUTTON_PULLUP) {
             pinMode(new_button.pin, INPUT_PULLUP);
         } else {
             pinMode(new_button.pin, INPUT_PULLDOWN);
         }
-
         new_button.last_steady_state = digitalRead(new_button.pin);
-        new_button.last_flicker_state = new_button.last_steady_state;
-        new_button.last_debounce_time = 0;
-
-        buttons.push_back(new_button);
-        return true;
     }
-    return false;
+    // held while being configured: track it as down, but that hold triggers nothing
+    new_button.pressed = (new_button.type == BUTTON_PULLUP) ? (new_button.last_steady_state == LOW)
+                                                            : (new_button.last_steady_state == HIGH);
+    new_button.consumed = new_button.pressed;
+    if (new_button.pressed) held_mask.set(new_button.pin);
+    new_button.bindings.push_back(std::move(binding));
+    refresh_gestures(new_button);
+
+    buttons.push_back(std::move(new_button));
+    attach(buttons.back());
+    return true;
 }
 
 void Buttons::remove_button(uint8_t pin) {
     if (is_disabled()) return;
 
-    buttons.erase(std::remove_if(buttons.begin(), buttons.end(),
-        [pin](const Button& btn) { return btn.pin == pin; }), buttons.end());
+    for (auto it = buttons.begin(); it != buttons.end(); ) {
+        if (it->pin != pin) { ++it; continue; }
+        detach(*it);
+        if (it->settling) settling_count--;
+        held_mask.reset(pin);
+        it = buttons.erase(it);
+    }
 }
 
-bool Buttons::parse_config_string(const std::string& config, Button& button) {
+bool Buttons::parse_config_string(const std::string& config, Button& button, Binding& binding) {
     if (is_disabled()) return false;
 
     std::string s = config;
@@ -146,16 +764,14 @@ bool Buttons::parse_config_string(const std::string& config, Button& button) {
 
     auto sp = s.find(' ');
     if (sp == std::string::npos) return false;
-    try {
-        button.pin = static_cast<uint8_t>(std::stoi(s.substr(0, sp)));
-    } catch (...) { return false; }
+    if (!parse_id(s.substr(0, sp), button.pin)) return false;
     s = s.substr(sp + 1);
     trim(s);
 
     if (s.empty() || s[0] != '"') return false;
     auto endq = s.find('"', 1);
     if (endq == std::string::npos) return false;
-    button.command = s.substr(1, endq - 1);
+    binding.action.source = s.substr(1, endq - 1);
     s = s.substr(endq + 1);
     trim(s);
 
@@ -180,13 +796,7 @@ bool Buttons::parse_config_string(const std::string& config, Button& button) {
     button.type =
         (type_str == "pulldown") ? BUTTON_PULLDOWN : BUTTON_PULLUP;
 
-    if (event_str == "release" || event_str == "on_release") {
-        button.event = BUTTON_ON_RELEASE;
-    } else if (event_str == "change" || event_str == "on_change") {
-        button.event = BUTTON_ON_CHANGE;
-    } else {
-        button.event = BUTTON_ON_PRESS;
-    }
+    if (!parse_trigger(event_str, button.pin, binding)) return false;
 
     try {
         button.debounce_interval = static_cast<uint32_t>(std::stoul(debounce_str));
@@ -197,6 +807,71 @@ bool Buttons::parse_config_string(const std::string& config, Button& button) {
     return true;
 }
 
+// <name>[=<arg>]: click windows and the long press threshold take milliseconds, repeat
+// takes <delay>/<interval>, chord takes the other member pins joined with '+'.
+bool Buttons::parse_trigger(const std::string& token, uint8_t pin, Binding& binding) const {
+    std::string name = to_lower(token);
+    std::string arg;
+    const auto eq = name.find('=');
+    if (eq != std::string::npos) {
+        arg = name.substr(eq + 1);
+        name.resize(eq);
+    }
+    binding.hold_ms = 0;
+    binding.interval_ms = 0;
+    binding.chord_mask.reset();
+    binding.fired = false;
+
+    auto ms_arg = [&arg](uint32_t fallback, uint32_t& out) {
+        out = fallback;
+        return arg.empty() || (parse_int(arg, out) && out > 0 && out <= MAX_GESTURE_MS);
+    };
+
+    if (name == "press" || name == "on_press") {
+        binding.event = BUTTON_ON_PRESS;
+        return arg.empty();
+    }
+    if (name == "release" || name == "on_release") {
+        binding.event = BUTTON_ON_RELEASE;
+        return arg.empty();
+    }
+    if (name == "change" || name == "on_change") {
+        binding.event = BUTTON_ON_CHANGE;
+        return arg.empty();
+    }
+    if (name == "click" || name == "double_click" || name == "triple_click") {
+        binding.event = name == "click" ? BUTTON_CLICK : name == "double_click" ? BUTTON_DOUBLE_CLICK : BUTTON_TRIPLE_CLICK;
+        return ms_arg(DEFAULT_CLICK_WINDOW_MS, binding.hold_ms);
+    }
+    if (name == "long_press") {
+        binding.event = BUTTON_LONG_PRESS;
+        return ms_arg(DEFAULT_LONG_PRESS_MS, binding.hold_ms);
+    }
+    if (name == "repeat") {
+        binding.event = BUTTON_REPEAT;
+        binding.hold_ms = DEFAULT_REPEAT_DELAY_MS;
+        binding.interval_ms = DEFAULT_REPEAT_INTERVAL_MS;
+        if (arg.empty()) return true;
+        const auto slash = arg.find('/');
+        const bool ok = slash == std::string::npos
+                      ? parse_int(arg, binding.hold_ms)
+                      : parse_int(arg.substr(0, slash), binding.hold_ms) && parse_int(arg.substr(slash + 1), binding.interval_ms);
+        return ok && binding.hold_ms <= MAX_GESTURE_MS && binding.interval_ms > 0 && binding.interval_ms <= MAX_GESTURE_MS;
+    }
+    if (name == "chord") {
+        binding.event = BUTTON_CHORD;
+        binding.chord_mask.set(pin);
+        for (const auto& member : split_by_token(arg, "+")) {
+            uint8_t member_id = 0;
+            if (!parse_id(member, member_id)) return false;
+            binding.chord_mask.set(member_id);
+        }
+        // at least one other input besides this one
+        return binding.chord_mask.count() > 1;
+    }
+    return false;
+}
+
 /* --- NVS helpers (encapsulated) --- */
 
 void Buttons::load_from_nvs() {
@@ -213,41 +888,27 @@ void Buttons::load_from_nvs() {
     load_configs(cfgs);
 }
 
-bool Buttons::nvs_has_pin(const std::string& pin_str) const {
-    if (is_disabled()) return false;
-
-    int btn_count = controller.nvs.read_uint8(nvs_key, "btn_count", 0);
-    std::string prefix = pin_str + std::string(" ");
-    for (int i = 0; i < btn_count; i++) {
-        std::string key = "btn_cfg_" + std::to_string(i);
-        std::string existing = controller.nvs.read_str(nvs_key, key);
-        if (existing.rfind(prefix, 0) == 0) return true; // starts with "<pin> "
-    }
-    return false;
-}
-
+// Drops every stored mapping on the pin, keeping the others in order.
 bool Buttons::nvs_remove_by_pin(const std::string& pin_str) {
     if (is_disabled()) return false;
 
     int btn_count = controller.nvs.read_uint8(nvs_key, "btn_count", 0);
-    int found_index = -1;
     std::string prefix = pin_str + std::string(" ");
+    std::vector<std::string> kept;
     for (int i = 0; i < btn_count; i++) {
         std::string key = "btn_cfg_" + std::to_string(i);
         std::string cfg = controller.nvs.read_str(nvs_key, key);
-        if (cfg.rfind(prefix, 0) == 0) { found_index = i; break; }
+        if (cfg.rfind(prefix, 0) != 0) kept.emplace_back(std::move(cfg));
     }
-    if (found_index == -1) return false;
+    if (static_cast<int>(kept.size()) == btn_count) return false;
 
-    for (int i = found_index; i < btn_count - 1; i++) {
-        std::string next_key = "btn_cfg_" + std::to_string(i + 1);
-        std::string cur_key  = "btn_cfg_" + std::to_string(i);
-        std::string next_cfg = controller.nvs.read_str(nvs_key, next_key);
-        controller.nvs.write_str(nvs_key, cur_key, next_cfg);
+    for (size_t i = 0; i < kept.size(); i++) {
+        controller.nvs.write_str(nvs_key, "btn_cfg_" + std::to_string(i), kept[i]);
+    }
+    for (int i = static_cast<int>(kept.size()); i < btn_count; i++) {
+        controller.nvs.remove(nvs_key, "btn_cfg_" + std::to_string(i));
     }
-    std::string last_key = "btn_cfg_" + std::to_string(btn_count - 1);
-    controller.nvs.remove(nvs_key, last_key);
-    controller.nvs.write_uint8(nvs_key, "btn_count", btn_count - 1);
+    controller.nvs.write_uint8(nvs_key, "btn_count", static_cast<uint8_t>(kept.size()));
     return true;
 }
 
@@ -271,14 +932,6 @@ void Buttons::nvs_clear_all() {
     controller.nvs.write_uint8(nvs_key, "btn_count", 0);
 }
 
-std::string Buttons::pin_prefix(const std::string& cfg) {
-    if (is_disabled()) return "";
-
-    auto sp = cfg.find(' ');
-    if (sp == std::string::npos) return {};
-    return cfg.substr(0, sp);
-}
-
 /* --- CLI handlers (called by ctor-registered lambdas) --- */
 void Buttons::button_add_cli(std::string_view args_sv) {
     if (is_disabled()) return;
@@ -288,22 +941,12 @@ void Buttons::button_add_cli(std::string_view args_sv) {
         return;
     }
     std::string args(args_sv);
-    std::string pin_str = pin_prefix(args);
-    if (pin_str.empty()) {
-        controller.serial_port.print("Error: Invalid add syntax.");
-        return;
-    }
-    if (nvs_has_pin(pin_str)) {
-        std::string msg = "Error: A button is already configured on pin " + pin_str;
-        controller.serial_port.print(msg);
-        return;
-    }
     if (add_button_from_config(args)) {
         nvs_append_config(args);
         std::string msg = "Successfully added button action: " + args;
         controller.serial_port.print(msg);
     } else {
-        controller.serial_port.print("Error: Invalid button configuration string.");
+        controller.serial_port.print(std::string("Error: ") + (add_error ? add_error : "Invalid button configuration string."));
     }
 }
 
@@ -324,9 +967,46 @@ void Buttons::button_remove_cli(std::string_view args_sv) {
         controller.serial_port.print(msg);
         return;
     }
-    uint8_t pin_to_remove = static_cast<uint8_t>(std::atoi(pin_str.c_str()));
-    remove_button(pin_to_remove);
-    std::string msg = "Successfully removed button on pin " + pin_str;
+    uint8_t pin_to_remove = 0;
+    if (parse_id(pin_str, pin_to_remove)) remove_button(pin_to_remove);
+    std::string msg = "Successfully removed all mappings on pin " + pin_str;
     controller.serial_port.print(msg);
 }
 
+void Buttons::button_scan_cli(std::string_view args_sv) {
+    if (is_disabled()) return;
+
+    uint8_t ms = 0;
+    if (!parse_int(args_sv, ms) || ms > MAX_SCAN_MS) {
+        controller.serial_port.printf("Error: scan period must be 0-%u ms", static_cast<unsigned>(MAX_SCAN_MS));
+        return;
+    }
+    set_scan_period(ms);
+    controller.nvs.write_uint8(nvs_key, "scan_ms", ms);
+    if (ms) controller.serial_port.printf("Buttons are scanned by GPIO bank every %u ms", static_cast<unsigned>(ms));
+    else    controller.serial_port.print("Buttons use edge interrupts");
+}
+
+void Buttons::button_matrix_cli(std::string_view args_sv) {
+    if (is_disabled()) return;
+
+    const auto args = split_args(args_sv);
+    if (args.size() != 2 || !set_matrix(args[0], args[1])) {
+        controller.serial_port.print(std::string("Error: ") + (add_error ? add_error : "Invalid matrix pins."));
+        return;
+    }
+    controller.nvs.write_str(nvs_key, "mx_rows", args[0]);
+    controller.nvs.write_str(nvs_key, "mx_cols", args[1]);
+    controller.serial_port.printf("Keypad matrix: %u rows x %u columns, keys r0c0..r%uc%u",
+                                  static_cast<unsigned>(matrix_rows.size()), static_cast<unsigned>(matrix_cols.size()),
+                                  static_cast<unsigned>(matrix_rows.size() - 1), static_cast<unsigned>(matrix_cols.size() - 1));
+}
+
+void Buttons::button_matrix_clear_cli(std::string_view args_sv) {
+    if (is_disabled()) return;
+
+    clear_matrix();
+    controller.nvs.remove(nvs_key, "mx_rows");
+    controller.nvs.remove(nvs_key, "mx_cols");
+    controller.serial_port.print("Keypad matrix removed");
+}
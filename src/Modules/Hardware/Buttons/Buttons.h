@@ -10,13 +10,57 @@
 // src/Modules/Hardware/Buttons/Buttons.h
 #pragma once
 
+// Each button pin has a CHANGE interrupt that only timestamps the edge and queues it
+// in an EdgeRing; loop() debounces from those timestamps. With nothing moving, loop()
+// returns after one empty-ring check. A level is committed once the line has been
+// quiet for the debounce interval, and the press is stamped with the first edge of
+// the burst, i.e. when the contact actually moved, to the microsecond.
+//
+// A pin can carry several bindings, one per trigger. Debounced presses and releases
+// feed a small per-button gesture state machine (click counting, long press, hold
+// repeat, chords); it only runs timers while a gesture is actually in progress.
+//
+// Bound commands are resolved against the command table when they are added, and
+// again whenever the table is rebuilt; a press runs the resolved handler directly.
+//
+// With many buttons, `scan <ms>` trades the interrupts for periodic sampling: each
+// GPIO bank's input register is read once per scan and debounced as a whole word by
+// a BankScanner, so a scan costs the same for two buttons or thirty.
+//
+// A keypad matrix (up to 8x8) is scanned every MATRIX_SCAN_MS by pulling one row low
+// at a time and reading the columns from the input registers. Its keys are inputs
+// like any pin, named r<row>c<col>, and go through the same debounce and gesture
+// paths; a scan that shows ghosting (no diodes, three keys on a rectangle) is dropped.
+
 #include "../../Module/Module.h"
+#include "../../Software/CommandParser/CommandParser.h"
+#include "BankScanner.h"
+#include "EdgeRing.h"
+
+#include <bitset>
 
 struct ButtonsConfig : public ModuleConfig {};
 
 
 class Buttons : public Module {
 public:
+    // pin: the GPIO, or KEY_BASE + row * MATRIX_MAX + col for a keypad key
+    // at_us: micros() of the first edge of the debounced transition
+    using button_listener_t     = function<void(uint8_t pin, bool pressed, uint32_t at_us)>;
+    static constexpr size_t     EDGE_RING_SIZE              = 64;
+    static constexpr uint8_t    KEY_BASE                    = 64;   // input ids from here on are keypad keys, above any GPIO
+    static constexpr uint8_t    MATRIX_MAX                  = 8;    // rows or columns
+    static constexpr size_t     MAX_IDS                     = KEY_BASE + MATRIX_MAX * MATRIX_MAX;
+    static constexpr uint32_t   MATRIX_SCAN_MS              = 5;
+    static constexpr uint32_t   MATRIX_SETTLE_US            = 3;    // row pulled low until the columns follow
+    static constexpr uint32_t   DEFAULT_CLICK_WINDOW_MS     = 300;
+    static constexpr uint32_t   DEFAULT_LONG_PRESS_MS       = 800;
+    static constexpr uint32_t   DEFAULT_REPEAT_DELAY_MS     = 500;
+    static constexpr uint32_t   DEFAULT_REPEAT_INTERVAL_MS  = 100;
+    static constexpr uint32_t   MAX_GESTURE_MS              = 600000;   // timers run in micros()
+    static constexpr size_t     GPIO_BANKS                  = 2;        // GPIO_IN_REG, GPIO_IN1_REG
+    static constexpr uint8_t    MAX_SCAN_MS                 = 50;
+
     explicit                    Buttons                     (SystemController& controller);
 
     void                        begin_routines_regular      (const ModuleConfig& cfg)       override;
@@ -28,39 +72,132 @@ public:
                                                              const bool keep_enabled=true)    override;
 
     string                      status                      (const bool verbose=false)      const override;
+    void                        status_json                 (xewe::json::Writer& out)       const override;
 
     void                        load_configs                (const std::vector<std::string>& configs);
-    bool                        add_button_from_config      (const std::string& config);
+    bool                        add_button_from_config      (const std::string& config, bool restoring = false);
     void                        remove_button               (uint8_t pin);
+    // called on every debounced edge, whether or not it triggers the button's command
+    void                        on_button_event             (button_listener_t listener);
 
 private:
     enum                        InputMode                   { BUTTON_PULLUP, BUTTON_PULLDOWN };
-    enum                        TriggerEvent                { BUTTON_ON_PRESS, BUTTON_ON_RELEASE, BUTTON_ON_CHANGE };
+    enum                        TriggerEvent                { BUTTON_ON_PRESS, BUTTON_ON_RELEASE, BUTTON_ON_CHANGE,
+                                                              BUTTON_CLICK, BUTTON_DOUBLE_CLICK, BUTTON_TRIPLE_CLICK,
+                                                              BUTTON_LONG_PRESS, BUTTON_REPEAT, BUTTON_CHORD };
+
+    using input_mask_t          = std::bitset<MAX_IDS>;
+
+    struct Binding {
+        TriggerEvent event;
+        CompiledCommand action;
+        uint32_t hold_ms;               // click window, long press threshold or repeat delay
+        uint32_t interval_ms;           // repeat interval
+        input_mask_t chord_mask;        // chord: every member input, this one included
+        bool fired;                     // long press / chord latch, cleared on release
+    };
 
     struct Button {
-        uint8_t pin;
-        std::string command;
+        uint8_t pin;                    // GPIO, or a keypad key id (see is_key)
         uint32_t debounce_interval;
         InputMode type;
-        TriggerEvent event;
-        uint32_t last_debounce_time;
         int last_steady_state;
-        int last_flicker_state;
+        bool settling;                  // edges seen, waiting for the line to go quiet
+        uint32_t first_edge_us;         // start of the current bounce burst
+        uint32_t last_edge_us;
+        uint32_t last_change_us;        // first_edge_us of the last committed transition
+        std::vector<Binding> bindings;
+
+        // gesture state
+        bool pressed;
+        bool consumed;                  // a chord or long press took this hold: no more gestures from it
+        uint8_t clicks;                 // releases counted in the open click window
+        uint8_t max_clicks;             // most clicks any binding waits for; 0 = no click bindings
+        uint32_t click_window_us;
+        uint32_t pressed_us;
+        uint32_t released_us;
+        uint32_t next_repeat_us;
     };
 
-    bool                        parse_config_string         (const std::string& config, Button& button);
+    static void IRAM_ATTR       on_edge                     (void* arg);
+    void                        attach                      (const Button& button);
+    void                        detach                      (const Button& button);
+    void                        resync                      ();
+    void                        drain_edges                 ();
+    bool                        settle                      (uint32_t now_us);
+    bool                        scan_banks                  (uint32_t now_us);
+    static uint32_t             read_bank                   (size_t bank);
+    void                        set_scan_period             (uint8_t ms);
+    void                        commit                      (Button& button,
+                                                             int level,
+                                                             uint32_t at_us);
+
+    void                        press                       (Button& button,
+                                                             uint32_t at_us);
+    void                        release                     (Button& button,
+                                                             uint32_t at_us);
+    uint8_t                     tick                        (uint32_t now_us);
+    void                        resolve_clicks              (Button& button);
+    void                        fire                        (const Binding& binding);
+    void                        resolve_all                 ();
+    bool                        resolve                     (Binding& binding);
+    static void                 refresh_gestures            (Button& button);
+    static bool                 same_trigger                (const Binding& a,
+                                                             const Binding& b);
+    static std::string          describe                    (const Binding& binding);
+    static bool                 is_key                      (uint8_t id)                    { return id >= KEY_BASE; }
+    static std::string          id_name                     (uint8_t id);
+    static bool                 parse_id                    (const std::string& token,
+                                                             uint8_t& id);
+
+    bool                        set_matrix                  (const std::string& rows,
+                                                             const std::string& cols);
+    void                        clear_matrix                ();
+    bool                        in_matrix                   (uint8_t id)                    const;
+    bool                        matrix_uses                 (uint8_t pin)                   const;
+    bool                        scan_matrix                 (uint32_t now_us);
+
+    bool                        parse_config_string         (const std::string& config,
+                                                             Button& button,
+                                                             Binding& binding);
+    bool                        parse_trigger               (const std::string& token,
+                                                             uint8_t pin,
+                                                             Binding& binding)          const;
 
     void                        load_from_nvs               ();
-    bool                        nvs_has_pin                 (const std::string& pin_str) const;
     bool                        nvs_remove_by_pin           (const std::string& pin_str);
     void                        nvs_append_config           (const std::string& cfg);
     void                        nvs_clear_all               ();
-    std::string                 pin_prefix                  (const std::string& cfg);
 
     void                        button_add_cli              (std::string_view args);
     void                        button_remove_cli           (std::string_view args);
+    void                        button_scan_cli             (std::string_view args);
+    void                        button_matrix_cli           (std::string_view args);
+    void                        button_matrix_clear_cli     (std::string_view args);
 
     std::vector<Button>         buttons;
+    vector<button_listener_t>   button_listeners;
     bool                        loaded_from_nvs             {false};
+    uint8_t                     settling_count              {0};
+    uint8_t                     timing_count                {0};    // buttons with a gesture timer running
+    input_mask_t                held_mask;                          // debounced pressed inputs
+    uint32_t                    edges_seen                  {0};
+    uint32_t                    dropped_seen                {0};    // edges.dropped() at the last resync
+    uint32_t                    gestures_fired              {0};
+    uint8_t                     scan_ms                     {0};    // 0: edge interrupts, else bank scan period
+    uint32_t                    last_scan_ms                {0};
+    uint32_t                    scans                       {0};
+    xewe::input::BankScanner<GPIO_BANKS> scanner;
+    std::vector<uint8_t>        matrix_rows;                        // open drain, pulled low one at a time
+    std::vector<uint8_t>        matrix_cols;                        // inputs with pull-ups
+    bool                        matrix_high_bank            {false};    // a column is on GPIO 32 or up
+    uint32_t                    last_matrix_ms              {0};
+    uint32_t                    matrix_scans                {0};
+    uint32_t                    ghost_scans                 {0};    // scans dropped as ambiguous
+    xewe::input::BankScanner<MATRIX_MAX * MATRIX_MAX / 32> key_scanner;  // bit row * MATRIX_MAX + col
+    const char*                 add_error                   {nullptr};  // why the last add or matrix change was refused
+    uint32_t                    resolved_generation         {0};    // command table the bindings resolved against
+    std::vector<CompiledCommand> pending_commands;                  // run after the button pass
+
+    static EdgeRing<EDGE_RING_SIZE> edges;
 };
-
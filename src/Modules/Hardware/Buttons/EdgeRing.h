@@ -0,0 +1,65 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Hardware/Buttons/EdgeRing.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single-producer / single-consumer ring of timestamped GPIO edges. The GPIO ISR
+// pushes and Buttons::loop pops; neither side blocks or takes a lock. All GPIO
+// interrupts are serviced on the core that attached them and don't nest, so there
+// is only ever one producer. When the ring is full the edge is dropped and counted;
+// the consumer sees dropped() move and re-reads the pins instead.
+template <size_t N>
+class EdgeRing {
+    static_assert(N && (N & (N - 1)) == 0, "EdgeRing size must be a power of two");
+
+public:
+    struct Edge {
+        uint8_t                 pin;
+        uint32_t                us;                 // micros() when the ISR ran
+    };
+
+    // producer side (ISR). Forced inline so it lands in the caller's IRAM_ATTR code:
+    // an out-of-line template instance would live in flash, which an IRAM-only GPIO
+    // ISR must not call.
+    __attribute__((always_inline)) inline bool push(const Edge& edge) {
+        const uint32_t head = write_index.load(std::memory_order_relaxed);
+        if (head - read_index.load(std::memory_order_acquire) >= N) {
+            dropped_edges.store(dropped_edges.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[head & (N - 1)] = edge;
+        write_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side (main loop)
+    bool pop(Edge& edge) {
+        const uint32_t tail = read_index.load(std::memory_order_relaxed);
+        if (tail == write_index.load(std::memory_order_acquire)) return false;
+        edge = slots[tail & (N - 1)];
+        read_index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool     empty()   const { return read_index.load(std::memory_order_relaxed) == write_index.load(std::memory_order_acquire); }
+    uint32_t dropped() const { return dropped_edges.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    std::array<Edge, N>         slots               {};
+    std::atomic<uint32_t>       write_index         {0};
+    std::atomic<uint32_t>       read_index          {0};
+    std::atomic<uint32_t>       dropped_edges       {0};
+};
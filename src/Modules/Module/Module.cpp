@@ -174,6 +174,10 @@ string Module::status(bool verbose) const {
     return status_str;
 }
 
+void Module::status_json(xewe::json::Writer& out) const {
+    out.field("text", status(false));
+}
+
 // only print the debug msg if true
 bool Module::is_enabled(bool verbose) const {
     DBG_PRINTF(Module, "'%s'->is_enabled(verbose=%s): Called.\n", module_name.c_str(), verbose ? "true" : "false");
@@ -17,6 +17,8 @@
 
 #include "../../../Config.h"
 #include "../../Debug.h"
+#include "../../XeWeJson.h"
+#include "../../XeWeMetrics.h"
 #include "../../XeWeStringUtils.h"
 
 using namespace std;
@@ -95,6 +97,10 @@ public:
                                                              const bool keep_enabled=true);
 
     virtual string              status                      (const bool verbose=false)      const;
+    // machine-readable status: writes the members of the module's "status" object
+    virtual void                status_json                 (xewe::json::Writer& out)       const;
+    // Prometheus samples for /metrics; modules without counters write nothing
+    virtual void                write_metrics               (xewe::metrics::Writer& out)    const {}
     bool                        is_enabled                  (const bool verbose=false)      const;
     bool                        is_disabled                 (const bool verbose=false)      const;
     bool                        init_setup_complete         (const bool verbose=false)      const;
@@ -39,6 +39,7 @@ void CommandParser::begin_routines_required(const ModuleConfig& cfg) {
         if (!grp.commands.empty())
             command_groups.push_back(grp);
     }
+    generation++;
 }
 
 
@@ -78,9 +79,7 @@ void CommandParser::print_help(const string& group_name) const {
         }
     }
 
-    Serial.print("Error: Command group '");
-    Serial.print(group_name.c_str());
-    Serial.println("' not found.");
+    controller.serial_port.printf("Error: Command group '%s' not found.", group_name.c_str());
 }
 
 void CommandParser::print_all_commands() const {
@@ -93,7 +92,42 @@ void CommandParser::print_all_commands() const {
     }
 }
 
-void CommandParser::parse(string_view input_line) const {
+ParseStatus CommandParser::parse(string_view input_line) const {
+    const ParseStatus status = parse_line(input_line);
+    status_counts[static_cast<size_t>(status)]++;
+    return status;
+}
+
+ParseStatus CommandParser::parse_line(string_view input_line) const {
+    CompiledCommand compiled;
+    const ParseStatus status = compile(input_line, compiled);
+    if (status == ParseStatus::OK) invoke(compiled);
+    return status;
+}
+
+ParseStatus CommandParser::run(CompiledCommand& compiled) const {
+    ParseStatus status = ParseStatus::OK;
+    if (compiled.generation == 0 || compiled.generation != generation) {
+        status = compile(string(compiled.source), compiled);
+    }
+    if (status == ParseStatus::OK) invoke(compiled);
+    status_counts[static_cast<size_t>(status)]++;
+    return status;
+}
+
+void CommandParser::invoke(const CompiledCommand& compiled) const {
+    if (!compiled.group)        print_all_commands();
+    else if (!compiled.command) print_help(compiled.group->name);
+    else                        compiled.command->function(compiled.args);
+}
+
+ParseStatus CommandParser::compile(string_view input_line, CompiledCommand& out, bool verbose) const {
+    out.source.assign(input_line.begin(), input_line.end());
+    out.group = nullptr;
+    out.command = nullptr;
+    out.args.clear();
+    out.generation = 0;
+
     // Copy into mutable string
     string local(input_line.begin(), input_line.end());
     auto is_space = [](char c){ return isspace(static_cast<unsigned char>(c)); };
@@ -101,13 +135,13 @@ void CommandParser::parse(string_view input_line) const {
     // Trim whitespace
     size_t b = local.find_first_not_of(" \t\r\n"),
            e = local.find_last_not_of(" \t\r\n");
-    if (b == string::npos) return;
+    if (b == string::npos) return ParseStatus::EMPTY;
     local = local.substr(b, e - b + 1);
 
     // Must start with $
     if (local.empty() || local[0] != '$') {
-        Serial.println("Error: commands must start with '$'; type $help");
-        return;
+        if (verbose) controller.serial_port.print("Error: commands must start with '$'; type $help");
+        return ParseStatus::MISSING_PREFIX;
     }
 
     // Drop '$' and trim again
@@ -125,8 +159,8 @@ void CommandParser::parse(string_view input_line) const {
     string gl = group;
     transform(gl.begin(), gl.end(), gl.begin(), ::tolower);
     if (gl == "help") {
-        print_all_commands();
-        return;
+        out.generation = generation;
+        return ParseStatus::OK;
     }
 
     // Extract rest of line
@@ -152,8 +186,8 @@ void CommandParser::parse(string_view input_line) const {
             quoted = true;
             size_t q = rest.find('"', pos+1);
             if (q == string::npos) {
-                Serial.println("Error: Unterminated quote in command.");
-                return;
+                if (verbose) controller.serial_port.print("Error: Unterminated quote in command.");
+                return ParseStatus::UNTERMINATED_QUOTE;
             }
             tok = rest.substr(pos+1, q-pos-1);
             pos = q+1;
@@ -186,8 +220,9 @@ void CommandParser::parse(string_view input_line) const {
         if (gl == name) {
             // If no subcommand provided, show help for this group
             if (cmd.empty()) {
-                print_help(grp.name);
-                return;
+                out.group = &grp;
+                out.generation = generation;
+                return ParseStatus::OK;
             }
             // Find matching command
             string cl = cmd;
@@ -197,13 +232,13 @@ void CommandParser::parse(string_view input_line) const {
                 transform(cn.begin(), cn.end(), cn.begin(), ::tolower);
                 if (cl == cn) {
                     if (c.arg_count != args.size()) {
-                        Serial.printf(
-                          "Error: '%s' expects %u args, but got %u\n",
+                        if (verbose) controller.serial_port.printf(
+                          "Error: '%s' expects %u args, but got %u",
                            c.name.c_str(),
                            unsigned(c.arg_count),
                            unsigned(args.size())
                         );
-                        return;
+                        return ParseStatus::WRONG_ARG_COUNT;
                     }
                     // Rebuild args string
                     string rebuilt;
@@ -216,16 +251,40 @@ void CommandParser::parse(string_view input_line) const {
                         }
                         if (ai + 1 < args.size()) rebuilt += ' ';
                     }
-                    // pass a string, not a string_view
-                    c.function(rebuilt);
-                    return;
+                    out.group = &grp;
+                    out.command = &c;
+                    out.args = std::move(rebuilt);
+                    out.generation = generation;
+                    return ParseStatus::OK;
                 }
             }
-            Serial.printf("Error: Unknown command '%s'; type $%s to see available commands\n",
-                          cmd.c_str(), group.c_str());
-            return;
+            if (verbose) controller.serial_port.printf("Error: Unknown command '%s'; type $%s to see available commands",
+                                          cmd.c_str(), group.c_str());
+            return ParseStatus::UNKNOWN_COMMAND;
         }
     }
 
-    Serial.printf("Error: Unknown command group '%s'; type $help\n", group.c_str());
+    if (verbose) controller.serial_port.printf("Error: Unknown command group '%s'; type $help", group.c_str());
+    return ParseStatus::UNKNOWN_GROUP;
+}
+
+void CommandParser::write_metrics(xewe::metrics::Writer& out) const {
+    out.family("commands_total", "counter", "Command lines parsed, by outcome.");
+    for (size_t i = 0; i < status_counts.size(); ++i) {
+        out.sample("commands_total", "status", status_name(static_cast<ParseStatus>(i)), status_counts[i]);
+    }
+}
+
+const char* CommandParser::status_name(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::OK:                 return "ok";
+        case ParseStatus::EMPTY:              return "empty";
+        case ParseStatus::MISSING_PREFIX:     return "missing_prefix";
+        case ParseStatus::UNTERMINATED_QUOTE: return "unterminated_quote";
+        case ParseStatus::UNKNOWN_GROUP:      return "unknown_group";
+        case ParseStatus::UNKNOWN_COMMAND:    return "unknown_command";
+        case ParseStatus::WRONG_ARG_COUNT:    return "wrong_arg_count";
+        case ParseStatus::COUNT:              break;
+    }
+    return "unknown";
 }
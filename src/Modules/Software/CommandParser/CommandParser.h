@@ -13,10 +13,34 @@
 #include "../../Module/Module.h"
 
 #include <algorithm>
+#include <array>
 #include <vector>
 
 struct CommandParserConfig : public ModuleConfig {};
 
+// outcome of parse(); OK means a command (or help) ran, not that it succeeded at its job
+enum class ParseStatus : uint8_t {
+    OK,
+    EMPTY,
+    MISSING_PREFIX,
+    UNTERMINATED_QUOTE,
+    UNKNOWN_GROUP,
+    UNKNOWN_COMMAND,
+    WRONG_ARG_COUNT,
+    COUNT
+};
+
+// A command line resolved against the command table once, so it can run again without
+// being trimmed, tokenized or looked up. Only valid for the table it was resolved
+// against: run() resolves it again from source after the table is rebuilt.
+struct CompiledCommand {
+    string                      source;
+    const CommandsGroup*        group                       {nullptr};  // nullptr: $help
+    const Command*              command                     {nullptr};  // nullptr: print the group's help
+    string                      args;                                   // as the command receives them
+    uint32_t                    generation                  {0};        // table it resolved against; 0 = none
+};
+
 class CommandParser: public Module {
 public:
     explicit                    CommandParser               (SystemController& controller);
@@ -26,8 +50,24 @@ public:
     // other methods
     void                        print_help                  (const string& group_name) const;
     void                        print_all_commands          ()                              const;
-    void                        parse                       (string_view input_line)   const;
+    ParseStatus                 parse                       (string_view input_line)   const;
+    // resolves without running; verbose prints the same errors parse() would
+    ParseStatus                 compile                     (string_view input_line,
+                                                             CompiledCommand& out,
+                                                             bool verbose=true)         const;
+    ParseStatus                 run                         (CompiledCommand& compiled) const;
+    // bumped whenever the command table is rebuilt; 0 until it first is
+    uint32_t                    table_generation            ()                          const { return generation; }
+
+    static const char*          status_name                 (ParseStatus status);
+
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
 
 private:
+    ParseStatus                 parse_line                  (string_view input_line)   const;
+    void                        invoke                      (const CompiledCommand& compiled) const;
+
     vector<CommandsGroup>       command_groups;
+    uint32_t                    generation                  {0};
+    mutable array<uint32_t, static_cast<size_t>(ParseStatus::COUNT)> status_counts {};
 };
@@ -46,14 +46,17 @@ void Nvs::write_str(string_view ns, string_view key, string_view value) {
     string k = full_key(ns, key);
     if (!preferences.begin(nvs_key.c_str(), false)) {
         DBG_PRINTF(Nvs, "write_str(): ERROR opening namespace '%s'.\n", nvs_key.c_str());
+        write_failures++;
         return;
     }
     DBG_PRINTF(Nvs, "write_str(): Writing to key '%s' value '%s'.\n", k.c_str(), value.data());
     size_t bytes_written = preferences.putString(k.c_str(), value.data());
     if (bytes_written > 0) {
         DBG_PRINTF(Nvs, "write_str(): Successfully wrote %zu bytes for key '%s'.\n", bytes_written, k.c_str());
+        write_count++;
     } else {
         DBG_PRINTF(Nvs, "write_str(): FAILED to write to key '%s'.\n", k.c_str());
+        write_failures++;
     }
     preferences.end();
 }
@@ -63,13 +66,16 @@ void Nvs::write_uint8(string_view ns, string_view key, uint8_t value) {
     string k = full_key(ns, key);
     if (!preferences.begin(nvs_key.c_str(), false)) {
         DBG_PRINTF(Nvs, "write_uint8(): ERROR opening namespace '%s'.\n", nvs_key.c_str());
+        write_failures++;
         return;
     }
     DBG_PRINTF(Nvs, "write_uint8(): Writing to key '%s' value %u.\n", k.c_str(), value);
     if (preferences.putUChar(k.c_str(), value)) {
         DBG_PRINTF(Nvs, "write_uint8(): Successfully wrote value for key '%s'.\n", k.c_str());
+        write_count++;
     } else {
         DBG_PRINTF(Nvs, "write_uint8(): FAILED to write to key '%s'.\n", k.c_str());
+        write_failures++;
     }
     preferences.end();
 }
@@ -79,13 +85,35 @@ void Nvs::write_uint16(string_view ns, string_view key, uint16_t value) {
     string k = full_key(ns, key);
     if (!preferences.begin(nvs_key.c_str(), false)) {
         DBG_PRINTF(Nvs, "write_uint16(): ERROR opening namespace '%s'.\n", nvs_key.c_str());
+        write_failures++;
         return;
     }
     DBG_PRINTF(Nvs, "write_uint16(): Writing to key '%s' value %u.\n", k.c_str(), value);
     if (preferences.putUShort(k.c_str(), value)) {
         DBG_PRINTF(Nvs, "write_uint16(): Successfully wrote value for key '%s'.\n", k.c_str());
+        write_count++;
     } else {
         DBG_PRINTF(Nvs, "write_uint16(): FAILED to write to key '%s'.\n", k.c_str());
+        write_failures++;
+    }
+    preferences.end();
+}
+
+void Nvs::write_uint32(string_view ns, string_view key, uint32_t value) {
+    DBG_PRINTF(Nvs, "write_uint32(): Attempting to write ns='%s', key='%s', value=%lu.\n", ns.data(), key.data(), (unsigned long)value);
+    string k = full_key(ns, key);
+    if (!preferences.begin(nvs_key.c_str(), false)) {
+        DBG_PRINTF(Nvs, "write_uint32(): ERROR opening namespace '%s'.\n", nvs_key.c_str());
+        write_failures++;
+        return;
+    }
+    DBG_PRINTF(Nvs, "write_uint32(): Writing to key '%s' value %lu.\n", k.c_str(), (unsigned long)value);
+    if (preferences.putUInt(k.c_str(), value)) {
+        DBG_PRINTF(Nvs, "write_uint32(): Successfully wrote value for key '%s'.\n", k.c_str());
+        write_count++;
+    } else {
+        DBG_PRINTF(Nvs, "write_uint32(): FAILED to write to key '%s'.\n", k.c_str());
+        write_failures++;
     }
     preferences.end();
 }
@@ -95,13 +123,16 @@ void Nvs::write_bool(string_view ns, string_view key, bool value) {
     string k = full_key(ns, key);
     if (!preferences.begin(nvs_key.c_str(), false)) {
         DBG_PRINTF(Nvs, "write_bool(): ERROR opening namespace '%s'.\n", nvs_key.c_str());
+        write_failures++;
         return;
     }
     DBG_PRINTF(Nvs, "write_bool(): Writing to key '%s' value %s.\n", k.c_str(), value ? "true" : "false");
     if (preferences.putBool(k.c_str(), value)) {
         DBG_PRINTF(Nvs, "write_bool(): Successfully wrote value for key '%s'.\n", k.c_str());
+        write_count++;
     } else {
         DBG_PRINTF(Nvs, "write_bool(): FAILED to write to key '%s'.\n", k.c_str());
+        write_failures++;
     }
     preferences.end();
 }
@@ -116,6 +147,7 @@ void Nvs::remove(string_view ns, string_view key) {
     DBG_PRINTF(Nvs, "remove(): Removing key '%s'.\n", k.c_str());
     if (preferences.remove(k.c_str())) {
         DBG_PRINTF(Nvs, "remove(): Successfully removed key '%s'.\n", k.c_str());
+        remove_count++;
     } else {
         DBG_PRINTF(Nvs, "remove(): FAILED to remove key '%s'. Key might not exist.\n", k.c_str());
     }
@@ -226,6 +258,19 @@ uint16_t Nvs::read_uint16(string_view ns, string_view key, uint16_t default_valu
     return v;
 }
 
+uint32_t Nvs::read_uint32(string_view ns, string_view key, uint32_t default_value) {
+    DBG_PRINTF(Nvs, "read_uint32(): Attempting to read ns='%s', key='%s'.\n", ns.data(), key.data());
+    if (!preferences.begin(nvs_key.c_str(), false)) {
+        DBG_PRINTF(Nvs, "read_uint32(): ERROR opening namespace '%s'. Returning default value %lu.\n", nvs_key.c_str(), (unsigned long)default_value);
+        return default_value;
+    }
+    string k = full_key(ns, key);
+    uint32_t v = preferences.getUInt(k.c_str(), default_value);
+    DBG_PRINTF(Nvs, "read_uint32(): Read key '%s', got value %lu.\n", k.c_str(), (unsigned long)v);
+    preferences.end();
+    return v;
+}
+
 bool Nvs::read_bool(string_view ns, string_view key, bool default_value) {
     DBG_PRINTF(Nvs, "read_bool(): Attempting to read ns='%s', key='%s'.\n", ns.data(), key.data());
     // FIX: Changed 'true' to 'false' to allow namespace creation on first read
@@ -240,6 +285,12 @@ bool Nvs::read_bool(string_view ns, string_view key, bool default_value) {
     return v;
 }
 
+void Nvs::write_metrics(xewe::metrics::Writer& out) const {
+    out.counter("nvs_writes_total", "Successful NVS writes.", write_count);
+    out.counter("nvs_write_failures_total", "NVS writes that failed.", write_failures);
+    out.counter("nvs_removes_total", "NVS keys removed.", remove_count);
+}
+
 string Nvs::full_key(string_view ns, string_view key) const {
     DBG_PRINTF(Nvs, "full_key(): Generating key for ns='%s', key='%s'.\n", ns.data(), key.data());
     string combined = string(ns) + ":" + string(key);
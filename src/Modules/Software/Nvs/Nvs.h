@@ -32,6 +32,7 @@ public:
     void                        reset                       (const bool verbose=false,
                                                              const bool do_restart=true,
                                                              const bool keep_enabled=true)    override;
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
 
     // other methods
     void                        write_str                   (string_view ns,
@@ -43,6 +44,9 @@ public:
     void                        write_uint16                (string_view ns,
                                                              string_view key,
                                                              uint16_t value);
+    void                        write_uint32                (string_view ns,
+                                                             string_view key,
+                                                             uint32_t value);
     void                        write_bool                  (string_view ns,
                                                              string_view key,
                                                              bool value);
@@ -60,6 +64,9 @@ public:
     uint16_t                    read_uint16                 (string_view ns,
                                                              string_view key,
                                                              uint16_t default_value = 0);
+    uint32_t                    read_uint32                 (string_view ns,
+                                                             string_view key,
+                                                             uint32_t default_value = 0);
     bool                        read_bool                   (string_view ns,
                                                              string_view key,
                                                                bool default_value = false);
@@ -67,6 +74,9 @@ public:
 private:
     static constexpr size_t     MAX_KEY_LEN                 = 15;
     Preferences                 preferences;
+    uint32_t                    write_count                 = 0;    // flash wear indicators for /metrics
+    uint32_t                    write_failures              = 0;
+    uint32_t                    remove_count                = 0;
     string                      full_key                    (string_view ns,
                                                              string_view key) const;
 };
@@ -0,0 +1,509 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/RemoteConsole/RemoteConsole.cpp
+
+#include "RemoteConsole.h"
+#include "../../../SystemController/SystemController.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t LISTEN_RETRY_MS = 5000;     // the network stack may not be up at boot
+constexpr size_t   READ_CHUNK      = 128;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool set_nonblocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+
+} // namespace
+
+
+RemoteConsole::RemoteConsole(SystemController& controller)
+      : Module(controller,
+               /* module_name         */ "Remote_Console",
+               /* module_description  */ "Serial CLI over TCP (telnet or nc), several sessions at once",
+               /* nvs_key             */ "rc",
+               /* requires_init_setup */ false,
+               /* can_be_disabled     */ true,
+               /* has_cli_cmds        */ true)
+{
+    commands_storage.push_back({
+        "port",
+        "Set the TCP port the console listens on (1-65535)",
+        std::string("$") + lower(module_name) + " port 23",
+        1,
+        [this](std::string_view args){ set_port(args); }
+    });
+    commands_storage.push_back({
+        "monitor",
+        "From a remote session: also show everything else the console prints: <on|off>",
+        std::string("$") + lower(module_name) + " monitor on",
+        1,
+        [this](std::string_view args){ set_monitor(args); }
+    });
+    commands_storage.push_back({
+        "sessions",
+        "List open remote console sessions",
+        std::string("$") + lower(module_name) + " sessions",
+        0,
+        [this](std::string_view){ list_sessions(); }
+    });
+}
+
+void RemoteConsole::begin_routines_common(const ModuleConfig& cfg) {
+    port = controller.nvs.read_uint16(nvs_key, "port", DEFAULT_PORT);
+    if (port == 0) port = DEFAULT_PORT;
+
+    // output of a command goes to the session that ran it; the rest to monitoring sessions
+    controller.serial_port.add_output_sink([this](string_view text) {
+        if (running) {
+            queue(*running, text);
+            return;
+        }
+        for (auto& s : sessions) {
+            if (s.fd >= 0 && s.monitor) queue(s, text);
+        }
+    });
+
+    if (is_enabled()) listen();
+}
+
+void RemoteConsole::loop() {
+    if (listen_fd < 0) {
+        if (millis() - listen_attempt_ms < LISTEN_RETRY_MS) return;
+        if (!listen()) return;
+    }
+    accept_sessions();
+
+    for (auto& s : sessions) {
+        if (s.fd < 0) continue;
+        read_input(s);
+        if (s.fd >= 0 && s.line_ready) run_line(s);
+        if (s.fd >= 0 && !s.closing && millis() - s.last_input_ms >= IDLE_TIMEOUT_MS) {
+            queue(s, "\nIdle timeout, closing\n");
+            s.closing = true;
+        }
+        if (s.fd >= 0) flush(s);
+    }
+}
+
+void RemoteConsole::disable(const bool verbose, const bool do_restart) {
+    stop();
+    Module::disable(verbose, do_restart);
+}
+
+string RemoteConsole::status(const bool verbose) const {
+    if (is_disabled()) return "Disabled";
+
+    uint8_t open = 0;
+    for (const auto& s : sessions) open += s.fd >= 0;
+
+    std::string out;
+    out += "--- Remote Console Status ---\n";
+    out += "  - Port:         " + std::to_string(port) + (listen_fd >= 0 ? " (listening)\n" : " (not listening)\n");
+    out += "  - Sessions:     " + std::to_string(open) + " open / " + std::to_string(MAX_SESSIONS) + " max, "
+           + std::to_string(accepted) + " accepted, " + std::to_string(rejected) + " rejected\n";
+    out += "  - Commands:     " + std::to_string(commands_run) + " run, "
+           + std::to_string(output_dropped) + " output bytes dropped\n";
+    out += "-----------------------------\n";
+
+    if (verbose) controller.serial_port.print(out);
+    return out;
+}
+
+void RemoteConsole::status_json(xewe::json::Writer& out) const {
+    uint8_t open = 0;
+    for (const auto& s : sessions) open += s.fd >= 0;
+    out.field("port", port);
+    out.field("listening", listen_fd >= 0);
+    out.field("sessions", open);
+    out.field("accepted", accepted);
+    out.field("rejected", rejected);
+    out.field("commands", commands_run);
+    out.field("output_dropped", output_dropped);
+}
+
+void RemoteConsole::write_metrics(xewe::metrics::Writer& out) const {
+    uint8_t open = 0;
+    for (const auto& s : sessions) open += s.fd >= 0;
+    out.gauge("remote_console_sessions", "Open remote console sessions.", open);
+    out.counter("remote_console_accepted_total", "Remote console sessions accepted.", accepted);
+    out.counter("remote_console_rejected_total", "Remote console connections refused, all sessions busy.", rejected);
+    out.counter("remote_console_commands_total", "Command lines run from remote sessions.", commands_run);
+    out.counter("remote_console_dropped_bytes_total", "Output dropped because a session fell behind.", output_dropped);
+}
+
+// private
+bool RemoteConsole::listen() {
+    listen_attempt_ms = millis();
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::listen(fd, 1) < 0
+        || !set_nonblocking(fd)) {
+        ::close(fd);
+        DBG_PRINTF(RemoteConsole, "listen on port %u failed (errno %d)\n", unsigned(port), errno);
+        return false;
+    }
+    listen_fd = fd;
+    return true;
+}
+
+void RemoteConsole::stop() {
+    for (auto& s : sessions) {
+        if (s.fd >= 0) close(s);
+    }
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+}
+
+void RemoteConsole::accept_sessions() {
+    for (;;) {
+        sockaddr_in addr {};
+        socklen_t   addr_len = sizeof(addr);
+        const int fd = ::accept(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+        if (fd < 0) return;
+
+        // the setup access point is open to anyone in radio range: no CLI over it
+        sockaddr_in local {};
+        socklen_t   local_len = sizeof(local);
+        if (::getsockname(fd, reinterpret_cast<sockaddr*>(&local), &local_len) == 0
+            && controller.wifi.is_portal_address(local.sin_addr.s_addr)) {
+            static const char refused[] = "Console not available on the setup access point\r\n";
+            ::send(fd, refused, sizeof(refused) - 1, SEND_FLAGS | MSG_DONTWAIT);
+            ::close(fd);
+            rejected++;
+            continue;
+        }
+
+        Session* slot = nullptr;
+        for (auto& s : sessions) {
+            if (s.fd < 0) { slot = &s; break; }
+        }
+        if (!slot) {
+            static const char busy[] = "Console busy: all sessions in use\r\n";
+            ::send(fd, busy, sizeof(busy) - 1, SEND_FLAGS | MSG_DONTWAIT);
+            ::close(fd);
+            rejected++;
+            continue;
+        }
+
+        set_nonblocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        *slot               = Session{};
+        slot->fd            = fd;
+        slot->ip            = addr.sin_addr.s_addr;
+        slot->opened_ms     = millis();
+        slot->last_input_ms = slot->opened_ms;
+        accepted++;
+        DBG_PRINTF(RemoteConsole, "session from %s\n", address(slot->ip).c_str());
+
+        queue(*slot, "XeWe OS console on " + controller.wifi.get_hostname()
+                     + "\nType $help for commands, exit to close\n");
+        prompt(*slot);
+    }
+}
+
+// Reads only while no line is waiting to run, so unread input stays in the socket
+// and a client pasting faster than commands run gets backpressure, not a big buffer.
+void RemoteConsole::read_input(Session& s) {
+    if (s.closing || !s.pending.empty()) return;
+    while (!s.line_ready && !s.closing) {
+        uint8_t buf[READ_CHUNK];
+        const ssize_t n = ::recv(s.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close(s);
+            return;
+        }
+        if (n < 0) return;
+
+        s.last_input_ms = millis();
+        ssize_t i = 0;
+        for (; i < n && !s.line_ready && !s.closing; ++i) take_byte(s, buf[i]);
+        if (i < n) {
+            s.pending.assign(reinterpret_cast<const char*>(buf + i), static_cast<size_t>(n - i));
+            return;
+        }
+    }
+}
+
+void RemoteConsole::take_byte(Session& s, uint8_t byte) {
+    switch (s.telnet) {
+        case TelnetState::IAC:
+            if      (byte == 250)               s.telnet = TelnetState::SUBNEG;    // SB
+            else if (byte >= 251 && byte <= 254) s.telnet = TelnetState::OPTION;   // WILL/WONT/DO/DONT
+            else                                s.telnet = TelnetState::DATA;
+            return;
+        case TelnetState::OPTION:
+            s.telnet = TelnetState::DATA;
+            return;
+        case TelnetState::SUBNEG:
+            if (byte == 255) s.telnet = TelnetState::SUBNEG_IAC;
+            return;
+        case TelnetState::SUBNEG_IAC:
+            s.telnet = (byte == 240) ? TelnetState::DATA : TelnetState::SUBNEG;    // SE
+            return;
+        case TelnetState::DATA:
+            break;
+    }
+
+    const bool after_cr = s.skip_lf;
+    s.skip_lf = false;
+    switch (byte) {
+        case 255:                               // IAC
+            s.telnet = TelnetState::IAC;
+            return;
+        case '\r':
+            s.skip_lf    = true;
+            s.line_ready = true;
+            return;
+        case '\n':
+        case '\0':
+            if (!after_cr && byte == '\n') s.line_ready = true;
+            return;
+        case 0x03:                              // Ctrl-C: drop the line
+            s.line.clear();
+            s.line_overflow = false;
+            queue(s, "^C\n");
+            prompt(s);
+            return;
+        case 0x04:                              // Ctrl-D
+            queue(s, "Bye\n");
+            s.closing = true;
+            return;
+        case 0x08:
+        case 0x7F:
+            if (!s.line.empty()) s.line.pop_back();
+            return;
+        default:
+            if (byte < 0x20 && byte != '\t') return;
+            if (s.line.size() >= LINE_BYTES) s.line_overflow = true;
+            else                             s.line.push_back(static_cast<char>(byte));
+    }
+}
+
+void RemoteConsole::run_line(Session& s) {
+    std::string line;
+    line.swap(s.line);
+    const bool overflow = s.line_overflow;
+    s.line_ready    = false;
+    s.line_overflow = false;
+
+    // bytes that arrived behind the line are fed in before the socket is read again
+    if (!s.pending.empty()) {
+        std::string rest;
+        rest.swap(s.pending);
+        size_t i = 0;
+        for (; i < rest.size() && !s.line_ready && !s.closing; ++i) take_byte(s, static_cast<uint8_t>(rest[i]));
+        s.pending.assign(rest, i, std::string::npos);
+    }
+
+    if (overflow) {
+        controller.serial_port.printf("Error: line longer than %u characters", unsigned(LINE_BYTES));
+        queue(s, "Error: line too long, ignored\n");
+        prompt(s);
+        return;
+    }
+
+    trim(line);
+    const std::string& command = line;
+    if (command.empty()) {
+        prompt(s);
+        return;
+    }
+    if (command == "exit" || command == "quit" || command == "logout") {
+        queue(s, "Bye\n");
+        s.closing = true;
+        return;
+    }
+
+    s.commands++;
+    commands_run++;
+    running = &s;
+    controller.command_parser.parse(command);
+    running = nullptr;
+    if (s.fd >= 0) prompt(s);       // the command may have closed the console
+}
+
+// Appends to the session's output with CRLF line ends. Past OUTPUT_BYTES unsent,
+// the rest is dropped and counted; the next prompt reports it.
+void RemoteConsole::queue(Session& s, string_view text) {
+    if (s.fd < 0 || text.empty()) return;
+    // sent bytes are cut off the front once they are half the budget
+    const auto compact = [&s] {
+        if (s.out_sent < OUTPUT_BYTES / 2) return;
+        s.out.erase(0, s.out_sent);
+        s.out_sent = 0;
+    };
+    compact();
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        const bool add_cr = text[i] == '\n' && (i ? text[i - 1] != '\r' : (s.out.empty() || s.out.back() != '\r'));
+        if (s.out.size() - s.out_sent + (add_cr ? 2 : 1) > OUTPUT_BYTES) {
+            // try to make room before giving up on the rest
+            const bool open = flush(s);
+            if (open) compact();
+            if (!open || s.out.size() - s.out_sent + 2 > OUTPUT_BYTES) {
+                if (s.fd >= 0) {
+                    s.dropped      += text.size() - i;
+                    output_dropped += text.size() - i;
+                }
+                return;
+            }
+        }
+        if (add_cr) s.out.push_back('\r');
+        s.out.push_back(text[i]);
+    }
+}
+
+void RemoteConsole::prompt(Session& s) {
+    if (s.dropped) {
+        queue(s, "[" + std::to_string(s.dropped) + " bytes of output dropped]\n");
+        s.dropped = 0;
+    }
+    queue(s, controller.wifi.get_hostname() + "> ");
+}
+
+// Sends what the socket takes without blocking; false once the session is gone.
+bool RemoteConsole::flush(Session& s) {
+    while (s.out_sent < s.out.size()) {
+        const ssize_t n = ::send(s.fd, s.out.data() + s.out_sent, s.out.size() - s.out_sent, SEND_FLAGS | MSG_DONTWAIT);
+        if (n > 0) {
+            s.out_sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        close(s);
+        return false;
+    }
+    if (s.out_sent == s.out.size()) {
+        s.out.clear();
+        s.out_sent = 0;
+        if (s.closing) {
+            close(s);
+            return false;
+        }
+    }
+    return true;
+}
+
+void RemoteConsole::close(Session& s) {
+    if (s.fd < 0) return;
+    DBG_PRINTF(RemoteConsole, "session from %s closed after %lu commands\n",
+               address(s.ip).c_str(), (unsigned long)s.commands);
+    ::close(s.fd);
+    s = Session{};
+}
+
+std::string RemoteConsole::address(uint32_t ip) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%u.%u.%u.%u",
+                  unsigned(ip & 0xFF), unsigned((ip >> 8) & 0xFF), unsigned((ip >> 16) & 0xFF), unsigned(ip >> 24));
+    return text;
+}
+
+void RemoteConsole::set_port(string_view args) {
+    if (is_disabled(true)) return;
+
+    uint16_t value = 0;
+    if (!parse_int<uint16_t>(args, value) || value == 0) {
+        controller.serial_port.print("Error: expected a port between 1 and 65535");
+        return;
+    }
+    controller.nvs.write_uint16(nvs_key, "port", value);
+    if (value == port && listen_fd >= 0) {
+        controller.serial_port.printf("Remote console already on port %u", unsigned(port));
+        return;
+    }
+
+    // open sessions keep their sockets; only new connections use the new port
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+    port = value;
+    if (listen()) controller.serial_port.printf("Remote console listening on port %u", unsigned(port));
+    else          controller.serial_port.printf("Error: can't listen on port %u; retrying every %lu s",
+                                                unsigned(port), (unsigned long)(LISTEN_RETRY_MS / 1000));
+}
+
+void RemoteConsole::set_monitor(string_view args) {
+    if (is_disabled(true)) return;
+
+    if (!running) {
+        controller.serial_port.print("Error: monitor applies to a remote session; run it from one");
+        return;
+    }
+    std::string mode = to_lower(std::string(args));
+    if (mode != "on" && mode != "off") {
+        controller.serial_port.print("Error: expected 'on' or 'off'");
+        return;
+    }
+    running->monitor = (mode == "on");
+    controller.serial_port.printf("Monitor %s for this session", running->monitor ? "on" : "off");
+}
+
+void RemoteConsole::list_sessions() const {
+    if (is_disabled(true)) return;
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"#", "Client", "Open s", "Idle s", "Cmds", "Monitor"});
+    vector<string> string_storage;
+    string_storage.reserve(MAX_SESSIONS * 5);
+    const uint32_t now = millis();
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        const Session& s = sessions[i];
+        if (s.fd < 0) continue;
+        string_storage.push_back(std::to_string(i));
+        string_view index_view = string_storage.back();
+        string_storage.push_back(address(s.ip) + (&s == running ? " (you)" : ""));
+        string_view client_view = string_storage.back();
+        string_storage.push_back(std::to_string((now - s.opened_ms) / 1000));
+        string_view open_view = string_storage.back();
+        string_storage.push_back(std::to_string((now - s.last_input_ms) / 1000));
+        string_view idle_view = string_storage.back();
+        string_storage.push_back(std::to_string(s.commands));
+        string_view commands_view = string_storage.back();
+        table_data.push_back({index_view, client_view, open_view, idle_view, commands_view, s.monitor ? "on" : "off"});
+    }
+    if (table_data.size() == 1) {
+        controller.serial_port.printf("No remote sessions; connect with: telnet %s %u",
+                                      controller.wifi.get_local_ip().c_str(), unsigned(port));
+        return;
+    }
+    controller.serial_port.print_table(table_data, "Remote Console Sessions");
+}
@@ -0,0 +1,100 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/RemoteConsole/RemoteConsole.h
+#pragma once
+
+// The serial CLI over plain TCP: `telnet <device>` or `nc <device> 23`. Each session
+// has its own line buffer and its own output: what a command prints while a session
+// runs it goes back to that session only. Sessions that turned on `monitor` also get
+// everything else the console prints (logs, serial and button commands).
+//
+// Sockets are non-blocking and polled from loop(); a session runs at most one line
+// per pass, so a pasted script can't hold up Buttons or the serial port. Both buffers
+// are bounded: an over-long input line is refused, and output a slow client can't
+// keep up with is dropped and reported rather than queued without limit.
+
+#include "../../Module/Module.h"
+
+#include <array>
+#include <string>
+
+struct RemoteConsoleConfig : public ModuleConfig {};
+
+
+class RemoteConsole : public Module {
+public:
+    static constexpr uint16_t   DEFAULT_PORT                = 23;
+    static constexpr uint8_t    MAX_SESSIONS                = 2;    // lwIP has 10 sockets; HttpServer holds 7
+    static constexpr size_t     LINE_BYTES                  = 256;  // longest command line
+    static constexpr size_t     OUTPUT_BYTES                = 8192; // unsent output kept per session
+    static constexpr uint32_t   IDLE_TIMEOUT_MS             = 600000;
+
+    explicit                    RemoteConsole               (SystemController& controller);
+
+    void                        begin_routines_common       (const ModuleConfig& cfg)       override;
+    void                        loop                        ()                              override;
+    void                        disable                     (const bool verbose=false,
+                                                             const bool do_restart=true)    override;
+
+    string                      status                      (const bool verbose=false)      const override;
+    void                        status_json                 (xewe::json::Writer& out)       const override;
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
+
+private:
+    // telnet option negotiation is skipped, not answered; raw TCP clients never send it
+    enum class TelnetState : uint8_t { DATA, IAC, OPTION, SUBNEG, SUBNEG_IAC };
+
+    struct Session {
+        int                     fd                          {-1};
+        uint32_t                ip                          {0};
+        uint32_t                opened_ms                   {0};
+        uint32_t                last_input_ms               {0};
+        std::string             line;
+        std::string             pending;                                // read past the line waiting to run
+        bool                    line_ready                  {false};
+        bool                    line_overflow               {false};    // rest of the line is discarded
+        bool                    skip_lf                     {false};    // CR seen, swallow the LF after it
+        TelnetState             telnet                      {TelnetState::DATA};
+        std::string             out;
+        size_t                  out_sent                    {0};
+        size_t                  dropped                     {0};        // output bytes not kept since last prompt
+        bool                    monitor                     {false};
+        bool                    closing                     {false};    // flush what's queued, then close
+        uint32_t                commands                    {0};
+    };
+
+    std::array<Session, MAX_SESSIONS> sessions;
+    int                         listen_fd                   {-1};
+    uint16_t                    port                        {DEFAULT_PORT};
+    Session*                    running                     {nullptr};  // session whose command is executing
+    uint32_t                    listen_attempt_ms           {0};
+    uint32_t                    accepted                    {0};
+    uint32_t                    rejected                    {0};        // all sessions busy
+    uint32_t                    commands_run                {0};
+    uint32_t                    output_dropped              {0};        // bytes
+
+    bool                        listen                      ();
+    void                        stop                        ();
+    void                        accept_sessions             ();
+    void                        read_input                  (Session& s);
+    void                        take_byte                   (Session& s,
+                                                             uint8_t byte);
+    void                        run_line                    (Session& s);
+    void                        queue                       (Session& s,
+                                                             string_view text);
+    void                        prompt                      (Session& s);
+    bool                        flush                       (Session& s);
+    void                        close                       (Session& s);
+    static std::string          address                     (uint32_t ip);
+
+    void                        set_port                    (string_view args);
+    void                        set_monitor                 (string_view args);
+    void                        list_sessions               ()                              const;
+};
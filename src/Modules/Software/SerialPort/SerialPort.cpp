@@ -83,12 +83,12 @@ void SerialPort::print(std::string_view message,
             const bool is_last = (i + 1 == lines_sv.size()) && (j + 1 == chunks.size());
             std::string out = compose_box_line(chunks[j], edge_character,
                                                message_width, margin_l, margin_r, text_align);
-            Serial.write(reinterpret_cast<const uint8_t*>(out.data()), out.size());
+            write_out(out);
             if (is_last) {
                 if (!end.empty())
-                    Serial.write(reinterpret_cast<const uint8_t*>(end.data()), end.size());
+                    write_out(end);
             } else {
-                Serial.write(reinterpret_cast<const uint8_t*>(kCRLF), 2);
+                write_out(kCRLF);
             }
         }
     }
@@ -509,7 +509,33 @@ string SerialPort::read_line() {
     return out;
 }
 
+void SerialPort::add_output_sink(output_sink_t sink) {
+    output_sinks.push_back(std::move(sink));
+}
+
+void SerialPort::begin_capture(string& out, const size_t max_bytes) {
+    capture_out       = &out;
+    capture_limit     = max_bytes;
+    capture_truncated = false;
+}
+
+bool SerialPort::end_capture() {
+    capture_out = nullptr;
+    return !capture_truncated;
+}
+
 // private
+void SerialPort::write_out(string_view text) {
+    Serial.write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    for (const auto& sink : output_sinks) sink(text);
+
+    if (capture_out) {
+        const size_t room = capture_limit > capture_out->size() ? capture_limit - capture_out->size() : 0;
+        if (text.size() > room) capture_truncated = true;
+        capture_out->append(text.substr(0, room));
+    }
+}
+
 void SerialPort::flush_input() {
     while (Serial.available()) {
         (void)Serial.read();
@@ -521,12 +547,12 @@ void SerialPort::flush_input() {
 }
 
 void SerialPort::print_raw(string_view message) {
-    Serial.write(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    write_out(message);
 }
 
 void SerialPort::println_raw(string_view message) {
-    Serial.write(reinterpret_cast<const uint8_t*>(message.data()), message.size());
-    Serial.write(reinterpret_cast<const uint8_t*>(kCRLF), 2);
+    write_out(message);
+    write_out(kCRLF);
 }
 
 void SerialPort::printf_raw(const char* fmt, ...) {
@@ -542,7 +568,7 @@ void SerialPort::printf_raw(const char* fmt, ...) {
     }
     if (!has_spec) {
         size_t n = strlen(fmt);
-        if (n) Serial.write(reinterpret_cast<const uint8_t*>(fmt), n);
+        if (n) write_out(string_view(fmt, n));
         return;
     }
 
@@ -559,7 +585,7 @@ void SerialPort::printf_raw(const char* fmt, ...) {
     vsnprintf(buf.data(), buf.size(), fmt, ap2);
     va_end(ap2);
 
-    Serial.write(reinterpret_cast<const uint8_t*>(buf.data()), static_cast<size_t>(needed));
+    write_out(string_view(buf.data(), static_cast<size_t>(needed)));
 }
 
 bool SerialPort::read_line_with_timeout(string& out,
@@ -579,8 +605,8 @@ bool SerialPort::read_line_with_timeout(string& out,
 }
 
 void SerialPort::write_line_crlf(string_view s) {
-    Serial.write(reinterpret_cast<const uint8_t*>(s.data()), s.size());
-    Serial.write(reinterpret_cast<const uint8_t*>(kCRLF), 2);
+    write_out(s);
+    write_out(kCRLF);
 }
 
 template <typename T>
@@ -22,6 +22,8 @@ struct SerialPortConfig : public ModuleConfig {
 
 class SerialPort : public Module {
 public:
+    using output_sink_t         = function<void(string_view text)>;
+
     explicit                    SerialPort                  (SystemController& controller);
 
     void                        begin_routines_required     (const ModuleConfig&    cfg)                    override;
@@ -132,7 +134,17 @@ public:
     bool                        has_line                    ()                                              const;
     string                      read_line                   ();
 
+    // every printed byte is also handed to each sink, e.g. to mirror output to the web console
+    void                        add_output_sink             (output_sink_t          sink);
+
+    // while capturing, printed text is also collected into `out` (up to max_bytes);
+    // end_capture() returns false if some of it had to be cut off
+    void                        begin_capture               (string&                out,
+                                                             const size_t           max_bytes               = 4096);
+    bool                        end_capture                 ();
+
 private:
+    void                        write_out                   (string_view text);
     void                        flush_input                 ();
     void                        print_raw                   (string_view message);
     void                        println_raw                 (string_view message);
@@ -169,6 +181,10 @@ private:
     bool                        line_ready                  = false;
     static constexpr size_t     INPUT_BUFFER_SIZE           = 255;
     char                        input_buffer                [INPUT_BUFFER_SIZE];
+    vector<output_sink_t>       output_sinks;
+    string*                     capture_out                 = nullptr;
+    size_t                      capture_limit               = 0;
+    bool                        capture_truncated           = false;
 };
 
 
@@ -0,0 +1,267 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/System/FirmwareUpdate.cpp
+
+#include "FirmwareUpdate.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+#ifdef CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE
+// The Arduino core confirms a new image as soon as it boots unless this says
+// otherwise; confirm() does it once setup has actually completed.
+extern "C" bool verifyRollbackLater() { return true; }
+#endif
+
+namespace {
+
+esp_timer_handle_t verify_timer = nullptr;
+
+// the image never made it through setup: go back to the one that did
+void verify_timeout(void*) {
+#ifdef CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+#endif
+}
+
+bool parse_digest(std::string_view hex, uint8_t (&out)[32]) {
+    if (hex.size() != 64) return false;
+    for (size_t i = 0; i < 32; ++i) {
+        uint8_t byte = 0;
+        for (size_t k = 0; k < 2; ++k) {
+            const char c = hex[i * 2 + k];
+            uint8_t nibble;
+            if      (c >= '0' && c <= '9') nibble = c - '0';
+            else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+            else return false;
+            byte = static_cast<uint8_t>((byte << 4) | nibble);
+        }
+        out[i] = byte;
+    }
+    return true;
+}
+
+} // namespace
+
+FirmwareUpdate::~FirmwareUpdate() {
+    if (current_state == State::RECEIVING) abort("destroyed");
+}
+
+bool FirmwareUpdate::begin(size_t total, uint32_t image_offset, std::string_view sha256_hex) {
+    if (current_state == State::RECEIVING) return fail("an update is already in progress");
+
+    last_error.clear();
+    received_bytes = 0;
+    page_fill      = 0;
+    total_bytes    = total;
+
+    if (!parse_digest(sha256_hex, expected_digest)) return fail("sha256 must be 64 hex digits");
+    if (image_offset != 0 && image_offset != APP_OFFSET) return fail("offset must be 0 (merged image) or 0x10000 (app image)");
+    skip_bytes = APP_OFFSET - image_offset;
+    if (total && total <= skip_bytes) return fail("image is too small");
+
+    target = esp_ota_get_next_update_partition(nullptr);
+    if (!target) return fail("no OTA partition; flash an OTA partition scheme over USB first");
+    const size_t image_bytes = total ? total - skip_bytes : 0;
+    if (image_bytes > target->size) return fail("image does not fit the OTA partition");
+
+#ifdef OTA_WITH_SEQUENTIAL_WRITES
+    const size_t erase = image_bytes ? image_bytes : OTA_WITH_SEQUENTIAL_WRITES;   // erase as we go
+#else
+    const size_t erase = image_bytes ? image_bytes : OTA_SIZE_UNKNOWN;
+#endif
+    const esp_err_t err = esp_ota_begin(target, erase, &handle);
+    if (err != ESP_OK) return fail(std::string("esp_ota_begin: ") + esp_err_to_name(err));
+
+    page.reset(new (std::nothrow) uint8_t[PAGE_BYTES]);
+    if (!page) {
+        esp_ota_abort(handle);
+        return fail("out of memory");
+    }
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    current_state = State::RECEIVING;
+    return true;
+}
+
+bool FirmwareUpdate::write(std::string_view data) {
+    if (current_state != State::RECEIVING) return false;
+    if (total_bytes && received_bytes + data.size() > total_bytes) {
+        abort("more data than announced");
+        return false;
+    }
+    mbedtls_sha256_update(&sha, reinterpret_cast<const unsigned char*>(data.data()), data.size());
+
+    // bytes ahead of the app in a merged image are hashed only
+    if (received_bytes < skip_bytes) {
+        const size_t skip = std::min<size_t>(skip_bytes - received_bytes, data.size());
+        received_bytes += skip;
+        data.remove_prefix(skip);
+    }
+    received_bytes += data.size();
+
+    while (!data.empty()) {
+        const size_t take = std::min(PAGE_BYTES - page_fill, data.size());
+        std::memcpy(page.get() + page_fill, data.data(), take);
+        page_fill += take;
+        data.remove_prefix(take);
+        if (page_fill == PAGE_BYTES && !flush_page()) return false;
+    }
+    return true;
+}
+
+bool FirmwareUpdate::finish() {
+    if (current_state != State::RECEIVING) return false;
+    if (total_bytes && received_bytes != total_bytes) {
+        abort("upload ended early");
+        return false;
+    }
+    if (received_bytes <= skip_bytes) {
+        abort("image is too small");
+        return false;
+    }
+    if (page_fill && !flush_page()) return false;
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    if (std::memcmp(digest, expected_digest, sizeof(digest)) != 0) {
+        abort("SHA-256 mismatch");
+        return false;
+    }
+
+    // esp_ota_end checks the image header, segments and the image's own checksum
+    esp_err_t err = esp_ota_end(handle);
+    if (err == ESP_OK) err = esp_ota_set_boot_partition(target);
+    mbedtls_sha256_free(&sha);
+    page.reset();
+    if (err != ESP_OK) {
+        current_state = State::FAILED;
+        return fail(std::string("image rejected: ") + esp_err_to_name(err));
+    }
+    current_state = State::READY;
+    return true;
+}
+
+void FirmwareUpdate::abort(const char* reason) {
+    if (current_state == State::RECEIVING) {
+        esp_ota_abort(handle);
+        mbedtls_sha256_free(&sha);
+    }
+    page.reset();
+    current_state = State::FAILED;
+    last_error    = reason;
+}
+
+uint8_t FirmwareUpdate::percent() const {
+    if (current_state == State::READY) return 100;
+    if (!total_bytes) return 0;
+    return static_cast<uint8_t>(static_cast<uint64_t>(received_bytes) * 100 / total_bytes);
+}
+
+const char* FirmwareUpdate::target_label() const {
+    if (target) return target->label;
+    const esp_partition_t* next = esp_ota_get_next_update_partition(nullptr);
+    return next ? next->label : "none";
+}
+
+bool FirmwareUpdate::fail(std::string reason) {
+    if (current_state != State::RECEIVING) current_state = State::FAILED;
+    last_error = std::move(reason);
+    return false;
+}
+
+bool FirmwareUpdate::flush_page() {
+    const esp_err_t err = esp_ota_write(handle, page.get(), page_fill);
+    if (err != ESP_OK) {
+        abort(esp_err_to_name(err));
+        return false;
+    }
+    page_fill = 0;
+    return true;
+}
+
+// ---------- Boot side ----------
+
+bool FirmwareUpdate::pending_verify() {
+    esp_ota_img_states_t img_state;
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    return running && esp_ota_get_state_partition(running, &img_state) == ESP_OK
+           && img_state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+// Called early in boot. A crash before confirm() already rolls back (the bootloader
+// sees the image still pending); the timer covers setup that hangs instead.
+void FirmwareUpdate::arm_rollback() {
+    if (!pending_verify() || verify_timer) return;
+    const esp_timer_create_args_t args = {
+        .callback = &verify_timeout,
+        .arg      = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name     = "ota_verify",
+        .skip_unhandled_events = false,
+    };
+    if (esp_timer_create(&args, &verify_timer) == ESP_OK) {
+        esp_timer_start_once(verify_timer, static_cast<uint64_t>(VERIFY_TIMEOUT_MS) * 1000ULL);
+    }
+}
+
+bool FirmwareUpdate::confirm() {
+    if (verify_timer) {
+        esp_timer_stop(verify_timer);
+        esp_timer_delete(verify_timer);
+        verify_timer = nullptr;
+    }
+    if (!pending_verify()) return false;
+    return esp_ota_mark_app_valid_cancel_rollback() == ESP_OK;
+}
+
+// Boots the other OTA slot if it holds a valid image; only returns on failure.
+bool FirmwareUpdate::rollback() {
+    const esp_partition_t* other = esp_ota_get_next_update_partition(nullptr);
+    esp_app_desc_t desc;
+    if (!other || esp_ota_get_partition_description(other, &desc) != ESP_OK) return false;
+#ifdef CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE
+    if (esp_ota_check_rollback_is_possible()) esp_ota_mark_app_invalid_rollback_and_reboot();
+#endif
+    if (esp_ota_set_boot_partition(other) != ESP_OK) return false;          // validates the image first
+    esp_restart();
+    return true;
+}
+
+const char* FirmwareUpdate::state_name(State state) {
+    switch (state) {
+        case State::IDLE:      return "idle";
+        case State::RECEIVING: return "receiving";
+        case State::READY:     return "ready";
+        case State::FAILED:    return "failed";
+    }
+    return "unknown";
+}
+
+// matches chipFamily in the release manifests
+const char* FirmwareUpdate::chip_family() {
+#if CONFIG_IDF_TARGET_ESP32S3
+    return "ESP32-S3";
+#elif CONFIG_IDF_TARGET_ESP32S2
+    return "ESP32-S2";
+#elif CONFIG_IDF_TARGET_ESP32C3
+    return "ESP32-C3";
+#elif CONFIG_IDF_TARGET_ESP32C6
+    return "ESP32-C6";
+#elif CONFIG_IDF_TARGET_ESP32H2
+    return "ESP32-H2";
+#else
+    return "ESP32";
+#endif
+}
@@ -0,0 +1,90 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/System/FirmwareUpdate.h
+#pragma once
+
+// Writes a firmware image into the inactive OTA partition as it streams in. The
+// image is never held in RAM: bytes are collected into one flash sector and written
+// sector by sector. The SHA-256 of everything received is checked against the
+// release manifest before the boot partition is switched.
+//
+// The upload may be the app image itself, or the merged image from a release (see
+// build/scripts/compile.sh): its manifest part sits at offset 0 and carries the
+// bootloader and partition table ahead of the app. Those leading bytes are hashed
+// but not written.
+//
+// A freshly booted image stays on probation until confirm(); if it crashes, or
+// doesn't confirm within the verify window, the bootloader goes back to the
+// previous one.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+
+
+class FirmwareUpdate {
+public:
+    static constexpr size_t     PAGE_BYTES                  = 4096;     // one flash sector per write
+    static constexpr uint32_t   APP_OFFSET                  = 0x10000;  // app position in a merged image
+    static constexpr uint32_t   VERIFY_TIMEOUT_MS           = 120000;   // a new image must confirm within this
+
+    enum class State : uint8_t { IDLE, RECEIVING, READY, FAILED };
+
+                                FirmwareUpdate              () = default;
+                                ~FirmwareUpdate             ();
+                                FirmwareUpdate              (const FirmwareUpdate&)         = delete;
+    FirmwareUpdate&             operator=                   (const FirmwareUpdate&)         = delete;
+
+    // total_bytes is the upload size (0 if unknown), image_offset the manifest part
+    // offset (0 for a merged image, APP_OFFSET for an app image), sha256_hex the
+    // digest of the whole upload
+    bool                        begin                       (size_t total_bytes,
+                                                             uint32_t image_offset,
+                                                             std::string_view sha256_hex);
+    bool                        write                       (std::string_view data);
+    // verifies size, digest and image, then makes it the boot partition
+    bool                        finish                      ();
+    void                        abort                       (const char* reason);
+
+    State                       state                       ()                              const { return current_state; }
+    size_t                      received                    ()                              const { return received_bytes; }
+    size_t                      total                       ()                              const { return total_bytes; }
+    uint8_t                     percent                     ()                              const;
+    const std::string&          error                       ()                              const { return last_error; }
+    const char*                 target_label                ()                              const;
+
+    // boot side
+    static bool                 pending_verify              ();
+    static void                 arm_rollback                ();
+    static bool                 confirm                     ();
+    static bool                 rollback                    ();
+    static const char*          state_name                  (State state);
+    static const char*          chip_family                 ();
+
+private:
+    bool                        fail                        (std::string reason);
+    bool                        flush_page                  ();
+
+    State                       current_state               {State::IDLE};
+    const esp_partition_t*      target                      {nullptr};
+    esp_ota_handle_t            handle                      {0};
+    mbedtls_sha256_context      sha;
+    uint8_t                     expected_digest             [32] {};
+    std::unique_ptr<uint8_t[]>  page;                                   // only allocated while receiving
+    size_t                      page_fill                   {0};
+    size_t                      total_bytes                 {0};
+    size_t                      received_bytes              {0};
+    uint32_t                    skip_bytes                  {0};
+    std::string                 last_error;
+};
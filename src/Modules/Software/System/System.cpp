@@ -92,6 +92,21 @@ System::System(SystemController& controller)
       }
     });
 
+    commands_storage.push_back({
+      "firmware","Running and update partitions, and the state of the last OTA update",
+      string("$")+lower(module_name)+" firmware",0,
+      [this](string_view){ firmware_info(); }
+    });
+
+    commands_storage.push_back({
+      "rollback","Boot the firmware in the other OTA partition",
+      string("$")+lower(module_name)+" rollback",0,
+      [this](string_view){
+        this->controller.serial_port.print_header("Rolling back firmware");
+        if (!FirmwareUpdate::rollback()) this->controller.serial_port.print("Error: the other partition holds no valid firmware");
+      }
+    });
+
     commands_storage.push_back({
       "stack","Current task stack watermark (words)",
       string("$")+lower(module_name)+" stack",0,
@@ -108,6 +123,35 @@ void System::begin_routines_required (const ModuleConfig& cfg) {
         "Version " + TO_STRING(BUILD_VERSION) + "\n" +
         "Build Timestamp " + TO_STRING(BUILD_TIMESTAMP)
     );
+
+    if (FirmwareUpdate::pending_verify()) {
+        FirmwareUpdate::arm_rollback();
+        controller.serial_port.printf("New firmware; rolling back unless setup completes within %lu s",
+                                      (unsigned long)(FirmwareUpdate::VERIFY_TIMEOUT_MS / 1000));
+    }
+}
+
+void System::confirm_boot () {
+    if (FirmwareUpdate::confirm()) controller.serial_port.print("New firmware confirmed");
+}
+
+void System::firmware_info () const {
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    const FirmwareUpdate&  update  = firmware_update;
+
+    string s;
+    s += "Version "; s += TO_STRING(BUILD_VERSION); s += " ("; s += FirmwareUpdate::chip_family(); s += ")\n";
+    s += "Running "; s += running ? running->label : "?";
+    s += FirmwareUpdate::pending_verify() ? " (pending verification)\n" : "\n";
+    s += "Update target "; s += update.target_label(); s += "\n";
+    s += "Last update "; s += FirmwareUpdate::state_name(update.state());
+    if (update.state() == FirmwareUpdate::State::RECEIVING) {
+        s += " "; s += to_string((unsigned)update.received());
+        if (update.total()) { s += " / "; s += to_string((unsigned)update.total()); }
+        s += " bytes";
+    }
+    if (!update.error().empty()) { s += ": "; s += update.error(); }
+    controller.serial_port.print(s.c_str(), kCRLF);
 }
 
 void System::reset (const bool verbose, const bool do_restart, const bool keep_enabled) {
@@ -160,6 +204,47 @@ string System::status(const bool verbose) const {
     return "System OK";
 }
 
+void System::status_json(xewe::json::Writer& out) const {
+    out.field("device_name", controller.nvs.read_str(nvs_key, "dname"));
+    out.field("version", TO_STRING(BUILD_VERSION));
+    out.field("build", TO_STRING(BUILD_TIMESTAMP));
+    out.field("uptime_ms", millis());
+    out.field("free_heap", ESP.getFreeHeap());
+    out.field("min_free_heap", ESP.getMinFreeHeap());
+    out.field("heap_size", ESP.getHeapSize());
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    out.field("partition", running ? running->label : nullptr);
+    out.field("firmware_pending", FirmwareUpdate::pending_verify());
+}
+
+// system-wide gauges plus the per-module loop timing kept by SystemController
+void System::write_metrics(xewe::metrics::Writer& out) const {
+    out.gauge("uptime_seconds", "Time since boot.", millis() / 1000U);
+    out.gauge("heap_free_bytes", "Free heap.", ESP.getFreeHeap());
+    out.gauge("heap_min_free_bytes", "Lowest free heap since boot.", ESP.getMinFreeHeap());
+    out.gauge("heap_size_bytes", "Total heap.", ESP.getHeapSize());
+    out.counter("loop_iterations_total", "Main loop passes.", controller.get_loop_iterations());
+    out.gauge("loop_rate_hz", "Main loop passes over the last second.", controller.get_loop_rate());
+
+    const auto& modules = controller.get_modules();
+    out.family("module_enabled", "gauge", "1 if the module is enabled.");
+    for (const Module* m : modules) {
+        if (m) out.sample("module_enabled", "module", m->get_module_name(), m->is_enabled() ? 1U : 0U);
+    }
+    out.family("module_loop_calls_total", "counter", "Calls to the module's loop().");
+    for (size_t i = 0; i < modules.size(); ++i) {
+        if (modules[i]) out.sample("module_loop_calls_total", "module", modules[i]->get_module_name(), controller.get_loop_stats(i).calls);
+    }
+    out.family("module_loop_seconds_total", "counter", "Time spent in the module's loop().");
+    for (size_t i = 0; i < modules.size(); ++i) {
+        if (modules[i]) out.sample("module_loop_seconds_total", "module", modules[i]->get_module_name(), controller.get_loop_stats(i).total_us / 1e6);
+    }
+    out.family("module_loop_max_seconds", "gauge", "Longest single loop() call since boot.");
+    for (size_t i = 0; i < modules.size(); ++i) {
+        if (modules[i]) out.sample("module_loop_max_seconds", "module", modules[i]->get_module_name(), controller.get_loop_stats(i).max_us / 1e6);
+    }
+}
+
 string System::get_device_name () { return controller.nvs.read_str(nvs_key, "dname"); };
 
 void System::restart (uint16_t delay_ms) {
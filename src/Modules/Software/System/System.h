@@ -13,6 +13,7 @@
 #include "../../Module/Module.h"
 
 #include "../../../build_info.h"
+#include "FirmwareUpdate.h"
 
 #include <esp_system.h>
 #include <esp_chip_info.h>
@@ -32,8 +33,19 @@ public:
                                                              const bool do_restart=true,
                                                              const bool keep_enabled=true)    override;
     string                      status                      (const bool verbose=false)      const override;
+    void                        status_json                 (xewe::json::Writer& out)       const override;
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
 
     std::string                 get_device_name             ();
     void                        restart                     (uint16_t delay_ms=3000);
+
+    FirmwareUpdate&             get_firmware_update         ()                              { return firmware_update; }
+    // called once setup has completed; keeps a freshly updated image
+    void                        confirm_boot                ();
+
+private:
+    void                        firmware_info               ()                              const;
+
+    FirmwareUpdate              firmware_update;
 };
 
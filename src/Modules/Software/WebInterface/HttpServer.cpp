@@ -0,0 +1,1305 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/WebInterface/HttpServer.cpp
+
+#include "HttpServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace {
+
+#ifdef ARDUINO
+inline uint32_t now_ms() { return millis(); }
+inline uint32_t now_us() { return micros(); }
+#else
+inline uint32_t now_ms() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+inline uint32_t now_us() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool set_nonblocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const char x = (a[i] >= 'A' && a[i] <= 'Z') ? a[i] + 32 : a[i];
+        const char y = (b[i] >= 'A' && b[i] <= 'Z') ? b[i] + 32 : b[i];
+        if (x != y) return false;
+    }
+    return true;
+}
+
+bool icontains(std::string_view haystack, std::string_view needle) {
+    if (needle.size() > haystack.size()) return false;
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, needle.size()), needle)) return true;
+    }
+    return false;
+}
+
+std::string_view trim_view(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back()  == ' ' || s.back()  == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+const std::string kEmpty;
+
+// SHA-1 and Base64 exist here only for the WebSocket handshake (RFC 6455 section 4.2.2)
+std::array<uint8_t, 20> sha1(std::string_view data) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    auto rol = [](uint32_t v, int bits) { return (v << bits) | (v >> (32 - bits)); };
+
+    std::string msg(data);
+    const uint64_t length_bits = static_cast<uint64_t>(data.size()) * 8;
+    msg.push_back(static_cast<char>(0x80));
+    while (msg.size() % 64 != 56) msg.push_back('\0');
+    for (int i = 7; i >= 0; --i) msg.push_back(static_cast<char>(length_bits >> (i * 8)));
+
+    for (size_t block = 0; block < msg.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* b = reinterpret_cast<const uint8_t*>(msg.data() + block + i * 4);
+            w[i] = (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | b[3];
+        }
+        for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if      (i < 20) { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            const uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (int i = 0; i < 20; ++i) digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+    return digest;
+}
+
+std::string base64(const uint8_t* data, size_t len) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        const uint32_t n = (uint32_t(data[i]) << 16)
+                         | (i + 1 < len ? uint32_t(data[i + 1]) << 8 : 0)
+                         | (i + 2 < len ? uint32_t(data[i + 2]) : 0);
+        out.push_back(table[(n >> 18) & 63]);
+        out.push_back(table[(n >> 12) & 63]);
+        out.push_back(i + 1 < len ? table[(n >> 6) & 63] : '=');
+        out.push_back(i + 2 < len ? table[n & 63] : '=');
+    }
+    return out;
+}
+
+enum WsOpcode : uint8_t { WS_CONTINUATION = 0x0, WS_TEXT = 0x1, WS_BINARY = 0x2, WS_CLOSE = 0x8, WS_PING = 0x9, WS_PONG = 0xA };
+
+} // namespace
+
+
+HttpServer::HttpServer(uint16_t port)
+      : port(port)
+{
+    unmatched.label = "(no route)";
+}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+void HttpServer::on(const char* uri, handler_t handler) {
+    on(uri, HTTP_ANY, std::move(handler));
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, handler_t handler) {
+    on(uri, method, std::move(handler), {});
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, handler_t handler, handler_t upload_handler) {
+    routes.push_back({uri, method, std::move(handler), std::move(upload_handler)});
+    per_route.emplace_back();
+    per_route.back().label = std::string(method_name(method)) + ' ' + uri;
+}
+
+void HttpServer::reset_stats() {
+    auto clear = [](RouteStats& route) {
+        std::string label = std::move(route.label);
+        route       = RouteStats{};
+        route.label = std::move(label);
+    };
+    for (auto& route : per_route) clear(route);
+    clear(unmatched);
+    per_client.reset();
+}
+
+void HttpServer::onNotFound(handler_t handler) {
+    not_found_handler = std::move(handler);
+}
+
+void HttpServer::on_request(handler_t filter) {
+    request_filter = std::move(filter);
+}
+
+void HttpServer::on_websocket(const char* uri, ws_message_handler_t on_message, ws_event_handler_t on_event) {
+    ws_routes.push_back({uri, std::move(on_message), std::move(on_event)});
+}
+
+void HttpServer::on_event_stream(const char* uri, sse_connect_handler_t on_connect) {
+    sse_routes.push_back({uri, std::move(on_connect)});
+}
+
+bool HttpServer::begin() {
+    if (listen_fd >= 0) return true;
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || ::listen(fd, MAX_CONNECTIONS) < 0
+        || !set_nonblocking(fd)) {
+        ::close(fd);
+        return false;
+    }
+    listen_fd = fd;
+    return true;
+}
+
+void HttpServer::stop() {
+    for (auto& c : connections) {
+        if (c.state != ConnState::FREE) close(c);
+    }
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+}
+
+// One non-blocking pass: a zero-timeout select() finds readable sockets, then every
+// open connection advances its state machine as far as it can without waiting.
+void HttpServer::handleClient() {
+    if (listen_fd < 0) return;
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(listen_fd, &readable);
+    int max_fd = listen_fd;
+    for (const auto& c : connections) {
+        if (c.state == ConnState::FREE || c.state == ConnState::WRITE) continue;
+        FD_SET(c.fd, &readable);
+        if (c.fd > max_fd) max_fd = c.fd;
+    }
+    timeval no_wait {0, 0};
+    if (::select(max_fd + 1, &readable, nullptr, nullptr, &no_wait) < 0) return;
+
+    size_t buffered = 0;
+    for (auto& c : connections) {
+        if (c.state == ConnState::FREE) continue;
+        service(c, FD_ISSET(c.fd, &readable));
+        buffered += c.in.capacity() + c.request.body.capacity() + c.out_pending;
+    }
+    counters.peak_buffered = std::max(counters.peak_buffered, buffered);
+    if (FD_ISSET(listen_fd, &readable)) accept_clients();
+}
+
+void HttpServer::accept_clients() {
+    for (;;) {
+        sockaddr_in addr {};
+        socklen_t   addr_len = sizeof(addr);
+        const int fd = ::accept(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+        if (fd < 0) return;
+
+        Connection* slot = nullptr;
+        for (auto& c : connections) {
+            if (c.state == ConnState::FREE) { slot = &c; break; }
+        }
+        if (!slot) {
+            // answer instead of leaving the client hanging in the backlog
+            static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\n"
+                                       "Content-Length: 0\r\nRetry-After: 1\r\nConnection: close\r\n\r\n";
+            ::send(fd, busy, sizeof(busy) - 1, SEND_FLAGS | MSG_DONTWAIT);
+            ::close(fd);
+            counters.rejected++;
+            continue;
+        }
+
+        set_nonblocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        slot->fd                = fd;
+        slot->ip                = addr.sin_addr.s_addr;
+        sockaddr_in local {};
+        socklen_t   local_len = sizeof(local);
+        slot->local_ip          = ::getsockname(fd, reinterpret_cast<sockaddr*>(&local), &local_len) == 0
+                                  ? local.sin_addr.s_addr : 0;
+        slot->served            = 0;
+        slot->close_after_write = false;
+        slot->request           = Request{};
+        set_state(*slot, ConnState::READ_HEAD);
+        counters.accepted++;
+        counters.open++;
+        counters.peak_open = std::max(counters.peak_open, counters.open);
+    }
+}
+
+void HttpServer::service(Connection& c, bool readable) {
+    if (readable && !read_input(c)) {
+        close(c);
+        return;
+    }
+
+    if (c.state == ConnState::READ_HEAD && !c.in.empty()) {
+        const int status = parse_head(c);
+        if (status > 0) {
+            respond_error(c, status);
+        } else if (status == 0 && c.request.upload_route < 0) {
+            set_state(c, ConnState::READ_BODY);
+        } else if (status == 0) {
+            set_state(c, ConnState::READ_UPLOAD);
+            if (const auto* expect = find(c.request.headers, "Expect", true)) {
+                // best effort; a client that doesn't get it sends the body after a short wait anyway
+                static const char go_ahead[] = "HTTP/1.1 100 Continue\r\n\r\n";
+                if (icontains(expect->second, "100-continue")) ::send(c.fd, go_ahead, sizeof(go_ahead) - 1, SEND_FLAGS);
+            }
+            call_upload(c, UploadStatus::START);
+        }
+    }
+    if (c.state == ConnState::READ_UPLOAD) {
+        const int status = read_upload(c);
+        if (status > 0) {
+            call_upload(c, UploadStatus::ABORTED);
+            respond_error(c, status);
+        } else if (status == 0 && call_upload(c, UploadStatus::END)) {
+            dispatch(c);
+        }
+    }
+    if (c.state == ConnState::READ_BODY && c.in.size() >= c.request.content_length) {
+        c.request.body.assign(c.in, 0, c.request.content_length);
+        c.in.erase(0, c.request.content_length);
+        dispatch(c);
+    }
+    if (c.state == ConnState::WEBSOCKET || c.state == ConnState::EVENT_STREAM) {
+        service_push(c);
+        return;
+    }
+    if (c.state == ConnState::WRITE) {
+        if (!flush_output(c)) {
+            close(c);
+            return;
+        }
+        if (c.out_index == c.out.size()) finish_response(c);
+    }
+
+    // an idle keep-alive socket (or a preconnect that never sent anything) is cheap to drop;
+    // a request that started arriving gets the longer budget
+    if (c.state == ConnState::FREE) return;
+    const bool     idle  = c.state == ConnState::READ_HEAD && c.in.empty();
+    const uint32_t limit = idle ? KEEP_ALIVE_TIMEOUT_MS
+                         : c.state == ConnState::READ_UPLOAD ? UPLOAD_STALL_TIMEOUT_MS : REQUEST_TIMEOUT_MS;
+    if (now_ms() - c.state_since_ms >= limit) {
+        if (!idle) counters.timeouts++;
+        close(c);
+    }
+}
+
+bool HttpServer::read_input(Connection& c) {
+    char buf[1024];
+    while (c.in.size() < MAX_HEAD_BYTES + MAX_BODY_BYTES) {
+        const ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            c.in.append(buf, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof(buf)) break;
+            continue;
+        }
+        if (n == 0) return false;                                   // peer closed
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        return false;
+    }
+    return true;
+}
+
+// Returns -1 while the head is incomplete, 0 once it is parsed (and consumed from
+// the input buffer), or the HTTP status to fail the request with.
+int HttpServer::parse_head(Connection& c) {
+    const size_t end = c.in.find("\r\n\r\n");
+    if (end == std::string::npos || end + 4 > MAX_HEAD_BYTES) {
+        if (end == std::string::npos && c.in.size() <= MAX_HEAD_BYTES) return -1;
+        counters.oversize++;
+        return 431;
+    }
+
+    Request& r = c.request;
+    r = Request{};
+    const std::string_view head(c.in.data(), end);
+
+    // request line: METHOD SP target SP version
+    const size_t line_end = head.find("\r\n");
+    const std::string_view line = head.substr(0, line_end);
+    const size_t sp1 = line.find(' ');
+    const size_t sp2 = line.rfind(' ');
+    if (sp1 == std::string_view::npos || sp2 == sp1) return 400;
+    if (!method_from(line.substr(0, sp1), r.method)) return 501;
+
+    const std::string_view target  = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    const std::string_view version = line.substr(sp2 + 1);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") return 400;
+    r.http11     = (version == "HTTP/1.1");
+    r.keep_alive = r.http11;
+
+    const size_t q = target.find('?');
+    r.uri = url_decode(target.substr(0, q));
+    if (q != std::string_view::npos) parse_args(target.substr(q + 1), r.args);
+
+    size_t pos = (line_end == std::string_view::npos) ? head.size() : line_end + 2;
+    while (pos < head.size()) {
+        size_t eol = head.find("\r\n", pos);
+        if (eol == std::string_view::npos) eol = head.size();
+        const std::string_view h = head.substr(pos, eol - pos);
+        pos = eol + 2;
+
+        const size_t colon = h.find(':');
+        if (colon == std::string_view::npos) return 400;
+        if (r.headers.size() >= MAX_HEADERS) {
+            counters.oversize++;
+            return 431;
+        }
+        r.headers.emplace_back(std::string(trim_view(h.substr(0, colon))), std::string(trim_view(h.substr(colon + 1))));
+    }
+
+    if (const auto* h = find(r.headers, "Connection", true)) {
+        if (icontains(h->second, "close"))           r.keep_alive = false;
+        else if (icontains(h->second, "keep-alive")) r.keep_alive = true;
+    }
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (routes[i].upload_handler && routes[i].uri == r.uri && routes[i].method == r.method) {
+            r.upload_route = static_cast<int8_t>(i);
+            break;
+        }
+    }
+
+    // only upload routes take chunked bodies, and only they may exceed MAX_BODY_BYTES
+    if (const auto* h = find(r.headers, "Transfer-Encoding", true)) {
+        if (r.upload_route < 0 || !iequals(h->second, "chunked")) return 501;
+        r.chunked_body = true;
+    } else if (const auto* h = find(r.headers, "Content-Length", true)) {
+        char* tail = nullptr;
+        const unsigned long length = std::strtoul(h->second.c_str(), &tail, 10);
+        if (h->second.empty() || *tail != '\0') return 400;
+        if (length > MAX_BODY_BYTES && r.upload_route < 0) {
+            counters.oversize++;
+            return 413;
+        }
+        r.content_length = length;
+    }
+
+    c.in.erase(0, end + 4);
+    return 0;
+}
+
+// Hands whatever body bytes have arrived to the upload handler, undoing chunked
+// framing on the way. Returns -1 while more is expected, 0 once the body is
+// complete, or the HTTP status to fail the request with. Stops early if the
+// handler answers (and so rejects the upload).
+int HttpServer::read_upload(Connection& c) {
+    Request& r = c.request;
+    size_t pos = 0;
+    int status = -1;
+
+    while (status < 0 && c.state == ConnState::READ_UPLOAD) {
+        if (!r.chunked_body) {
+            const size_t take = std::min(r.content_length - r.received, c.in.size() - pos);
+            if (take > 0 && !call_upload(c, UploadStatus::WRITE, std::string_view(c.in).substr(pos, take))) break;
+            pos += take;
+            if (r.received == r.content_length) status = 0;
+            break;
+        }
+
+        if (r.chunk_phase == ChunkPhase::DATA) {
+            const size_t take = std::min(r.chunk_left, c.in.size() - pos);
+            if (take == 0) break;
+            if (!call_upload(c, UploadStatus::WRITE, std::string_view(c.in).substr(pos, take))) break;
+            pos          += take;
+            r.chunk_left -= take;
+            if (r.chunk_left == 0) r.chunk_phase = ChunkPhase::DATA_END;
+            continue;
+        }
+
+        // the rest of the framing is line based: chunk size, CRLF after data, trailers
+        const size_t eol = c.in.find("\r\n", pos);
+        if (eol == std::string::npos) {
+            if (c.in.size() - pos > 64) status = 400;                     // no sane framing line is that long
+            break;
+        }
+        const std::string_view line(c.in.data() + pos, eol - pos);
+        pos = eol + 2;
+
+        switch (r.chunk_phase) {
+            case ChunkPhase::SIZE: {
+                const std::string_view digits = trim_view(line.substr(0, line.find(';')));
+                char* tail = nullptr;
+                const std::string text(digits);
+                const unsigned long size = std::strtoul(text.c_str(), &tail, 16);
+                if (text.empty() || *tail != '\0') { status = 400; break; }
+                r.chunk_left  = size;
+                r.chunk_phase = size ? ChunkPhase::DATA : ChunkPhase::TRAILER;
+                break;
+            }
+            case ChunkPhase::DATA_END:
+                if (!line.empty()) { status = 400; break; }
+                r.chunk_phase = ChunkPhase::SIZE;
+                break;
+            case ChunkPhase::TRAILER:
+                if (line.empty()) status = 0;                               // trailers are ignored
+                break;
+            case ChunkPhase::DATA:
+                break;
+        }
+    }
+
+    if (pos > 0) {
+        c.in.erase(0, pos);
+        if (c.state == ConnState::READ_UPLOAD) c.state_since_ms = now_ms();   // progress resets the stall clock
+    }
+    return status;
+}
+
+// Runs the route's upload handler with the request as context. Returns false if
+// the handler answered, which ends the upload; the rest of the body is never read,
+// so the connection closes after that response.
+bool HttpServer::call_upload(Connection& c, UploadStatus status, std::string_view data) {
+    Request& r = c.request;
+    if (status == UploadStatus::WRITE) r.received += data.size();
+    upload_state.status   = status;
+    upload_state.data     = data;
+    upload_state.received = r.received;
+    upload_state.expected = r.chunked_body ? 0 : r.content_length;
+
+    const handler_t& handler = routes[r.upload_route].upload_handler;
+    if (status == UploadStatus::ABORTED) {
+        current = nullptr;                                              // nothing can be sent any more
+        handler();
+        upload_state.data = {};
+        return false;
+    }
+
+    current             = &c;
+    response_sent       = false;
+    c.close_after_write = status != UploadStatus::END;
+    response_headers.clear();
+    // the filter sees an upload before any of its body reaches the handler
+    if (status == UploadStatus::START && request_filter) request_filter();
+    if (!response_sent) handler();
+    current           = nullptr;
+    upload_state.data = {};
+    return !response_sent;
+}
+
+void HttpServer::dispatch(Connection& c) {
+    counters.requests++;
+    per_client.add(c.ip);
+    Request& r = c.request;
+    const uint32_t started_us = now_us();
+    const size_t   sent_before = c.sent;
+
+    if (request_filter) {
+        current         = &c;
+        response_sent   = false;
+        response_headers.clear();
+        request_filter();
+        current = nullptr;
+        if (response_sent) {
+            record(unmatched, c, c.sent - sent_before + c.out_pending, now_us() - started_us);
+            return;
+        }
+    }
+    if (upgrade_websocket(c) || open_event_stream(c)) return;
+
+    if (const auto* type = find(r.headers, "Content-Type", true)) {
+        if (icontains(type->second, "application/x-www-form-urlencoded")) parse_args(r.body, r.args);
+    }
+
+    current         = &c;
+    response_sent   = false;
+    response_headers.clear();
+
+    const Route* match = nullptr;
+    for (const auto& route : routes) {
+        if (route.uri != r.uri) continue;
+        if (route.method == HTTP_ANY || route.method == r.method
+            || (r.method == HTTP_HEAD && route.method == HTTP_GET)) {
+            match = &route;
+            break;
+        }
+    }
+    if (match)                  match->handler();
+    else if (not_found_handler) not_found_handler();
+    else                        send(404, "text/plain", "Not Found");
+
+    if (streaming)      end_stream();
+    if (!response_sent) send(500, "text/plain", "Handler sent no response");
+    current = nullptr;
+
+    // whatever left the socket during the handler plus what is still queued
+    record(match ? per_route[match - routes.data()] : unmatched, c,
+           c.sent - sent_before + c.out_pending, now_us() - started_us);
+}
+
+void HttpServer::record(RouteStats& route, const Connection& c, size_t bytes_out, uint32_t elapsed_us) {
+    route.requests++;
+    if (c.status >= 100 && c.status < 600) route.responses[c.status / 100 - 1]++;
+    route.bytes_in  += c.request.body.size() + c.request.received;
+    route.bytes_out += bytes_out;
+    route.total_us  += elapsed_us;
+    route.latency_us.add(static_cast<int32_t>(std::min<uint32_t>(elapsed_us, INT32_MAX)));
+}
+
+bool HttpServer::flush_output(Connection& c) {
+    while (c.out_index < c.out.size()) {
+        const Segment& s = c.out[c.out_index];
+        while (c.out_offset < s.len) {
+            const ssize_t n = ::send(c.fd, s.data + c.out_offset, s.len - c.out_offset, SEND_FLAGS);
+            if (n > 0) {
+                c.out_offset  += static_cast<size_t>(n);
+                c.out_pending -= static_cast<size_t>(n);
+                c.sent        += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;   // socket buffer full, resume later
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        c.out_index++;
+        c.out_offset = 0;
+    }
+    return true;
+}
+
+void HttpServer::finish_response(Connection& c) {
+    c.out.clear();
+    c.out_index   = 0;
+    c.out_offset  = 0;
+    c.out_pending = 0;
+    if (c.close_after_write) {
+        close(c);
+        return;
+    }
+    c.request = Request{};
+    set_state(c, ConnState::READ_HEAD);
+}
+
+void HttpServer::respond_error(Connection& c, int code) {
+    // the rest of the input can't be trusted to start at a request boundary
+    c.request           = Request{};
+    c.close_after_write = true;
+    response_headers.clear();
+    queue_response(c, code, "text/plain", owned_segment(reason_phrase(code)));
+}
+
+void HttpServer::queue_response(Connection& c, int code, const char* content_type, Segment body) {
+    std::string head = response_head(c, code, content_type, &body.len);
+
+    c.out.clear();
+    c.out_index   = 0;
+    c.out_offset  = 0;
+    c.out_pending = head.size();
+    c.out.push_back(owned_segment(std::move(head)));
+    if (c.request.method != HTTP_HEAD && body.len > 0) {
+        c.out_pending += body.len;
+        c.out.push_back(std::move(body));
+    }
+    set_state(c, ConnState::WRITE);
+}
+
+// content_length == nullptr means the body is streamed: chunked on HTTP/1.1,
+// delimited by closing the connection on HTTP/1.0.
+std::string HttpServer::response_head(Connection& c, int code, const char* content_type, const size_t* content_length) {
+    c.served++;
+    c.status = static_cast<uint16_t>(code);
+    if (code >= 100 && code < 600) counters.responses[code / 100 - 1]++;
+    c.chunked = !content_length && c.request.http11;
+    const bool keep_alive = c.request.keep_alive && !c.close_after_write && c.served < MAX_KEEP_ALIVE_REQUESTS
+                            && (content_length || c.chunked);
+    c.close_after_write = !keep_alive;
+
+    std::string head;
+    head.reserve(128);
+    head += "HTTP/1.1 ";
+    head += std::to_string(code);
+    head += ' ';
+    head += reason_phrase(code);
+    head += "\r\n";
+    if (content_type) {
+        head += "Content-Type: ";
+        head += content_type;
+        head += "\r\n";
+    }
+    if (c.chunked) {
+        head += "Transfer-Encoding: chunked\r\n";
+    } else if (content_length && code != 204 && code != 304) {     // bodiless by definition
+        head += "Content-Length: ";
+        head += std::to_string(*content_length);
+        head += "\r\n";
+    }
+    head += keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    for (const auto& h : response_headers) {
+        head += h.first;
+        head += ": ";
+        head += h.second;
+        head += "\r\n";
+    }
+    head += "\r\n";
+    response_headers.clear();
+    return head;
+}
+
+void HttpServer::set_state(Connection& c, ConnState state) {
+    c.state          = state;
+    c.state_since_ms = now_ms();
+}
+
+void HttpServer::close(Connection& c) {
+    const ConnState was = c.state;
+    if (was == ConnState::READ_UPLOAD) call_upload(c, UploadStatus::ABORTED);
+    if (c.fd >= 0) ::close(c.fd);
+    c.fd          = -1;
+    c.state       = ConnState::FREE;
+    c.request     = Request{};
+    c.out.clear();
+    c.out_pending = 0;
+    std::string().swap(c.in);                                       // give the buffer back to the heap
+    counters.open--;
+
+    if (was == ConnState::EVENT_STREAM) counters.sse_open--;
+    if (was == ConnState::WEBSOCKET) {
+        counters.ws_open--;
+        const auto& on_event = ws_routes[c.push_route].on_event;
+        if (on_event) on_event(client_id(c), false);
+    }
+}
+
+// ---------- Push connections (WebSocket, event stream) ----------
+
+void HttpServer::start_push(Connection& c, ConnState state, size_t route, std::string&& head) {
+    c.request          = Request{};
+    c.out.clear();
+    c.out_index        = 0;
+    c.out_offset       = 0;
+    c.out_pending      = head.size();
+    c.out.push_back(owned_segment(std::move(head)));
+    c.push_route       = static_cast<uint8_t>(route);
+    c.ws_opcode        = 0;
+    c.ws_awaiting_pong = false;
+    set_state(c, state);
+    c.ws_ping_ms       = c.state_since_ms;
+}
+
+// Called for every complete request; takes over the ones that ask to upgrade on a
+// WebSocket route. The connection then stays in WEBSOCKET until either side closes.
+bool HttpServer::upgrade_websocket(Connection& c) {
+    const Request& r = c.request;
+    const auto* upgrade = find(r.headers, "Upgrade", true);
+    if (!upgrade || !icontains(upgrade->second, "websocket")) return false;
+
+    size_t route = 0;
+    while (route < ws_routes.size() && ws_routes[route].uri != r.uri) ++route;
+    if (route == ws_routes.size()) return false;
+
+    const auto* key     = find(r.headers, "Sec-WebSocket-Key", true);
+    const auto* version = find(r.headers, "Sec-WebSocket-Version", true);
+    if (r.method != HTTP_GET || !key || !version || version->second != "13") {
+        respond_error(c, 400);
+        return true;
+    }
+    if (counters.ws_open + counters.sse_open >= MAX_PUSH_CLIENTS) {
+        respond_error(c, 503);
+        return true;
+    }
+
+    std::string head = "HTTP/1.1 101 Switching Protocols\r\n"
+                       "Upgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ";
+    head += ws_accept_key(key->second);
+    head += "\r\n\r\n";
+    start_push(c, ConnState::WEBSOCKET, route, std::move(head));
+    counters.ws_open++;
+
+    const auto& on_event = ws_routes[route].on_event;
+    if (on_event) on_event(client_id(c), true);
+    return true;
+}
+
+// GET on an event-stream route: answer with an open-ended text/event-stream body
+// (no length, no chunking; it ends when the connection does).
+bool HttpServer::open_event_stream(Connection& c) {
+    const Request& r = c.request;
+    if (r.method != HTTP_GET) return false;
+    size_t route = 0;
+    while (route < sse_routes.size() && sse_routes[route].uri != r.uri) ++route;
+    if (route == sse_routes.size()) return false;
+
+    if (counters.ws_open + counters.sse_open >= MAX_PUSH_CLIENTS) {
+        respond_error(c, 503);
+        return true;
+    }
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n"
+                       "retry: 3000\n\n";
+    start_push(c, ConnState::EVENT_STREAM, route, std::move(head));
+    counters.sse_open++;
+
+    const auto& on_connect = sse_routes[route].on_connect;
+    if (on_connect) on_connect(client_id(c));
+    return true;
+}
+
+// state_since_ms doubles as "last time the backlog was empty or drained": a client
+// whose backlog stops moving for PUSH_STALL_TIMEOUT_MS is dropped, as is a
+// WebSocket that leaves a ping unanswered for a whole interval.
+void HttpServer::service_push(Connection& c) {
+    const bool websocket = c.state == ConnState::WEBSOCKET;
+    if (websocket) {
+        while (c.state == ConnState::WEBSOCKET && !c.close_after_write) {
+            const int status = parse_frame(c);
+            if (status < 0) break;
+            if (status > 0) ws_close(c, static_cast<uint16_t>(status));
+        }
+        if (c.state != ConnState::WEBSOCKET) return;
+    } else {
+        c.in.clear();                                               // event-stream clients have nothing to say
+    }
+
+    const size_t before = c.out_pending;
+    if (!flush_output(c)) {
+        close(c);
+        return;
+    }
+    if (c.out_index == c.out.size()) {
+        c.out.clear();
+        c.out_index  = 0;
+        c.out_offset = 0;
+        if (c.close_after_write) {
+            close(c);
+            return;
+        }
+    }
+
+    const uint32_t now = now_ms();
+    if (c.out_pending == 0 || c.out_pending < before) c.state_since_ms = now;
+    if (now - c.state_since_ms >= PUSH_STALL_TIMEOUT_MS) {
+        counters.push_dropped++;
+        close(c);
+        return;
+    }
+    if (!websocket) {
+        if (now - c.ws_ping_ms >= SSE_KEEPALIVE_MS) {
+            static const char keepalive[] = ":\n\n";
+            Segment comment;
+            comment.data = keepalive;
+            comment.len  = sizeof(keepalive) - 1;
+            c.ws_ping_ms = now;
+            push_queue(c, comment);
+        }
+        return;
+    }
+    if (now - c.ws_ping_ms >= WS_PING_INTERVAL_MS) {
+        if (c.ws_awaiting_pong) {
+            counters.push_dropped++;
+            close(c);
+            return;
+        }
+        c.ws_ping_ms       = now;
+        c.ws_awaiting_pong = true;
+        push_queue(c, ws_frame(WS_PING, {}));
+    }
+}
+
+// Returns -1 while the next frame is incomplete, 0 after consuming one, or the
+// close status to end the session with.
+int HttpServer::parse_frame(Connection& c) {
+    if (c.in.size() < 2) return -1;
+    const auto* p = reinterpret_cast<const uint8_t*>(c.in.data());
+
+    const bool    fin    = p[0] & 0x80;
+    const uint8_t opcode = p[0] & 0x0F;
+    if (p[0] & 0x70)    return 1002;                                // no extensions were negotiated
+    if (!(p[1] & 0x80)) return 1002;                                // client frames must be masked
+
+    size_t length = p[1] & 0x7F;
+    size_t pos    = 2;
+    if (length == 126) {
+        if (c.in.size() < 4) return -1;
+        length = (size_t(p[2]) << 8) | p[3];
+        pos    = 4;
+    } else if (length == 127) {
+        return 1009;
+    }
+    if (length > WS_MAX_MESSAGE_BYTES) return 1009;
+    if (c.in.size() < pos + 4 + length) return -1;
+
+    const uint8_t* mask = p + pos;
+    pos += 4;
+    std::string payload(length, '\0');
+    for (size_t i = 0; i < length; ++i) payload[i] = static_cast<char>(p[pos + i] ^ mask[i & 3]);
+    c.in.erase(0, pos + length);
+    c.ws_awaiting_pong = false;                                     // any frame proves the peer is alive
+
+    if (opcode & 0x08) {
+        if (!fin || length > 125) return 1002;
+        switch (opcode) {
+            case WS_CLOSE: return 1000;
+            case WS_PING:  push_queue(c, ws_frame(WS_PONG, payload)); return 0;
+            case WS_PONG:  return 0;
+            default:       return 1002;
+        }
+    }
+
+    // data frames; fragments are reassembled in request.body
+    std::string& message = c.request.body;
+    if (opcode == WS_CONTINUATION) {
+        if (c.ws_opcode == 0) return 1002;
+    } else {
+        if (c.ws_opcode != 0) return 1002;
+        if (opcode != WS_TEXT && opcode != WS_BINARY) return 1002;
+        c.ws_opcode = opcode;
+        message.clear();
+    }
+    if (message.size() + length > WS_MAX_MESSAGE_BYTES) return 1009;
+    message += payload;
+    if (!fin) return 0;
+
+    const bool text = c.ws_opcode == WS_TEXT;
+    c.ws_opcode = 0;
+    std::string complete;
+    complete.swap(message);
+    const auto& on_message = ws_routes[c.push_route].on_message;
+    if (text && on_message) on_message(client_id(c), complete);
+    return 0;
+}
+
+// Appends a frame to the client's backlog; a client that is already too far behind
+// is closed instead, so one slow browser costs at most PUSH_MAX_PENDING_BYTES.
+bool HttpServer::push_queue(Connection& c, const Segment& frame) {
+    if (c.out_pending + frame.len > PUSH_MAX_PENDING_BYTES) {
+        counters.push_dropped++;
+        close(c);
+        return false;
+    }
+    if (c.out_pending == 0) c.state_since_ms = now_ms();            // the stall clock starts with the backlog
+    c.out.push_back(frame);
+    c.out_pending += frame.len;
+    return true;
+}
+
+void HttpServer::ws_close(Connection& c, uint16_t code) {
+    const char status[2] = {static_cast<char>(code >> 8), static_cast<char>(code & 0xFF)};
+    if (push_queue(c, ws_frame(WS_CLOSE, std::string_view(status, 2)))) c.close_after_write = true;
+}
+
+// One frame is built and shared by every client's queue.
+size_t HttpServer::ws_broadcast(std::string_view text) {
+    if (counters.ws_open == 0) return 0;
+    const Segment frame = ws_frame(WS_TEXT, text);
+    size_t queued = 0;
+    for (auto& c : connections) {
+        if (c.state != ConnState::WEBSOCKET || c.close_after_write) continue;
+        if (push_queue(c, frame)) queued++;
+    }
+    return queued;
+}
+
+bool HttpServer::ws_send(uint8_t client, std::string_view text) {
+    if (client >= connections.size()) return false;
+    Connection& c = connections[client];
+    if (c.state != ConnState::WEBSOCKET || c.close_after_write) return false;
+    return push_queue(c, ws_frame(WS_TEXT, text));
+}
+
+uint32_t HttpServer::ws_client_ip(uint8_t client) const {
+    if (client >= connections.size() || connections[client].state != ConnState::WEBSOCKET) return 0;
+    return connections[client].ip;
+}
+
+// ---------- Event stream ----------
+
+// One encoded event is shared by every subscriber's queue.
+size_t HttpServer::sse_broadcast(std::string_view event, std::string_view data) {
+    if (counters.sse_open == 0) return 0;
+    const Segment frame = sse_frame(event, data);
+    size_t queued = 0;
+    for (auto& c : connections) {
+        if (c.state != ConnState::EVENT_STREAM) continue;
+        if (push_queue(c, frame)) queued++;
+    }
+    return queued;
+}
+
+bool HttpServer::sse_send(uint8_t client, std::string_view event, std::string_view data) {
+    if (client >= connections.size()) return false;
+    Connection& c = connections[client];
+    if (c.state != ConnState::EVENT_STREAM) return false;
+    return push_queue(c, sse_frame(event, data));
+}
+
+HttpServer::Segment HttpServer::sse_frame(std::string_view event, std::string_view data) {
+    std::string frame;
+    frame.reserve(event.size() + data.size() + 16);
+    if (!event.empty()) {
+        frame += "event: ";
+        frame.append(event);
+        frame += '\n';
+    }
+    for (;;) {
+        const size_t eol = data.find('\n');
+        frame += "data: ";
+        frame.append(data.substr(0, eol));
+        frame += '\n';
+        if (eol == std::string_view::npos) break;
+        data.remove_prefix(eol + 1);
+    }
+    frame += '\n';
+    return owned_segment(std::move(frame));
+}
+
+HttpServer::Segment HttpServer::ws_frame(uint8_t opcode, std::string_view payload) {
+    std::string frame;
+    frame.reserve(payload.size() + 10);
+    frame.push_back(static_cast<char>(0x80 | opcode));              // FIN, never fragmented
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        frame.push_back(static_cast<char>(126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size() & 0xFF));
+    } else {
+        frame.push_back(static_cast<char>(127));
+        for (int i = 7; i >= 0; --i) frame.push_back(static_cast<char>(static_cast<uint64_t>(payload.size()) >> (i * 8)));
+    }
+    frame.append(payload);
+    return owned_segment(std::move(frame));
+}
+
+std::string HttpServer::ws_accept_key(std::string_view key) {
+    std::string text(key);
+    text += "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    const auto digest = sha1(text);
+    return base64(digest.data(), digest.size());
+}
+
+HTTPMethod HttpServer::method() const {
+    return current ? current->request.method : HTTP_GET;
+}
+
+const std::string& HttpServer::uri() const {
+    return current ? current->request.uri : kEmpty;
+}
+
+bool HttpServer::hasArg(const char* name) const {
+    if (!current) return false;
+    if (std::strcmp(name, "plain") == 0) return !current->request.body.empty();
+    return find(current->request.args, name, false) != nullptr;
+}
+
+std::string HttpServer::arg(const char* name) const {
+    if (!current) return {};
+    // WebServer convention: "plain" is the raw request body
+    if (std::strcmp(name, "plain") == 0) return current->request.body;
+    const auto* a = find(current->request.args, name, false);
+    return a ? a->second : std::string();
+}
+
+bool HttpServer::hasHeader(const char* name) const {
+    return current && find(current->request.headers, name, true) != nullptr;
+}
+
+std::string HttpServer::header(const char* name) const {
+    if (!current) return {};
+    const auto* h = find(current->request.headers, name, true);
+    return h ? h->second : std::string();
+}
+
+uint32_t HttpServer::client_ip() const {
+    return current ? current->ip : 0;
+}
+
+uint32_t HttpServer::local_ip() const {
+    return current ? current->local_ip : 0;
+}
+
+void HttpServer::sendHeader(std::string_view name, std::string_view value, bool first) {
+    if (first) response_headers.emplace(response_headers.begin(), std::string(name), std::string(value));
+    else       response_headers.emplace_back(std::string(name), std::string(value));
+}
+
+void HttpServer::send(int code, const char* content_type, std::string content) {
+    if (!current || response_sent) return;
+    response_sent = true;
+    queue_response(*current, code, content_type, owned_segment(std::move(content)));
+}
+
+void HttpServer::send_P(int code, const char* content_type, const char* content) {
+    send_P(code, content_type, content, std::strlen(content));
+}
+
+// content must outlive the response (PROGMEM / static data); it is never copied,
+// and may hold binary data such as a gzip stream
+void HttpServer::send_P(int code, const char* content_type, const char* content, size_t length) {
+    if (!current || response_sent) return;
+    response_sent = true;
+    Segment body;
+    body.data = content;
+    body.len  = length;
+    queue_response(*current, code, content_type, std::move(body));
+}
+
+void HttpServer::begin_stream(int code, const char* content_type) {
+    if (!current || response_sent) return;
+    response_sent = true;
+    streaming     = true;
+    stream_aborted = false;
+    stream_deadline_ms = now_ms() + STREAM_WAIT_BUDGET_MS;
+    stream_buffer.clear();
+    stream_buffer.reserve(STREAM_CHUNK_BYTES + 256);               // one allocation; writers append small pieces
+
+    Connection& c = *current;
+    std::string head = response_head(c, code, content_type, nullptr);
+    c.out.clear();
+    c.out_index   = 0;
+    c.out_offset  = 0;
+    c.out_pending = head.size();
+    c.out.push_back(owned_segment(std::move(head)));
+    set_state(c, ConnState::WRITE);
+}
+
+void HttpServer::stream(std::string_view data) {
+    if (!streaming || stream_aborted) return;
+    stream_buffer.append(data);
+    if (stream_buffer.size() >= STREAM_CHUNK_BYTES) flush_stream();
+}
+
+void HttpServer::end_stream() {
+    if (!streaming) return;
+    flush_stream();
+    if (current->chunked && current->request.method != HTTP_HEAD && !stream_aborted) {
+        static const char last_chunk[] = "0\r\n\r\n";
+        Segment tail;
+        tail.data = last_chunk;
+        tail.len  = sizeof(last_chunk) - 1;
+        current->out_pending += tail.len;
+        current->out.push_back(tail);
+    }
+    streaming = false;
+    std::string().swap(stream_buffer);
+}
+
+// Moves the buffered bytes into the output queue as one chunk and lets the socket
+// take what it can right away, so a long body never piles up in RAM. Past
+// STREAM_MAX_PENDING_BYTES queued the handler waits for the socket to drain, but the
+// whole response gets at most STREAM_WAIT_BUDGET_MS of that (a LAN client drains a
+// few KB in far less); a client still behind after it gets the response cut off, so
+// one slow reader holds the main loop for a bounded time only.
+void HttpServer::flush_stream() {
+    Connection& c = *current;
+    if (stream_aborted || stream_buffer.empty() || c.request.method == HTTP_HEAD) {
+        stream_buffer.clear();
+        return;
+    }
+    std::string chunk;
+    if (c.chunked) {
+        char size_line[12];
+        const int n = std::snprintf(size_line, sizeof(size_line), "%zx\r\n", stream_buffer.size());
+        chunk.reserve(stream_buffer.size() + n + 2);
+        chunk.append(size_line, n);
+        chunk += stream_buffer;
+        chunk += "\r\n";
+    } else {
+        chunk = stream_buffer;
+    }
+    stream_buffer.clear();
+    // segments already on the wire are done with
+    c.out.erase(c.out.begin(), c.out.begin() + c.out_index);
+    c.out_index = 0;
+    c.out_pending += chunk.size();
+    c.out.push_back(owned_segment(std::move(chunk)));
+
+    for (;;) {
+        if (!flush_output(c)) {
+            abort_stream(c);
+            return;
+        }
+        if (c.out_pending <= STREAM_MAX_PENDING_BYTES) return;
+        const int32_t left_ms = static_cast<int32_t>(stream_deadline_ms - now_ms());
+        if (left_ms <= 0) {
+            abort_stream(c);
+            return;
+        }
+        fd_set writable;
+        FD_ZERO(&writable);
+        FD_SET(c.fd, &writable);
+        timeval wait {0, static_cast<long>(std::min<int32_t>(left_ms, 20)) * 1000};
+        ::select(c.fd + 1, nullptr, &writable, nullptr, &wait);
+    }
+}
+
+// Drops what is queued and closes the connection once the handler returns; the client
+// sees a response without its final chunk, i.e. a truncated one.
+void HttpServer::abort_stream(Connection& c) {
+    counters.stream_aborts++;
+    stream_aborted      = true;
+    c.out.clear();
+    c.out_index         = 0;
+    c.out_offset        = 0;
+    c.out_pending       = 0;
+    c.close_after_write = true;
+}
+
+HttpServer::Segment HttpServer::owned_segment(std::string&& text) {
+    Segment s;
+    s.owned = std::make_shared<const std::string>(std::move(text));
+    s.data  = s.owned->data();
+    s.len   = s.owned->size();
+    return s;
+}
+
+void HttpServer::parse_args(std::string_view text, header_list_t& out) {
+    while (!text.empty()) {
+        const size_t amp = text.find('&');
+        const std::string_view pair = text.substr(0, amp);
+        text = (amp == std::string_view::npos) ? std::string_view() : text.substr(amp + 1);
+        if (pair.empty()) continue;
+
+        const size_t eq = pair.find('=');
+        out.emplace_back(url_decode(pair.substr(0, eq)),
+                         eq == std::string_view::npos ? std::string() : url_decode(pair.substr(eq + 1)));
+    }
+}
+
+std::string HttpServer::url_decode(std::string_view text) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char ch = text[i];
+        if (ch == '+') {
+            out.push_back(' ');
+        } else if (ch == '%' && i + 2 < text.size() && nibble(text[i + 1]) >= 0 && nibble(text[i + 2]) >= 0) {
+            out.push_back(static_cast<char>((nibble(text[i + 1]) << 4) | nibble(text[i + 2])));
+            i += 2;
+        } else {
+            out.push_back(ch);
+        }
+    }
+    return out;
+}
+
+const char* HttpServer::reason_phrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 429: return "Too Many Requests";
+        case 422: return "Unprocessable Content";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "";
+    }
+}
+
+const char* HttpServer::method_name(HTTPMethod method) {
+    switch (method) {
+        case HTTP_GET:     return "GET";
+        case HTTP_POST:    return "POST";
+        case HTTP_HEAD:    return "HEAD";
+        case HTTP_PUT:     return "PUT";
+        case HTTP_DELETE:  return "DELETE";
+        case HTTP_PATCH:   return "PATCH";
+        case HTTP_OPTIONS: return "OPTIONS";
+        default:           return method == HTTP_ANY ? "ANY" : "?";
+    }
+}
+
+bool HttpServer::method_from(std::string_view text, HTTPMethod& out) {
+    if      (text == "GET")     out = HTTP_GET;
+    else if (text == "POST")    out = HTTP_POST;
+    else if (text == "HEAD")    out = HTTP_HEAD;
+    else if (text == "PUT")     out = HTTP_PUT;
+    else if (text == "DELETE")  out = HTTP_DELETE;
+    else if (text == "OPTIONS") out = HTTP_OPTIONS;
+    else if (text == "PATCH")   out = HTTP_PATCH;
+    else return false;
+    return true;
+}
+
+const std::pair<std::string, std::string>* HttpServer::find(const header_list_t& list, const char* name, bool ignore_case) {
+    for (const auto& entry : list) {
+        if (ignore_case ? iequals(entry.first, name) : entry.first == name) return &entry;
+    }
+    return nullptr;
+}
@@ -0,0 +1,360 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+// src/Modules/Software/WebInterface/HttpServer.h
+#pragma once
+
+// Event-driven HTTP/1.1 server on non-blocking BSD sockets (lwIP on the ESP32).
+// handleClient() pumps every connection once without blocking, so one slow client
+// never stalls the main loop. The request API mirrors Arduino's WebServer so routes
+// registered through WebInterface::get_server().on() keep working unchanged.
+// Routes registered with on_websocket() upgrade to RFC 6455 WebSockets, and routes
+// registered with on_event_stream() become Server-Sent Event streams, on the same
+// sockets. Each such push client has a bounded outbound backlog and is dropped,
+// not waited on, when it can't keep up. Routes given an upload handler receive
+// their request body piece by piece as it arrives (Content-Length or chunked), so
+// a body of any size streams through without being buffered.
+// Every dispatched request is counted against its route: status classes, bytes
+// in and out, and a histogram of handler time.
+// Only the standard library and sockets are used, so it also builds on a host.
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../../XeWeStats.h"
+
+#ifdef ARDUINO
+#include <HTTP_Method.h>
+#else
+enum http_method { HTTP_DELETE = 0, HTTP_GET = 1, HTTP_HEAD = 2, HTTP_POST = 3, HTTP_PUT = 4, HTTP_OPTIONS = 6, HTTP_PATCH = 28 };
+typedef enum http_method HTTPMethod;
+#define HTTP_ANY (HTTPMethod)(255)
+#endif
+
+
+class HttpServer {
+public:
+    using handler_t = std::function<void()>;
+
+    static constexpr uint8_t    MAX_CONNECTIONS             = 6;    // lwIP allows 10 sockets in total
+    static constexpr size_t     MAX_HEAD_BYTES              = 2048; // request line + headers
+    static constexpr size_t     MAX_BODY_BYTES              = 8192;
+    static constexpr uint8_t    MAX_HEADERS                 = 24;
+    static constexpr uint32_t   REQUEST_TIMEOUT_MS          = 10000;// a started request must complete in this
+    static constexpr uint32_t   KEEP_ALIVE_TIMEOUT_MS       = 5000; // idle time between requests
+    static constexpr uint16_t   MAX_KEEP_ALIVE_REQUESTS     = 100;
+    static constexpr size_t     STREAM_CHUNK_BYTES          = 1024; // streamed bodies go out in chunks of this
+    static constexpr size_t     STREAM_MAX_PENDING_BYTES    = 4096; // a streamed body waits for the socket past this
+    static constexpr uint32_t   STREAM_WAIT_BUDGET_MS       = 200;  // most a whole streamed response may wait; then it is aborted
+    static constexpr uint8_t    MAX_PUSH_CLIENTS            = 4;    // WebSocket + event stream; leaves slots for plain requests
+    static constexpr size_t     PUSH_MAX_PENDING_BYTES      = 16384;// outbound backlog per push client
+    static constexpr uint32_t   PUSH_STALL_TIMEOUT_MS       = 5000; // a backlog that makes no progress this long is dropped
+    static constexpr size_t     WS_MAX_MESSAGE_BYTES        = 1024; // inbound, after reassembly
+    static constexpr uint32_t   WS_PING_INTERVAL_MS         = 30000;
+    static constexpr uint32_t   SSE_KEEPALIVE_MS            = 15000;// comment line on an idle event stream
+    static constexpr uint32_t   UPLOAD_STALL_TIMEOUT_MS     = 10000;// an upload may take long, but must keep moving
+
+    using ws_message_handler_t  = std::function<void(uint8_t client, std::string_view text)>;
+    using ws_event_handler_t    = std::function<void(uint8_t client, bool connected)>;
+    using sse_connect_handler_t = std::function<void(uint8_t client)>;
+
+    // upload().status as seen by an upload handler: START once the head is parsed,
+    // WRITE per piece of body, END when it is complete (the route handler runs next),
+    // ABORTED if the client goes away or times out first. A handler that sends a
+    // response during START or WRITE rejects the upload; that response is final.
+    enum class UploadStatus : uint8_t { START, WRITE, END, ABORTED };
+
+    struct Upload {
+        UploadStatus            status                      {UploadStatus::START};
+        std::string_view        data;                               // WRITE only; valid during the call
+        size_t                  received                    {0};    // body bytes so far
+        size_t                  expected                    {0};    // Content-Length; 0 when chunked
+    };
+
+    struct Stats {
+        uint32_t                accepted                    {0};
+        uint32_t                rejected                    {0};    // turned away with 503, all slots busy
+        uint32_t                requests                    {0};
+        uint32_t                timeouts                    {0};
+        uint32_t                oversize                    {0};    // 413 / 431
+        uint32_t                stream_aborts               {0};    // streamed responses cut off, the client stopped reading
+        uint8_t                 open                        {0};
+        uint8_t                 peak_open                   {0};
+        size_t                  peak_buffered               {0};    // most bytes held in request and response buffers at once
+        uint8_t                 ws_open                     {0};
+        uint8_t                 sse_open                    {0};
+        uint32_t                push_dropped                {0};    // slow or silent push clients cut off
+        std::array<uint32_t, 5> responses                   {};     // by status class, 1xx..5xx, errors included
+    };
+
+    static constexpr uint8_t    TRACKED_CLIENTS             = 8;    // distinct IPs counted per client
+
+    // per route registered with on(); handler time covers the whole dispatch,
+    // including a streamed body generated inside the handler
+    struct RouteStats {
+        std::string             label;                              // "GET /cmd"
+        uint32_t                requests                    {0};
+        std::array<uint32_t, 5> responses                   {};     // by status class, 1xx..5xx
+        uint64_t                bytes_in                    {0};    // request bodies
+        uint64_t                bytes_out                   {0};    // heads + bodies
+        uint64_t                total_us                    {0};
+        xewe::stats::Histogram<8> latency_us                {{250, 500, 1000, 2500, 5000, 10000, 25000, 100000}};
+    };
+    using client_tally_t        = xewe::stats::Tally<uint32_t, TRACKED_CLIENTS>;
+
+    explicit                    HttpServer                  (uint16_t port);
+                                ~HttpServer                 ();
+                                HttpServer                  (const HttpServer&)             = delete;
+    HttpServer&                 operator=                   (const HttpServer&)             = delete;
+
+    // routing, WebServer-compatible
+    void                        on                          (const char* uri,
+                                                             handler_t handler);
+    void                        on                          (const char* uri,
+                                                             HTTPMethod method,
+                                                             handler_t handler);
+    void                        on                          (const char* uri,
+                                                             HTTPMethod method,
+                                                             handler_t handler,
+                                                             handler_t upload_handler);
+    void                        onNotFound                  (handler_t handler);
+    // runs before routing, WebSocket and event stream upgrades included; a response it
+    // sends ends the request there
+    void                        on_request                  (handler_t filter);
+    void                        on_websocket                (const char* uri,
+                                                             ws_message_handler_t on_message,
+                                                             ws_event_handler_t on_event={});
+    void                        on_event_stream             (const char* uri,
+                                                             sse_connect_handler_t on_connect={});
+
+    bool                        begin                       ();
+    void                        stop                        ();
+    void                        handleClient                ();
+
+    // current request; valid inside a handler only
+    HTTPMethod                  method                      () const;
+    const std::string&          uri                         () const;
+    bool                        hasArg                      (const char* name) const;
+    std::string                 arg                         (const char* name) const;
+    bool                        hasHeader                   (const char* name) const;
+    std::string                 header                      (const char* name) const;
+    std::string                 hostHeader                  () const                        { return header("Host"); }
+    uint32_t                    client_ip                   () const;
+    uint32_t                    local_ip                    () const;  // address the request arrived on
+    const Upload&               upload                      () const                        { return upload_state; }
+
+    // response; headers added before send() go out with it
+    void                        sendHeader                  (std::string_view name,
+                                                             std::string_view value,
+                                                             bool first=false);
+    void                        send                        (int code,
+                                                             const char* content_type=nullptr,
+                                                             std::string content={});
+    void                        send_P                      (int code,
+                                                             const char* content_type,
+                                                             const char* content);
+    void                        send_P                      (int code,
+                                                             const char* content_type,
+                                                             const char* content,
+                                                             size_t length);
+
+    // streamed response of unknown length (chunked on HTTP/1.1); stream() may be
+    // called any number of times, and end_stream() is implied when the handler returns
+    void                        begin_stream                (int code,
+                                                             const char* content_type);
+    void                        stream                      (std::string_view data);
+    void                        end_stream                  ();
+
+    // WebSocket text frames; a client is its connection slot index
+    size_t                      ws_broadcast                (std::string_view text);
+    bool                        ws_send                     (uint8_t client,
+                                                             std::string_view text);
+    uint8_t                     ws_clients                  () const                        { return counters.ws_open; }
+    uint32_t                    ws_client_ip                (uint8_t client) const;
+
+    // Server-Sent Events; data may span lines, each becomes its own "data:" field
+    size_t                      sse_broadcast               (std::string_view event,
+                                                             std::string_view data);
+    bool                        sse_send                    (uint8_t client,
+                                                             std::string_view event,
+                                                             std::string_view data);
+    uint8_t                     sse_clients                 () const                        { return counters.sse_open; }
+
+    const Stats&                stats                       () const                        { return counters; }
+    // one entry per on() call, in registration order, then requests no route matched
+    const std::vector<RouteStats>& route_stats              () const                        { return per_route; }
+    const RouteStats&           unmatched_stats             () const                        { return unmatched; }
+    // requests per client IP (network byte order); later IPs fold into other()
+    const client_tally_t&       client_requests             () const                        { return per_client; }
+    void                        reset_stats                 ();
+
+private:
+    enum class ConnState : uint8_t { FREE, READ_HEAD, READ_BODY, READ_UPLOAD, WRITE, WEBSOCKET, EVENT_STREAM };
+    enum class ChunkPhase : uint8_t { SIZE, DATA, DATA_END, TRAILER };
+
+    using header_list_t         = std::vector<std::pair<std::string, std::string>>;
+
+    struct Route {
+        std::string             uri;
+        HTTPMethod              method;
+        handler_t               handler;
+        handler_t               upload_handler;
+    };
+
+    struct WsRoute {
+        std::string             uri;
+        ws_message_handler_t    on_message;
+        ws_event_handler_t      on_event;
+    };
+
+    struct SseRoute {
+        std::string             uri;
+        sse_connect_handler_t   on_connect;
+    };
+
+    struct Request {
+        HTTPMethod              method                      {HTTP_GET};
+        std::string             uri;
+        header_list_t           headers;
+        header_list_t           args;                               // query string + urlencoded form, decoded
+        std::string             body;
+        size_t                  content_length              {0};
+        bool                    keep_alive                  {true};
+        bool                    http11                      {true};
+        int8_t                  upload_route                {-1};   // index into routes when the body is streamed
+        bool                    chunked_body                {false};
+        ChunkPhase              chunk_phase                 {ChunkPhase::SIZE};
+        size_t                  chunk_left                  {0};
+        size_t                  received                    {0};
+    };
+
+    // one piece of a queued response; owned payloads are shared_ptr so the same
+    // bytes can sit in several connections' queues without copies
+    struct Segment {
+        std::shared_ptr<const std::string> owned;
+        const char*             data                        {nullptr};
+        size_t                  len                         {0};
+    };
+
+    struct Connection {
+        int                     fd                          {-1};
+        ConnState               state                       {ConnState::FREE};
+        uint32_t                ip                          {0};
+        uint32_t                local_ip                    {0};    // our end: tells the SoftAP from the station side
+        uint32_t                state_since_ms              {0};
+        uint16_t                served                      {0};
+        std::string             in;
+        Request                 request;
+        std::vector<Segment>    out;
+        size_t                  out_index                   {0};
+        size_t                  out_offset                  {0};
+        size_t                  out_pending                 {0};    // queued bytes not yet sent
+        bool                    close_after_write           {false};
+        bool                    chunked                     {false};    // current response uses chunked framing
+        uint8_t                 push_route                  {0};    // index into ws_routes / sse_routes
+        uint8_t                 ws_opcode                   {0};    // of the message being reassembled
+        uint32_t                ws_ping_ms                  {0};    // also the event-stream keepalive clock
+        bool                    ws_awaiting_pong            {false};
+        uint16_t                status                      {0};    // of the response being sent
+        size_t                  sent                        {0};    // bytes written to the socket, ever
+    };
+
+    void                        accept_clients              ();
+    void                        service                     (Connection& c,
+                                                             bool readable);
+    bool                        read_input                  (Connection& c);
+    int                         parse_head                  (Connection& c);
+    int                         read_upload                 (Connection& c);
+    bool                        call_upload                 (Connection& c,
+                                                             UploadStatus status,
+                                                             std::string_view data={});
+    void                        dispatch                    (Connection& c);
+    void                        record                      (RouteStats& route,
+                                                             const Connection& c,
+                                                             size_t bytes_out,
+                                                             uint32_t elapsed_us);
+    bool                        flush_output                (Connection& c);
+    void                        finish_response             (Connection& c);
+    void                        respond_error               (Connection& c,
+                                                             int code);
+    void                        queue_response              (Connection& c,
+                                                             int code,
+                                                             const char* content_type,
+                                                             Segment body);
+    std::string                 response_head               (Connection& c,
+                                                             int code,
+                                                             const char* content_type,
+                                                             const size_t* content_length);
+    void                        flush_stream                ();
+    void                        abort_stream                (Connection& c);
+    void                        set_state                   (Connection& c,
+                                                             ConnState state);
+    void                        close                       (Connection& c);
+
+    bool                        upgrade_websocket           (Connection& c);
+    bool                        open_event_stream           (Connection& c);
+    void                        start_push                  (Connection& c,
+                                                             ConnState state,
+                                                             size_t route,
+                                                             std::string&& head);
+    void                        service_push                (Connection& c);
+    int                         parse_frame                 (Connection& c);
+    bool                        push_queue                  (Connection& c,
+                                                             const Segment& frame);
+    void                        ws_close                    (Connection& c,
+                                                             uint16_t code);
+    uint8_t                     client_id                   (const Connection& c) const     { return static_cast<uint8_t>(&c - connections.data()); }
+
+    static Segment              owned_segment               (std::string&& text);
+    static Segment              ws_frame                    (uint8_t opcode,
+                                                             std::string_view payload);
+    static std::string          ws_accept_key               (std::string_view key);
+    static Segment              sse_frame                   (std::string_view event,
+                                                             std::string_view data);
+    static void                 parse_args                  (std::string_view text,
+                                                             header_list_t& out);
+    static std::string          url_decode                  (std::string_view text);
+    static const char*          reason_phrase               (int code);
+    static const char*          method_name                 (HTTPMethod method);
+    static bool                 method_from                 (std::string_view text,
+                                                             HTTPMethod& out);
+    static const std::pair<std::string, std::string>*
+                                find                        (const header_list_t& list,
+                                                             const char* name,
+                                                             bool ignore_case);
+
+    uint16_t                    port;
+    int                         listen_fd                   {-1};
+    std::vector<Route>          routes;
+    std::vector<WsRoute>        ws_routes;
+    std::vector<SseRoute>       sse_routes;
+    handler_t                   not_found_handler;
+    handler_t                   request_filter;
+    std::array<Connection, MAX_CONNECTIONS> connections;
+    Stats                       counters;
+    std::vector<RouteStats>     per_route;
+    RouteStats                  unmatched;
+    client_tally_t              per_client;
+
+    // dispatch context, set while a handler runs
+    Connection*                 current                     {nullptr};
+    header_list_t               response_headers;
+    bool                        response_sent               {false};
+    bool                        streaming                   {false};
+    bool                        stream_aborted              {false};    // the rest of the body is dropped
+    uint32_t                    stream_deadline_ms          {0};    // waiting for the socket past this aborts the stream
+    std::string                 stream_buffer;
+    Upload                      upload_state;
+};
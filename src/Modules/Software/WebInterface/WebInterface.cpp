@@ -11,6 +11,7 @@
 // src/Modules/Software/WebInterface/WebInterface.cpp
 
 #include "WebInterface.h"
+#include "web_assets.h"
 #include "../../../SystemController/SystemController.h"
 
 
@@ -22,18 +23,110 @@ WebInterface::WebInterface(SystemController& controller)
                /* requires_init_setup */ false,
                /* can_be_disabled     */ true,
                /* has_cli_cmds        */ true)
-{}
+{
+    commands_storage.push_back({
+        "events",
+        "Set how often /events pushes telemetry, in ms (200-60000)",
+        std::string("$") + lower(module_name) + " events 1000",
+        1,
+        [this](std::string_view args){ set_events_interval(args); }
+    });
+    commands_storage.push_back({
+        "rate_limit",
+        "Limit web commands per client: <commands per minute, 0 = off> <burst 1-60, also the largest /api/cmd batch>",
+        std::string("$") + lower(module_name) + " rate_limit 120 10",
+        2,
+        [this](std::string_view args){ set_rate_limit(args); }
+    });
+    commands_storage.push_back({
+        "inflight",
+        "Web command lines run per main loop pass, 0 = unlimited (max 16); a batch started in a pass runs whole",
+        std::string("$") + lower(module_name) + " inflight 2",
+        1,
+        [this](std::string_view args){ set_inflight_limit(args); }
+    });
+    commands_storage.push_back({
+        "ota_token",
+        "Set the token /ota uploads must send in X-OTA-Token (8-64 chars), or 'off' to refuse every upload",
+        std::string("$") + lower(module_name) + " ota_token 5f1c9e2a7d",
+        1,
+        [this](std::string_view args){ set_ota_token(args); }
+    });
+    commands_storage.push_back({
+        "stats",
+        "Show requests, status codes, bytes and handler latency per route, and the busiest clients",
+        std::string("$") + lower(module_name) + " stats",
+        0,
+        [this](std::string_view){ print_stats(); }
+    });
+    commands_storage.push_back({
+        "stats_reset",
+        "Clear the per-route and per-client request stats",
+        std::string("$") + lower(module_name) + " stats_reset",
+        0,
+        [this](std::string_view){
+            http_server.reset_stats();
+            this->controller.serial_port.print("Web stats cleared");
+        }
+    });
+}
 
 void WebInterface::begin_routines_common (const ModuleConfig& cfg) {
     http_server.on("/", HTTP_GET, std::bind(&WebInterface::serve_main_page, this));
     http_server.on("/cmd", HTTP_GET, std::bind(&WebInterface::handle_command_request, this));
+    http_server.on("/api/modules", HTTP_GET, std::bind(&WebInterface::handle_api_modules, this));
+    http_server.on("/api/cmd", HTTP_POST, std::bind(&WebInterface::handle_api_command_batch, this));
+    http_server.on("/metrics", HTTP_GET, std::bind(&WebInterface::handle_metrics, this));
+    http_server.on("/ota", HTTP_POST, std::bind(&WebInterface::handle_ota_done, this),
+                   std::bind(&WebInterface::handle_ota_upload, this));
+    http_server.on("/ota", HTTP_GET, std::bind(&WebInterface::handle_ota_status, this));
+    http_server.on("/provision", HTTP_GET, std::bind(&WebInterface::serve_provision_page, this));
+    http_server.on("/provision/networks", HTTP_GET, std::bind(&WebInterface::handle_provision_networks, this));
+    http_server.on("/provision/save", HTTP_POST, std::bind(&WebInterface::handle_provision_save, this));
+    http_server.on("/provision/status", HTTP_GET, std::bind(&WebInterface::handle_provision_status, this));
+    http_server.onNotFound(std::bind(&WebInterface::handle_not_found, this));
+    http_server.on_request(std::bind(&WebInterface::guard_portal, this));
+    http_server.on_websocket("/console",
+                             [this](uint8_t client, std::string_view text) { handle_console_message(client, text); },
+                             [](uint8_t client, bool connected) {
+                                 DBG_PRINTF(WebInterface, "console client %u %s\n", client, connected ? "connected" : "disconnected");
+                             });
+    http_server.on_event_stream("/events", [this](uint8_t client) { send_snapshot(client); });
     http_server.begin();
-    controller.serial_port.print("Web Interface now available at:\nhttp://" + controller.wifi.get_local_ip());
+
+    events_interval_ms = std::clamp(controller.nvs.read_uint32(nvs_key, "ev_ms", EVENTS_DEFAULT_MS), EVENTS_MIN_MS, EVENTS_MAX_MS);
+    rate_per_min       = std::min(controller.nvs.read_uint16(nvs_key, "rl_rate", RATE_DEFAULT_PER_MIN), RATE_MAX_PER_MIN);
+    rate_burst         = std::clamp<uint8_t>(controller.nvs.read_uint8(nvs_key, "rl_burst", RATE_DEFAULT_BURST), 1, RATE_MAX_BURST);
+    inflight_limit     = std::min(controller.nvs.read_uint8(nvs_key, "inflight", INFLIGHT_DEFAULT), INFLIGHT_MAX);
+    ota_token          = controller.nvs.read_str(nvs_key, "ota_token");
+
+    // mirror everything the console prints to connected browsers; batched per loop pass
+    controller.serial_port.add_output_sink([this](std::string_view text) {
+        if (http_server.ws_clients() == 0) return;
+        console_backlog.append(text);
+        if (console_backlog.size() >= CONSOLE_FLUSH_BYTES) flush_console();
+    });
+
+    // the link comes up asynchronously; announce the address whenever it does
+    controller.wifi.on_link_change([this](Wifi::LinkState state) {
+        if (state == Wifi::LinkState::CONNECTED && is_enabled()) print_address();
+        publish_wifi(state);
+    });
+    if (controller.wifi.is_connected()) print_address();
+
+    controller.buttons.on_button_event([this](uint8_t pin, bool pressed, uint32_t at_us) { publish_button(pin, pressed, at_us); });
 }
 
 void WebInterface::loop () {
     if (is_disabled()) return;
+    flush_console();
+    if (millis() - last_telemetry_ms >= events_interval_ms) {
+        last_telemetry_ms = millis();
+        publish_telemetry();
+    }
+    inflight = 0;
     http_server.handleClient();
+    if (ota_restart_ms && static_cast<int32_t>(millis() - ota_restart_ms) >= 0) ESP.restart();
 }
 
 std::string WebInterface::status (const bool verbose) const {
@@ -61,6 +154,31 @@ std::string WebInterface::status (const bool verbose) const {
     out << "  - Memory Usage: "
         << std::fixed << std::setprecision(2) << heap_usage << "% ("
         << used_heap << " / " << total_heap << " bytes)\n";
+    const HttpServer::Stats& http = http_server.stats();
+    out << "  - Connections:  " << unsigned(http.open) << " open / " << HttpServer::MAX_CONNECTIONS << " max, "
+        << http.accepted << " accepted, " << http.rejected << " rejected\n";
+    out << "  - High water:   " << unsigned(http.peak_open) << " connections, " << http.peak_buffered << " bytes buffered\n";
+    out << "  - Requests:     " << http.requests << " (" << http.timeouts << " timed out, "
+        << http.oversize << " too large, " << http.stream_aborts << " streams cut off)\n";
+    out << "  - Push clients: " << unsigned(http.ws_open) << " console, " << unsigned(http.sse_open) << " events / "
+        << unsigned(HttpServer::MAX_PUSH_CLIENTS) << " max, " << http.push_dropped << " dropped\n";
+    out << "  - Responses:    " << http.responses[1] << " 2xx, " << http.responses[2] << " 3xx, "
+        << http.responses[3] << " 4xx, " << http.responses[4] << " 5xx\n";
+    out << "  - Events every: " << events_interval_ms << " ms\n";
+    out << "  - Command limit: ";
+    if (rate_per_min) out << rate_per_min << "/min per client, burst " << unsigned(rate_burst);
+    else              out << "off";
+    out << "; " << unsigned(inflight_limit) << " per loop pass; "
+        << rate_limited << " rate limited, " << shed << " shed\n";
+    // one line per route that has seen traffic: requests, errors, p90 handler time
+    const auto line = [&out](const HttpServer::RouteStats& route) {
+        if (!route.requests) return;
+        out << "  - " << route.label << ": " << route.requests << " req, "
+            << route.responses[3] + route.responses[4] << " err, p90 "
+            << route.latency_us.percentile(90) << " us\n";
+    };
+    for (const auto& route : http_server.route_stats()) line(route);
+    line(http_server.unmatched_stats());
     out << "-------------------------\n";
 
     if (verbose) {
@@ -70,154 +188,800 @@ std::string WebInterface::status (const bool verbose) const {
     return out.str();
 }
 
+void WebInterface::status_json(xewe::json::Writer& out) const {
+    const HttpServer::Stats& http = http_server.stats();
+    out.field("open_connections", http.open);
+    out.field("accepted", http.accepted);
+    out.field("rejected", http.rejected);
+    out.field("peak_connections", http.peak_open);
+    out.field("peak_buffered_bytes", http.peak_buffered);
+    out.field("requests", http.requests);
+    out.field("timeouts", http.timeouts);
+    out.field("oversize", http.oversize);
+    out.field("stream_aborts", http.stream_aborts);
+    out.field("console_clients", http.ws_open);
+    out.field("event_clients", http.sse_open);
+    out.field("push_dropped", http.push_dropped);
+    out.field("events_interval_ms", events_interval_ms);
+    out.field("rate_per_min", rate_per_min);
+    out.field("rate_burst", rate_burst);
+    out.field("inflight_limit", inflight_limit);
+    out.field("rate_limited", rate_limited);
+    out.field("shed", shed);
+    out.begin_array("routes");
+    const auto route = [&out](const HttpServer::RouteStats& stats) {
+        out.begin_object();
+        out.field("route", stats.label);
+        out.field("requests", stats.requests);
+        out.field("2xx", stats.responses[1]);
+        out.field("3xx", stats.responses[2]);
+        out.field("4xx", stats.responses[3]);
+        out.field("5xx", stats.responses[4]);
+        out.field("bytes_in", stats.bytes_in);
+        out.field("bytes_out", stats.bytes_out);
+        out.field("p50_us", stats.latency_us.percentile(50));
+        out.field("p90_us", stats.latency_us.percentile(90));
+        out.field("max_us", stats.latency_us.max());
+        out.end_object();
+    };
+    for (const auto& stats : http_server.route_stats()) route(stats);
+    route(http_server.unmatched_stats());
+    out.end_array();
+}
+
+void WebInterface::write_metrics(xewe::metrics::Writer& out) const {
+    const HttpServer::Stats& http = http_server.stats();
+    out.counter("http_connections_total", "Accepted HTTP connections.", http.accepted);
+    out.counter("http_rejected_total", "Connections turned away with 503.", http.rejected);
+    out.counter("http_requests_total", "HTTP requests dispatched.", http.requests);
+    out.counter("http_timeouts_total", "Requests that timed out.", http.timeouts);
+    out.counter("http_oversize_total", "Requests rejected as too large.", http.oversize);
+    out.counter("http_stream_aborts_total", "Streamed responses cut off because the client stopped reading.", http.stream_aborts);
+    out.gauge("http_open_connections", "Open HTTP connections.", http.open);
+    out.gauge("http_peak_connections", "Most HTTP connections open at once.", http.peak_open);
+    out.gauge("http_peak_buffered_bytes", "Most bytes held in HTTP request and response buffers at once.", http.peak_buffered);
+    out.gauge("console_clients", "Connected web console clients.", http.ws_open);
+    out.gauge("event_clients", "Connected /events subscribers.", http.sse_open);
+    out.counter("push_dropped_total", "Console and event clients dropped for falling behind.", http.push_dropped);
+    out.counter("web_commands_rate_limited_total", "Web commands refused by the per-client rate limit.", rate_limited);
+    out.counter("web_commands_shed_total", "Web commands refused by the in-flight cap.", shed);
+
+    const auto& routes = http_server.route_stats();
+    const HttpServer::RouteStats& unmatched = http_server.unmatched_stats();
+    const auto each = [&](auto&& emit) {
+        for (const auto& route : routes) emit(route);
+        emit(unmatched);
+    };
+    out.family("http_route_requests_total", "counter", "Requests dispatched, by route.");
+    each([&out](const HttpServer::RouteStats& r) { out.sample("http_route_requests_total", "route", r.label, r.requests); });
+    out.family("http_route_errors_total", "counter", "4xx and 5xx responses, by route.");
+    each([&out](const HttpServer::RouteStats& r) { out.sample("http_route_errors_total", "route", r.label, r.responses[3] + r.responses[4]); });
+    out.family("http_route_bytes_out_total", "counter", "Response bytes, by route.");
+    each([&out](const HttpServer::RouteStats& r) { out.sample("http_route_bytes_out_total", "route", r.label, r.bytes_out); });
+    out.family("http_route_handler_seconds_total", "counter", "Time spent in the route's handler.");
+    each([&out](const HttpServer::RouteStats& r) { out.sample("http_route_handler_seconds_total", "route", r.label, r.total_us / 1e6); });
+}
+
+void WebInterface::print_stats() const {
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"Route", "Reqs", "2xx", "3xx", "4xx", "5xx", "In B", "Out B", "p50 us", "p90 us", "Max us"});
+    vector<string> string_storage;
+    string_storage.reserve((http_server.route_stats().size() + 1) * 10);
+    const auto row = [&](const HttpServer::RouteStats& route) {
+        if (!route.requests) return;
+        const size_t first = string_storage.size();
+        string_storage.push_back(std::to_string(route.requests));
+        for (size_t i = 1; i < route.responses.size(); ++i) string_storage.push_back(std::to_string(route.responses[i]));
+        string_storage.push_back(std::to_string(route.bytes_in));
+        string_storage.push_back(std::to_string(route.bytes_out));
+        string_storage.push_back(std::to_string(route.latency_us.percentile(50)));
+        string_storage.push_back(std::to_string(route.latency_us.percentile(90)));
+        string_storage.push_back(std::to_string(route.latency_us.max()));
+        vector<string_view> cells {route.label};
+        for (size_t i = first; i < string_storage.size(); ++i) cells.push_back(string_storage[i]);
+        table_data.push_back(std::move(cells));
+    };
+    for (const auto& route : http_server.route_stats()) row(route);
+    row(http_server.unmatched_stats());
+    if (table_data.size() == 1) {
+        controller.serial_port.print("No requests yet");
+        return;
+    }
+    controller.serial_port.print_table(table_data, "Requests per Route");
+
+    // the busiest addresses; requests past the tracked set are lumped together
+    const HttpServer::client_tally_t& clients = http_server.client_requests();
+    vector<vector<string_view>> client_table;
+    client_table.push_back({"Client", "Reqs"});
+    vector<string> client_storage;
+    client_storage.reserve((clients.size() + 1) * 2);
+    for (size_t i = 0; i < clients.size(); ++i) {
+        const uint32_t ip = clients.key(i);
+        char address[16];
+        std::snprintf(address, sizeof(address), "%u.%u.%u.%u",
+                      unsigned(ip & 0xFF), unsigned((ip >> 8) & 0xFF), unsigned((ip >> 16) & 0xFF), unsigned(ip >> 24));
+        client_storage.push_back(address);
+        string_view address_view = client_storage.back();
+        client_storage.push_back(std::to_string(clients.count(i)));
+        client_table.push_back({address_view, client_storage.back()});
+    }
+    if (clients.other()) {
+        client_storage.push_back(std::to_string(clients.other()));
+        client_table.push_back({"(others)", client_storage.back()});
+    }
+    controller.serial_port.print_table(client_table, "Requests per Client");
+}
+
+void WebInterface::print_address() const {
+    controller.serial_port.print("Web Interface now available at:\nhttp://" + controller.wifi.get_local_ip()
+                                 + "\nhttp://" + controller.wifi.get_hostname() + ".local");
+}
+
 void WebInterface::serve_main_page() {
     if (is_disabled()) return;
-    http_server.send_P(200, "text/html", INDEX_HTML);
+    serve_asset(WEB_ASSET_INDEX_HTML);
 }
 
+// Runs one command and answers with what it printed. The HTTP status reflects the
+// parse outcome (see http_status_for) and the X-Command-Status / X-Exit-Code headers
+// name it; with "Accept: application/json" the same fields come back as one object.
 void WebInterface::handle_command_request() {
     if (is_disabled()) return;
 
-    if (http_server.hasArg("c")) {
-        std::string command_text = http_server.arg("c").c_str();
+    if (!http_server.hasArg("c")) {
+        http_server.send(400, "text/plain", "Empty Command");
+        return;
+    }
+    const std::string command_text = http_server.arg("c");
+    if (!admit_command(1, http_server.header("Accept").find("application/json") != std::string::npos)) return;
 
-        controller.serial_port.print("Got cmd from web: \n" + command_text);
-        controller.command_parser.parse(command_text);
+    std::string output;
+    bool truncated = false;
+    const ParseStatus status = run_captured(command_text, output, truncated);
+    const int code = http_status_for(status);
 
-        http_server.send(200, "text/plain", "OK");
-    } else {
-        http_server.send(400, "text/plain", "Empty Command");
+    http_server.sendHeader("X-Command-Status", CommandParser::status_name(status));
+    http_server.sendHeader("X-Exit-Code", std::to_string(static_cast<uint8_t>(status)));
+    if (truncated) http_server.sendHeader("X-Output-Truncated", "1");
+
+    if (http_server.header("Accept").find("application/json") == std::string::npos) {
+        http_server.send(code, "text/plain", std::move(output));
+        return;
     }
+    std::string body;
+    xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+    out.begin_object();
+    out.field("command", command_text);
+    out.field("status", CommandParser::status_name(status));
+    out.field("exit_code", static_cast<uint8_t>(status));
+    out.field("output", output);
+    out.field("truncated", truncated);
+    out.end_object();
+    http_server.send(code, "application/json", std::move(body));
 }
 
-// --------------------------------------------------------------------------
-// HTML Assets
-// --------------------------------------------------------------------------
-
-const char WebInterface::INDEX_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="utf-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <title>XeWe OS Web Interface</title>
-    <style>
-        :root {
-            --bg: #121212;
-            --fg: #e0e0e0;
-            --input-bg: #1e1e1e;
-            --accent: #00bcd4;
-            --border: #333;
-        }
-        body {
-            background-color: var(--bg);
-            color: var(--fg);
-            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-            display: flex;
-            flex-direction: column;
-            align-items: center;
-            justify-content: center;
-            height: 100vh;
-            margin: 0;
-            padding: 20px;
-            box-sizing: border-box;
-        }
-        .container {
-            width: 100%;
-            max-width: 600px;
-            text-align: center;
-        }
-        h1 {
-            font-weight: 300;
-            letter-spacing: 1px;
-            margin-bottom: 2rem;
-            color: var(--accent);
-        }
-        .input-group {
-            display: flex;
-            gap: 10px;
-        }
-        input[type="text"] {
-            flex-grow: 1;
-            padding: 15px;
-            border-radius: 5px;
-            border: 1px solid var(--border);
-            background-color: var(--input-bg);
-            color: var(--fg);
-            font-size: 16px;
-            outline: none;
-            transition: border-color 0.2s;
-        }
-        input[type="text"]:focus {
-            border-color: var(--accent);
-        }
-        button {
-            padding: 15px 25px;
-            border: none;
-            border-radius: 5px;
-            background-color: var(--accent);
-            color: var(--bg);
-            font-weight: bold;
-            font-size: 16px;
-            cursor: pointer;
-            transition: opacity 0.2s;
+// Echoes the command to the console like any other source, then runs it with its
+// output (up to COMMAND_OUTPUT_BYTES) copied into output.
+ParseStatus WebInterface::run_captured(const std::string& command_text, std::string& output, bool& truncated) {
+    controller.serial_port.print("Got cmd from web: \n" + command_text);
+    output.clear();
+    controller.serial_port.begin_capture(output, COMMAND_OUTPUT_BYTES);
+    const ParseStatus status = controller.command_parser.parse(command_text);
+    truncated = !controller.serial_port.end_capture();
+    return status;
+}
+
+// Every web command runs inline on the main loop, so a client sending them in a tight
+// loop would starve Buttons and the serial console. cost command lines are admitted
+// only if the in-flight cap has room left in this loop pass and the client's bucket
+// holds one token per line. Returns nullptr when admitted, else why not, with the
+// seconds to wait in retry_s.
+const char* WebInterface::admit(uint32_t ip, size_t cost, uint32_t& retry_s) {
+    retry_s = 0;
+    if (inflight_limit && inflight >= inflight_limit) {
+        shed++;
+        retry_s = 1;
+        return "busy running other commands";
+    }
+    if (rate_per_min) {
+        CommandBucket& bucket = bucket_for(ip, millis());
+        const uint32_t need = static_cast<uint32_t>(cost) * TOKEN_UNITS;
+        if (cost > rate_burst || bucket.tokens < need) {
+            rate_limited++;
+            const uint32_t wait_ms = (need - bucket.tokens + rate_per_min - 1) / rate_per_min;
+            retry_s = std::max<uint32_t>(1, (wait_ms + 999) / 1000);
+            return "rate limit exceeded";
         }
-        button:active { opacity: 0.8; }
-        #flash {
-            margin-top: 10px;
-            height: 20px;
-            font-size: 0.8rem;
-            opacity: 0;
-            transition: opacity 0.5s;
+        bucket.tokens -= need;
+    }
+    // a batch that starts in this pass runs whole, and leaves no room for anything else
+    inflight = static_cast<uint8_t>(std::min<size_t>(inflight + cost, UINT8_MAX));
+    return nullptr;
+}
+
+// admit() for the current HTTP request; a refusal is answered with 429 and Retry-After.
+bool WebInterface::admit_command(size_t cost, bool json) {
+    uint32_t retry_s = 0;
+    const char* reason = admit(http_server.client_ip(), cost, retry_s);
+    if (!reason) return true;
+
+    http_server.sendHeader("Retry-After", std::to_string(retry_s));
+    if (json) {
+        std::string body;
+        xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+        out.begin_object();
+        out.field("error", reason);
+        out.field("retry_after_s", retry_s);
+        out.end_object();
+        http_server.send(429, "application/json", std::move(body));
+    } else {
+        http_server.send(429, "text/plain", std::string("Too many commands: ") + reason + "; retry in "
+                                            + std::to_string(retry_s) + " s");
+    }
+    return false;
+}
+
+// Refills the client's bucket up to the burst; an unknown client takes over the bucket
+// idle the longest and starts full.
+WebInterface::CommandBucket& WebInterface::bucket_for(uint32_t ip, uint32_t now_ms) {
+    const uint32_t capacity = static_cast<uint32_t>(rate_burst) * TOKEN_UNITS;
+    CommandBucket* bucket = nullptr;
+    for (auto& candidate : buckets) {
+        if (candidate.ip == ip && candidate.last_ms) { bucket = &candidate; break; }
+        if (!bucket || candidate.last_ms == 0
+            || (bucket->last_ms && now_ms - candidate.last_ms > now_ms - bucket->last_ms)) bucket = &candidate;
+    }
+    if (bucket->ip != ip || bucket->last_ms == 0) {
+        bucket->ip     = ip;
+        bucket->tokens = capacity;
+    } else {
+        // bounded so elapsed * rate cannot overflow
+        const uint32_t elapsed = std::min(now_ms - bucket->last_ms, capacity / rate_per_min + 1);
+        bucket->tokens = std::min(capacity, bucket->tokens + elapsed * rate_per_min);
+    }
+    bucket->last_ms = now_ms ? now_ms : 1;
+    return *bucket;
+}
+
+// malformed input is the client's fault (400); a well-formed line naming nothing
+// that exists is 404
+int WebInterface::http_status_for(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::OK:                 return 200;
+        case ParseStatus::UNKNOWN_GROUP:
+        case ParseStatus::UNKNOWN_COMMAND:    return 404;
+        case ParseStatus::EMPTY:
+        case ParseStatus::MISSING_PREFIX:
+        case ParseStatus::UNTERMINATED_QUOTE:
+        case ParseStatus::WRONG_ARG_COUNT:
+        case ParseStatus::COUNT:              return 400;
+    }
+    return 400;
+}
+
+void WebInterface::handle_console_message(uint8_t client, std::string_view text) {
+    if (is_disabled()) return;
+
+    std::string command_text(text);
+    while (!command_text.empty() && (command_text.back() == '\n' || command_text.back() == '\r')) command_text.pop_back();
+    if (command_text.empty()) return;
+
+    uint32_t retry_s = 0;
+    if (const char* reason = admit(http_server.ws_client_ip(client), 1, retry_s)) {
+        http_server.ws_send(client, std::string("Error: too many commands: ") + reason + "; retry in "
+                                    + std::to_string(retry_s) + " s");
+        return;
+    }
+    controller.serial_port.print("Got cmd from web console: \n" + command_text);
+    controller.command_parser.parse(command_text);
+}
+
+// GET /api/modules: {"uptime_ms":..,"modules":[{"name":..,"enabled":..,"status":{..}|null}]}
+// Written straight into the chunked response as it is produced.
+void WebInterface::handle_api_modules() {
+    if (is_disabled()) return;
+
+    http_server.begin_stream(200, "application/json");
+    xewe::json::Writer out([this](std::string_view text) { http_server.stream(text); });
+    out.begin_object();
+    out.field("uptime_ms", millis());
+    out.begin_array("modules");
+    for (const Module* module : controller.get_modules()) {
+        if (!module) continue;
+        const bool enabled = module->is_enabled();
+        out.begin_object();
+        out.field("name", module->get_module_name());
+        out.field("enabled", enabled);
+        out.key("status");
+        if (enabled) {
+            out.begin_object();
+            module->status_json(out);
+            out.end_object();
+        } else {
+            out.null();
         }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>XeWe OS Web Interface</h1>
-        <div class="input-group">
-            <input type="text" id="cmdInput" placeholder="Enter command..." autofocus autocomplete="off">
-            <button onclick="sendCmd()">Send Command</button>
-        </div>
-        <div id="flash">Command Sent</div>
-    </div>
-    <script>
-        const input = document.getElementById('cmdInput');
-        const flash = document.getElementById('flash');
-
-        input.addEventListener("keypress", function(event) {
-            if (event.key === "Enter") {
-                event.preventDefault();
-                sendCmd();
+        out.end_object();
+    }
+    out.end_array();
+    out.end_object();
+}
+
+// Firmware arrives as the raw body of POST /ota (Content-Length or chunked) and is
+// written to flash as it streams in. Query args come from the release manifest:
+// sha256 (required), offset of the part (0 for the merged image, 65536 for an app
+// image; default 65536) and chip, checked against this device when given.
+void WebInterface::handle_ota_upload() {
+    const HttpServer::Upload& upload = http_server.upload();
+    FirmwareUpdate& update = controller.system.get_firmware_update();
+
+    switch (upload.status) {
+        case HttpServer::UploadStatus::START: {
+            if (is_disabled()) {
+                http_server.send(503, "text/plain", "Web interface disabled\n");
+                return;
+            }
+            // the digest only proves the image arrived intact, not who sent it
+            if (controller.wifi.is_portal_address(http_server.local_ip())) {
+                http_server.send(403, "text/plain", "Firmware can't be updated over the setup access point\n");
+                return;
+            }
+            if (ota_token.empty()) {
+                http_server.send(403, "text/plain", "Firmware updates are off; set a token with $web_interface ota_token\n");
+                return;
             }
-        });
-
-        function sendCmd() {
-            const val = input.value.trim();
-            if(!val) return;
-
-            fetch('/cmd?c=' + encodeURIComponent(val))
-                .then(r => {
-                    if(r.ok) {
-                        input.value = '';
-                        showFlash('Command Sent');
-                    } else {
-                        showFlash('Error Sending');
-                    }
-                })
-                .catch(e => showFlash('Connection Error'));
+            if (!ota_authorized()) {
+                http_server.send(401, "text/plain", "Missing or wrong X-OTA-Token\n");
+                return;
+            }
+            if (update.state() == FirmwareUpdate::State::RECEIVING) {
+                http_server.send(409, "text/plain", "An update is already in progress\n");
+                return;
+            }
+            const std::string chip = http_server.arg("chip");
+            if (!chip.empty() && chip != FirmwareUpdate::chip_family()) {
+                http_server.send(409, "text/plain", "Firmware is for " + chip + ", this device is " + FirmwareUpdate::chip_family() + "\n");
+                return;
+            }
+            uint32_t offset = FirmwareUpdate::APP_OFFSET;
+            if (http_server.hasArg("offset") && !parse_int<uint32_t>(http_server.arg("offset"), offset)) {
+                http_server.send(400, "text/plain", "offset must be a number\n");
+                return;
+            }
+            if (!update.begin(upload.expected, offset, http_server.arg("sha256"))) {
+                http_server.send(400, "text/plain", update.error() + "\n");
+                return;
+            }
+            ota_reported = 0;
+            controller.serial_port.printf("Firmware upload started (%lu bytes) -> %s",
+                                          (unsigned long)upload.expected, update.target_label());
+            publish_ota();
+            return;
         }
+        case HttpServer::UploadStatus::WRITE:
+            if (!update.write(upload.data)) {
+                controller.serial_port.print("Firmware update failed: " + update.error());
+                publish_ota();
+                http_server.send(500, "text/plain", update.error() + "\n");
+                return;
+            }
+            // every 10%, or every OTA_REPORT_BYTES when the size is unknown
+            if (update.total() ? update.percent() >= ota_reported * 100 / update.total() + 10
+                               : update.received() >= ota_reported + OTA_REPORT_BYTES) {
+                ota_reported = update.received();
+                if (update.total()) controller.serial_port.printf("Firmware upload %u%%", (unsigned)update.percent());
+                else                controller.serial_port.printf("Firmware upload %lu bytes", (unsigned long)update.received());
+                publish_ota();
+            }
+            return;
+        case HttpServer::UploadStatus::END:
+            return;                                                 // handle_ota_done verifies
+        case HttpServer::UploadStatus::ABORTED:
+            update.abort("upload interrupted");
+            controller.serial_port.print("Firmware update failed: upload interrupted");
+            publish_ota();
+            return;
+    }
+}
+
+void WebInterface::handle_ota_done() {
+    FirmwareUpdate& update = controller.system.get_firmware_update();
+    if (!update.finish()) {
+        controller.serial_port.print("Firmware update failed: " + update.error());
+        publish_ota();
+        http_server.send(422, "text/plain", "Firmware rejected: " + update.error() + "\n");
+        return;
+    }
+    controller.serial_port.print_header(std::string("Firmware Update Verified\nRestarting into ") + update.target_label());
+    publish_ota();
+    http_server.send(200, "text/plain", std::string("Firmware verified, restarting into ") + update.target_label() + "\n");
+    ota_restart_ms = millis() + OTA_RESTART_DELAY_MS;
+    if (ota_restart_ms == 0) ota_restart_ms = 1;
+}
+
+// Compares the X-OTA-Token header with the stored token in constant time, so the
+// response time says nothing about how much of a guess was right.
+bool WebInterface::ota_authorized() const {
+    const std::string sent = http_server.header("X-OTA-Token");
+    if (ota_token.empty() || sent.size() != ota_token.size()) return false;
+    uint8_t diff = 0;
+    for (size_t i = 0; i < sent.size(); ++i) diff |= static_cast<uint8_t>(sent[i] ^ ota_token[i]);
+    return diff == 0;
+}
+
+void WebInterface::set_ota_token(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::string token(args);
+    trim(token);
+    if (token == "off") {
+        ota_token.clear();
+        controller.nvs.remove(nvs_key, "ota_token");
+        controller.serial_port.print("Firmware updates over HTTP refused until a token is set");
+        return;
+    }
+    if (token.size() < OTA_TOKEN_MIN || token.size() > OTA_TOKEN_MAX
+        || token.find_first_of(" \t\r\n") != std::string::npos) {
+        controller.serial_port.printf("Error: expected a token of %u-%u characters without spaces, or 'off'",
+                                      (unsigned)OTA_TOKEN_MIN, (unsigned)OTA_TOKEN_MAX);
+        return;
+    }
+    ota_token = token;
+    controller.nvs.write_str(nvs_key, "ota_token", ota_token);
+    controller.serial_port.print("OTA token set; uploads must send it in X-OTA-Token");
+}
+
+void WebInterface::handle_ota_status() {
+    if (is_disabled()) return;
+
+    const FirmwareUpdate& update = controller.system.get_firmware_update();
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    std::string body;
+    xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+    out.begin_object();
+    out.field("version", TO_STRING(BUILD_VERSION));
+    out.field("chip", FirmwareUpdate::chip_family());
+    out.field("running", running ? running->label : nullptr);
+    out.field("pending_verify", FirmwareUpdate::pending_verify());
+    out.field("target", update.target_label());
+    out.field("state", FirmwareUpdate::state_name(update.state()));
+    out.field("received", update.received());
+    out.field("total", update.total());
+    out.field("percent", update.percent());
+    out.field("error", update.error());
+    out.field("token_set", !ota_token.empty());
+    out.end_object();
+    http_server.send(200, "application/json", std::move(body));
+}
+
+// Prometheus scrape target; each enabled module renders its own samples straight
+// into the chunked response.
+void WebInterface::handle_metrics() {
+    if (is_disabled()) return;
+
+    http_server.begin_stream(200, "text/plain; version=0.0.4");
+    xewe::metrics::Writer out([this](std::string_view text) { http_server.stream(text); });
+    for (const Module* module : controller.get_modules()) {
+        if (module && module->is_enabled()) module->write_metrics(out);
+    }
+}
+
+// POST /api/cmd with a JSON array of command lines; they run in order and each
+// result carries the parse status and everything the command printed.
+// ?stop_on_error=1 skips the rest of the batch after the first failure.
+void WebInterface::handle_api_command_batch() {
+    if (is_disabled()) return;
+
+    std::vector<std::string> commands;
+    if (!xewe::json::parse_string_array(http_server.arg("plain"), commands, MAX_BATCH_COMMANDS)) {
+        std::string body;
+        xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+        out.begin_object();
+        out.field("error", "expected a JSON array of up to " + std::to_string(MAX_BATCH_COMMANDS) + " command strings");
+        out.end_object();
+        http_server.send(400, "application/json", std::move(body));
+        return;
+    }
+    if (rate_per_min && commands.size() > rate_burst) {
+        std::string body;
+        xewe::json::Writer out([&body](std::string_view text) { body.append(text); });
+        out.begin_object();
+        out.field("error", "batch is larger than the rate limit burst");
+        out.field("burst", rate_burst);
+        out.end_object();
+        http_server.send(413, "application/json", std::move(body));
+        return;
+    }
+    if (!admit_command(commands.size(), true)) return;
+    const bool stop_on_error = http_server.arg("stop_on_error") == "1";
+
+    http_server.begin_stream(200, "application/json");
+    xewe::json::Writer out([this](std::string_view text) { http_server.stream(text); });
+    out.begin_object();
+    out.begin_array("results");
+
+    size_t executed = 0;
+    size_t failed   = 0;
+    std::string output;
+    bool truncated = false;
+    for (const auto& command_text : commands) {
+        if (stop_on_error && failed > 0) break;
+
+        const ParseStatus status = run_captured(command_text, output, truncated);
+
+        executed++;
+        if (status != ParseStatus::OK) failed++;
+        out.begin_object();
+        out.field("command", command_text);
+        out.field("status", CommandParser::status_name(status));
+        out.field("exit_code", static_cast<uint8_t>(status));
+        out.field("output", output);
+        out.field("truncated", truncated);
+        out.end_object();
+    }
+
+    out.end_array();
+    out.field("executed", executed);
+    out.field("failed", failed);
+    out.field("skipped", commands.size() - executed);
+    out.end_object();
+}
+
+// One frame per batch, shared by every console client; clients that fall too far
+// behind are dropped by the server rather than slowing this down.
+void WebInterface::flush_console() {
+    if (console_backlog.empty()) return;
+    http_server.ws_broadcast(console_backlog);
+    console_backlog.clear();
+}
+
+void WebInterface::set_events_interval(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    uint32_t ms = 0;
+    if (!parse_int<uint32_t>(args, ms) || ms < EVENTS_MIN_MS || ms > EVENTS_MAX_MS) {
+        controller.serial_port.printf("Error: expected an interval between %lu and %lu ms",
+                                      (unsigned long)EVENTS_MIN_MS, (unsigned long)EVENTS_MAX_MS);
+        return;
+    }
+    events_interval_ms = ms;
+    controller.nvs.write_uint32(nvs_key, "ev_ms", events_interval_ms);
+    controller.serial_port.printf("Telemetry pushed every %lu ms", (unsigned long)events_interval_ms);
+}
+
+void WebInterface::set_rate_limit(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::vector<std::string> parts = split_args(args);
+    uint16_t per_min = 0;
+    uint8_t  burst   = 0;
+    if (parts.size() != 2 || !parse_int<uint16_t>(parts[0], per_min) || !parse_int<uint8_t>(parts[1], burst)
+        || per_min > RATE_MAX_PER_MIN || burst < 1 || burst > RATE_MAX_BURST) {
+        controller.serial_port.printf("Error: expected <commands per minute 0-%u> <burst 1-%u>",
+                                      (unsigned)RATE_MAX_PER_MIN, (unsigned)RATE_MAX_BURST);
+        return;
+    }
+    rate_per_min = per_min;
+    rate_burst   = burst;
+    buckets.fill({});
+    controller.nvs.write_uint16(nvs_key, "rl_rate", rate_per_min);
+    controller.nvs.write_uint8(nvs_key, "rl_burst", rate_burst);
+    if (rate_per_min) controller.serial_port.printf("Web commands limited to %u/min per client, burst %u",
+                                                    (unsigned)rate_per_min, (unsigned)rate_burst);
+    else              controller.serial_port.print("Web command rate limit off");
+}
+
+void WebInterface::set_inflight_limit(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    uint8_t limit = 0;
+    if (!parse_int<uint8_t>(args, limit) || limit > INFLIGHT_MAX) {
+        controller.serial_port.printf("Error: expected 0-%u (0 = unlimited)", (unsigned)INFLIGHT_MAX);
+        return;
+    }
+    inflight_limit = limit;
+    controller.nvs.write_uint8(nvs_key, "inflight", inflight_limit);
+    if (inflight_limit) controller.serial_port.printf("At most %u web command lines per loop pass", (unsigned)inflight_limit);
+    else                controller.serial_port.print("Web command lines per loop pass unlimited");
+}
+
+WebInterface::Telemetry WebInterface::sample_telemetry() const {
+    Telemetry now;
+    now.free_heap     = ESP.getFreeHeap();
+    now.min_free_heap = ESP.getMinFreeHeap();
+    now.loop_hz       = controller.get_loop_rate();
+    now.rssi          = controller.wifi.is_connected() ? static_cast<int8_t>(WiFi.RSSI()) : 0;
+    return now;
+}
+
+// A new subscriber gets every field once; later "telemetry" events are deltas against
+// what was last broadcast, and carry absolute values so nothing has to be accumulated.
+void WebInterface::send_snapshot(uint8_t client) {
+    const Telemetry now = sample_telemetry();
+    const Wifi::LinkState link = controller.wifi.get_link_state();
+
+    std::string frame;
+    xewe::json::Writer out([&frame](std::string_view text) { frame.append(text); });
+    out.begin_object();
+    out.field("t", millis());
+    out.field("heap", now.free_heap);
+    out.field("min_heap", now.min_free_heap);
+    out.field("loop_hz", now.loop_hz);
+    out.field("rssi", now.rssi);
+    out.field("wifi", Wifi::link_state_name(link));
+    out.field("interval_ms", events_interval_ms);
+    out.end_object();
+    http_server.sse_send(client, "snapshot", frame);
+}
+
+// Runs once per cadence tick. The frame is encoded once and the same bytes are queued
+// to every subscriber; a tick where nothing moved sends nothing.
+void WebInterface::publish_telemetry() {
+    if (http_server.sse_clients() == 0) return;
+
+    const Telemetry now = sample_telemetry();
+    const auto moved = [](uint32_t a, uint32_t b, uint32_t threshold) {
+        return (a > b ? a - b : b - a) >= threshold;
+    };
+
+    std::string frame;
+    xewe::json::Writer out([&frame](std::string_view text) { frame.append(text); });
+    out.begin_object();
+    out.field("t", millis());
+    bool changed = false;
+    if (moved(now.free_heap, telemetry_sent.free_heap, 512)) {
+        out.field("heap", now.free_heap);
+        telemetry_sent.free_heap = now.free_heap;
+        changed = true;
+    }
+    if (now.min_free_heap != telemetry_sent.min_free_heap) {
+        out.field("min_heap", now.min_free_heap);
+        telemetry_sent.min_free_heap = now.min_free_heap;
+        changed = true;
+    }
+    if (moved(now.loop_hz, telemetry_sent.loop_hz, std::max<uint32_t>(1, telemetry_sent.loop_hz / 20))) {
+        out.field("loop_hz", now.loop_hz);
+        telemetry_sent.loop_hz = now.loop_hz;
+        changed = true;
+    }
+    if (abs(now.rssi - telemetry_sent.rssi) >= 2 || (now.rssi == 0) != (telemetry_sent.rssi == 0)) {
+        out.field("rssi", now.rssi);
+        telemetry_sent.rssi = now.rssi;
+        changed = true;
+    }
+    out.end_object();
+    if (changed) http_server.sse_broadcast("telemetry", frame);
+}
+
+void WebInterface::publish_wifi(Wifi::LinkState state) {
+    if (is_disabled() || http_server.sse_clients() == 0) return;
+
+    std::string frame;
+    xewe::json::Writer out([&frame](std::string_view text) { frame.append(text); });
+    out.begin_object();
+    out.field("t", millis());
+    out.field("state", Wifi::link_state_name(state));
+    if (state == Wifi::LinkState::CONNECTED) {
+        out.field("ssid", controller.wifi.get_ssid(false));
+        out.field("ip", controller.wifi.get_local_ip(false));
+    }
+    out.end_object();
+    http_server.sse_broadcast("wifi", frame);
+}
+
+void WebInterface::publish_ota() {
+    if (http_server.sse_clients() == 0) return;
+
+    const FirmwareUpdate& update = controller.system.get_firmware_update();
+    std::string frame;
+    xewe::json::Writer out([&frame](std::string_view text) { frame.append(text); });
+    out.begin_object();
+    out.field("t", millis());
+    out.field("state", FirmwareUpdate::state_name(update.state()));
+    out.field("received", update.received());
+    out.field("total", update.total());
+    out.field("percent", update.percent());
+    if (!update.error().empty()) out.field("error", update.error());
+    out.end_object();
+    http_server.sse_broadcast("ota", frame);
+}
+
+void WebInterface::publish_button(uint8_t pin, bool pressed, uint32_t at_us) {
+    if (is_disabled() || http_server.sse_clients() == 0) return;
+
+    char frame[80];
+    const int n = snprintf(frame, sizeof(frame), "{\"t\":%lu,\"us\":%lu,\"pin\":%u,\"pressed\":%s}",
+                           static_cast<unsigned long>(millis()), static_cast<unsigned long>(at_us),
+                           static_cast<unsigned>(pin), pressed ? "true" : "false");
+    if (n > 0) http_server.sse_broadcast("button", std::string_view(frame, static_cast<size_t>(n)));
+}
+
+// Runs before routing. The setup access point is open to anyone in radio range, so a
+// request that came in over it only reaches the /provision pages: any other GET (OS
+// captive checks such as /generate_204 or /hotspot-detect.html included) is bounced to
+// the portal page, and everything else (commands, the console, OTA) gets 403. Clients
+// on the station side are not affected.
+void WebInterface::guard_portal() {
+    if (!controller.wifi.is_portal_address(http_server.local_ip())) return;
+
+    const std::string& uri = http_server.uri();
+    if (uri == "/provision" || uri.rfind("/provision/", 0) == 0) return;
+    if (http_server.method() == HTTP_GET || http_server.method() == HTTP_HEAD) {
+        http_server.sendHeader("Location", "http://" + controller.wifi.get_portal_ip() + "/provision", true);
+        http_server.send(302, "text/plain");
+        return;
+    }
+    http_server.send(403, "text/plain", "Only the provisioning page is served on the setup access point");
+}
+
+void WebInterface::handle_not_found() {
+    if (is_disabled()) return;
+    http_server.send(404, "text/plain", "Not Found");
+}
+
+void WebInterface::serve_provision_page() {
+    if (is_disabled()) return;
+    serve_asset(WEB_ASSET_PROVISION_HTML);
+}
+
+// Assets are stored gzipped (build/scripts/embed_assets.py) and sent as-is; every
+// browser accepts gzip, so there is no uncompressed fallback. The ETag is a hash of
+// the source file, so a revalidation after a firmware update without UI changes
+// still answers 304 and costs no body bytes.
+void WebInterface::serve_asset(const WebAsset& asset) {
+    http_server.sendHeader("ETag", asset.etag);
+    http_server.sendHeader("Cache-Control", "no-cache");
+    http_server.sendHeader("Vary", "Accept-Encoding");
+
+    const std::string if_none_match = http_server.header("If-None-Match");
+    if (!if_none_match.empty()
+        && (if_none_match == "*" || if_none_match.find(asset.etag) != std::string::npos)) {
+        http_server.send(304);
+        return;
+    }
+    http_server.sendHeader("Content-Encoding", "gzip");
+    http_server.send_P(200, asset.content_type, reinterpret_cast<const char*>(asset.data), asset.length);
+}
+
+void WebInterface::handle_provision_networks() {
+    if (is_disabled()) return;
+    http_server.send(200, "application/json", controller.wifi.scan_results_json());
+}
+
+void WebInterface::handle_provision_save() {
+    if (is_disabled()) return;
+    // credentials may only be set from the portal itself: the portal can stay open
+    // after the link is up, and the station side must not be able to change them
+    if (!controller.wifi.is_provisioning()) {
+        http_server.send(403, "text/plain", "Provisioning portal is closed");
+        return;
+    }
+    if (!controller.wifi.is_portal_address(http_server.local_ip())) {
+        http_server.send(403, "text/plain", "Credentials can only be set over the provisioning access point");
+        return;
+    }
+    if (!http_server.hasArg("ssid")) {
+        http_server.send(400, "text/plain", "Missing SSID");
+        return;
+    }
+
+    const std::string ssid     = http_server.arg("ssid").c_str();
+    const std::string password = http_server.hasArg("password") ? http_server.arg("password").c_str() : "";
+    if (!controller.wifi.provision(ssid, password)) {
+        http_server.send(400, "text/plain", "Invalid SSID or password, or network list full");
+        return;
+    }
+    controller.serial_port.print("Got WiFi credentials from provisioning portal for '" + ssid + "'");
+    http_server.send(200, "text/plain", "OK");
+}
+
+void WebInterface::handle_provision_status() {
+    if (is_disabled()) return;
+
+    const bool connected = controller.wifi.is_connected();
+    std::string json = "{\"connected\":";
+    json += connected ? "true" : "false";
+    json += ",\"ssid\":\"" + json_escape(connected ? controller.wifi.get_ssid(false) : std::string()) + "\"";
+    json += ",\"ip\":\"" + (connected ? controller.wifi.get_local_ip(false) : std::string()) + "\"}";
+    http_server.send(200, "application/json", json.c_str());
+}
 
-        let flashTimer;
-        function showFlash(msg) {
-            flash.textContent = msg;
-            flash.style.opacity = 1;
-            clearTimeout(flashTimer);
-            flashTimer = setTimeout(() => {
-                flash.style.opacity = 0;
-            }, 2000);
-        }
-    </script>
-</body>
-</html>
-)rawliteral";
\ No newline at end of file
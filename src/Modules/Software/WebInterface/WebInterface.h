@@ -11,8 +11,14 @@
 #pragma once
 
 #include "../../Module/Module.h"
+#include "HttpServer.h"
+#include "../Wifi/Wifi.h"
+#include "../CommandParser/CommandParser.h"
 
-#include <WebServer.h>
+struct WebAsset;
+
+#include <algorithm>
+#include <array>
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -28,13 +34,104 @@ public:
 
     void                        loop                        ()                              override;
     string                      status                      (const bool verbose=false)      const override;
+    void                        status_json                 (xewe::json::Writer& out)       const override;
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
 
-    WebServer&                  get_server                  ()                              { return http_server; }
+    HttpServer&                 get_server                  ()                              { return http_server; }
 private:
-    WebServer                   http_server                  {80};
+    static constexpr size_t     CONSOLE_FLUSH_BYTES         = 2048; // console output is batched into frames of up to this
+    static constexpr size_t     MAX_BATCH_COMMANDS          = 16;
+    static constexpr size_t     COMMAND_OUTPUT_BYTES        = 4096; // captured per command
+    static constexpr uint32_t   EVENTS_DEFAULT_MS           = 1000; // /events telemetry cadence
+    static constexpr uint32_t   EVENTS_MIN_MS               = 200;
+    static constexpr uint32_t   EVENTS_MAX_MS               = 60000;
+    static constexpr uint32_t   OTA_RESTART_DELAY_MS        = 1000; // lets the final response reach the client
+    static constexpr size_t     OTA_REPORT_BYTES            = 262144;// progress step when the size is unknown
+    static constexpr size_t     OTA_TOKEN_MIN               = 8;
+    static constexpr size_t     OTA_TOKEN_MAX               = 64;
+    static constexpr uint16_t   RATE_DEFAULT_PER_MIN        = 120;  // commands per client, 0 = unlimited
+    static constexpr uint16_t   RATE_MAX_PER_MIN            = 6000;
+    static constexpr uint8_t    RATE_DEFAULT_BURST          = 10;
+    static constexpr uint8_t    RATE_MAX_BURST              = 60;
+    static constexpr uint8_t    RATE_CLIENTS                = 8;    // buckets kept; the stalest is recycled
+    static constexpr uint32_t   TOKEN_UNITS                 = 60000;// one token; refill is rate units per ms
+    static constexpr uint8_t    INFLIGHT_DEFAULT            = 2;    // command requests per loop pass, 0 = unlimited
+    static constexpr uint8_t    INFLIGHT_MAX                = 16;
+
+    // last values pushed on /events; a field goes out again only once it moves
+    // past its threshold, so an idle device sends (almost) nothing
+    struct Telemetry {
+        uint32_t                free_heap                   {0};
+        uint32_t                min_free_heap               {0};
+        uint32_t                loop_hz                     {0};
+        int8_t                  rssi                        {0};
+    };
+
+    // per-client token bucket for web commands (/cmd, /api/cmd, /console), in TOKEN_UNITS
+    struct CommandBucket {
+        uint32_t                ip                          {0};
+        uint32_t                tokens                      {0};
+        uint32_t                last_ms                     {0};
+    };
 
+    HttpServer                  http_server                 {80};
+    std::string                 console_backlog;
+    Telemetry                   telemetry_sent;
+    uint32_t                    events_interval_ms          {EVENTS_DEFAULT_MS};
+    uint32_t                    last_telemetry_ms           {0};
+    size_t                      ota_reported                {0};    // bytes at the last progress report
+    uint32_t                    ota_restart_ms              {0};    // 0 = no restart scheduled
+    std::string                 ota_token;                          // required in X-OTA-Token; empty = uploads refused
+    std::array<CommandBucket, RATE_CLIENTS> buckets;
+    uint16_t                    rate_per_min                {RATE_DEFAULT_PER_MIN};
+    uint8_t                     rate_burst                  {RATE_DEFAULT_BURST};
+    uint8_t                     inflight_limit              {INFLIGHT_DEFAULT};
+    uint8_t                     inflight                    {0};    // command lines run this loop pass
+    uint32_t                    rate_limited                {0};    // turned away by a client's bucket
+    uint32_t                    shed                        {0};    // turned away by the in-flight cap
+
+    void                        print_address                 ()                            const;
+    void                        print_stats                   ()                            const;
     void                        serve_main_page               ();
     void                        handle_command_request        ();
-
-    static const char           INDEX_HTML                  [] PROGMEM;
+    ParseStatus                 run_captured                  (const std::string& command_text,
+                                                               std::string& output,
+                                                               bool& truncated);
+    static int                  http_status_for               (ParseStatus status);
+    const char*                 admit                         (uint32_t ip,
+                                                               size_t cost,
+                                                               uint32_t& retry_s);
+    bool                        admit_command                 (size_t cost,
+                                                               bool json);
+    CommandBucket&              bucket_for                    (uint32_t ip,
+                                                               uint32_t now_ms);
+    void                        set_rate_limit                (std::string_view args);
+    void                        set_inflight_limit            (std::string_view args);
+    void                        handle_api_modules            ();
+    void                        handle_api_command_batch      ();
+    void                        handle_metrics                ();
+    void                        handle_ota_upload             ();
+    void                        handle_ota_done               ();
+    void                        handle_ota_status             ();
+    bool                        ota_authorized                ()                            const;
+    void                        set_ota_token                 (std::string_view args);
+    void                        serve_provision_page          ();
+    void                        handle_provision_networks     ();
+    void                        handle_provision_save         ();
+    void                        handle_provision_status       ();
+    void                        handle_not_found              ();
+    void                        guard_portal                  ();
+    void                        serve_asset                   (const WebAsset& asset);
+    void                        handle_console_message        (uint8_t client,
+                                                               std::string_view text);
+    void                        flush_console                 ();
+    void                        set_events_interval           (std::string_view args);
+    Telemetry                   sample_telemetry              ()                            const;
+    void                        send_snapshot                 (uint8_t client);
+    void                        publish_telemetry             ();
+    void                        publish_wifi                  (Wifi::LinkState state);
+    void                        publish_button                (uint8_t pin,
+                                                               bool pressed,
+                                                               uint32_t at_us);
+    void                        publish_ota                   ();
 };
@@ -0,0 +1,287 @@
+#pragma once
+// Auto-generated by build/scripts/embed_assets.py — DO NOT EDIT.
+// Sources: src/Modules/Software/WebInterface/assets/
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#define PROGMEM
+#endif
+
+struct WebAsset {
+    const char*     content_type;
+    const uint8_t*  data;           // gzip
+    size_t          length;
+    const char*     etag;           // quoted, strong
+};
+
+// index.html: 8173 -> 2666 bytes
+static const uint8_t WEB_ASSET_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x59, 0x6d, 0x73, 0xdb, 0x36,
+    0x12, 0xfe, 0xde, 0x5f, 0x81, 0xa8, 0x77, 0x15, 0x79, 0xb1, 0x28, 0x39, 0x69, 0x3a, 0x1d, 0xd9,
+    0x72, 0xa7, 0x4d, 0x93, 0xc6, 0x37, 0x6e, 0x9d, 0x89, 0x9d, 0x6b, 0x6f, 0xda, 0x4e, 0x07, 0x22,
+    0x41, 0x91, 0x35, 0x49, 0xf0, 0x00, 0xd0, 0xb2, 0x2f, 0xf5, 0x7f, 0xbf, 0x67, 0x01, 0x52, 0xa2,
+    0x48, 0x4a, 0x71, 0x4e, 0x9a, 0xb1, 0x48, 0xee, 0x62, 0xb1, 0xaf, 0xcf, 0x2e, 0xe8, 0xd3, 0x27,
+    0xdf, 0x5f, 0xbe, 0xbc, 0xfe, 0xf7, 0xdb, 0x57, 0x2c, 0x31, 0x79, 0x76, 0xf6, 0xd9, 0x29, 0xfd,
+    0xb0, 0x8c, 0x17, 0xab, 0xc5, 0x48, 0x14, 0x23, 0x7a, 0x20, 0x78, 0x74, 0xf6, 0x19, 0xc3, 0xe7,
+    0x34, 0x17, 0x86, 0xb3, 0x30, 0xe1, 0x4a, 0x0b, 0xb3, 0x18, 0x55, 0x26, 0x9e, 0x7c, 0x3d, 0x6a,
+    0x93, 0x0a, 0x9e, 0x8b, 0xc5, 0xe8, 0x36, 0x15, 0xeb, 0x52, 0x2a, 0x33, 0x62, 0xa1, 0x2c, 0x8c,
+    0x28, 0xc0, 0xba, 0x4e, 0x23, 0x93, 0x2c, 0x22, 0x71, 0x9b, 0x86, 0x62, 0x62, 0x6f, 0x8e, 0x58,
+    0x5a, 0xa4, 0x26, 0xe5, 0xd9, 0x44, 0x87, 0x3c, 0x13, 0x8b, 0xe3, 0x46, 0x90, 0x49, 0x4d, 0x26,
+    0xce, 0x7e, 0x11, 0x3f, 0x0b, 0x76, 0x79, 0xc5, 0x7e, 0x16, 0x4b, 0x76, 0x0e, 0x21, 0x2a, 0xe6,
+    0xa1, 0x38, 0x9d, 0x3a, 0xa2, 0x63, 0xd4, 0xe6, 0xbe, 0xb9, 0xa6, 0xcf, 0x5c, 0x49, 0x69, 0xd8,
+    0x87, 0xcd, 0x3d, 0x7d, 0x26, 0x93, 0xe5, 0x6a, 0xce, 0x3e, 0x3f, 0x7e, 0x46, 0xdf, 0x93, 0x0e,
+    0x29, 0x26, 0x92, 0x98, 0xd1, 0xb7, 0x4b, 0x4a, 0x8b, 0xb2, 0x32, 0xf5, 0x5a, 0x41, 0xdf, 0x2e,
+    0x03, 0x0f, 0x43, 0xd8, 0x05, 0xf2, 0x6c, 0xb6, 0x0c, 0xa3, 0x2f, 0xbb, 0xe4, 0xa5, 0x54, 0x91,
+    0x50, 0x20, 0x3f, 0x7f, 0xfe, 0x7c, 0x4b, 0x7b, 0xd8, 0x5c, 0x2d, 0x65, 0x74, 0xdf, 0x51, 0x75,
+    0xc9, 0xc3, 0x9b, 0x95, 0x92, 0x55, 0x11, 0x4d, 0x42, 0x99, 0x49, 0x2c, 0xbe, 0xe5, 0xca, 0x23,
+    0x03, 0xfc, 0x5d, 0xe9, 0x3b, 0xd4, 0xb8, 0x4b, 0x8d, 0xe1, 0xf1, 0x49, 0xcc, 0xf3, 0x34, 0xbb,
+    0x9f, 0xb3, 0xf1, 0x95, 0x58, 0x49, 0xc1, 0xde, 0x9f, 0x8f, 0x8f, 0xd8, 0x35, 0x4f, 0x64, 0xce,
+    0x8f, 0xd8, 0x0f, 0xa2, 0x10, 0xb7, 0xf8, 0xfd, 0x97, 0x50, 0x11, 0x2f, 0x70, 0xa1, 0x79, 0xa1,
+    0x27, 0x5a, 0xa8, 0x34, 0xde, 0x95, 0x14, 0xa5, 0xba, 0xcc, 0x38, 0xa4, 0xc4, 0x99, 0xb8, 0xeb,
+    0x6c, 0x82, 0x27, 0x93, 0x28, 0x55, 0x22, 0x34, 0xa9, 0x2c, 0xe6, 0xa4, 0x52, 0x95, 0x17, 0xbb,
+    0x3c, 0x3c, 0x4b, 0x57, 0xc5, 0x24, 0x35, 0x22, 0xd7, 0x60, 0x10, 0x14, 0xc2, 0x5d, 0x86, 0x3f,
+    0x2b, 0x6d, 0xd2, 0xf8, 0x7e, 0x52, 0xe7, 0xc8, 0x30, 0x53, 0x22, 0xd2, 0x55, 0x02, 0xda, 0xf1,
+    0x6c, 0x76, 0x9b, 0xec, 0x92, 0x72, 0xae, 0x56, 0x29, 0x36, 0xef, 0x04, 0xaf, 0xe4, 0x51, 0x94,
+    0x16, 0x88, 0xdc, 0xb3, 0x59, 0xd9, 0x51, 0x7b, 0x29, 0xef, 0x26, 0x3a, 0xfd, 0xaf, 0xa5, 0xba,
+    0x08, 0x21, 0x50, 0x77, 0x43, 0xf1, 0x09, 0x48, 0x29, 0x9e, 0x16, 0x42, 0x75, 0xa2, 0x64, 0x53,
+    0xd7, 0xaa, 0xf3, 0xf7, 0xae, 0x36, 0x77, 0x93, 0x9a, 0xf8, 0xf5, 0xac, 0xb7, 0xb3, 0x11, 0x77,
+    0x66, 0x62, 0x3d, 0xd2, 0x37, 0x73, 0xbb, 0x6b, 0x72, 0xdc, 0xd9, 0xcd, 0x06, 0x73, 0x5d, 0xbb,
+    0xe0, 0xf9, 0xac, 0x63, 0x69, 0x26, 0x0c, 0x04, 0x4d, 0x74, 0xc9, 0x43, 0x6b, 0xd2, 0x71, 0x77,
+    0x57, 0xe7, 0x21, 0xd8, 0x68, 0x8c, 0xcc, 0xe1, 0x10, 0x25, 0xf2, 0x03, 0xa9, 0xe4, 0x52, 0xda,
+    0x1f, 0x52, 0xec, 0xf3, 0x4c, 0xae, 0x3a, 0xaa, 0x35, 0x81, 0x79, 0xf1, 0x62, 0x6f, 0x5c, 0xf0,
+    0x3d, 0x86, 0x27, 0xf6, 0x06, 0xe8, 0xb8, 0xe7, 0x26, 0x79, 0x8b, 0x3a, 0xcf, 0xe4, 0x7a, 0x82,
+    0xac, 0xe3, 0x95, 0x91, 0xfb, 0x9d, 0x98, 0x89, 0xd8, 0xec, 0x52, 0xd7, 0x09, 0x72, 0xcd, 0x3a,
+    0x43, 0xcc, 0x59, 0xa9, 0x80, 0x32, 0x8a, 0x97, 0x1d, 0x16, 0xc4, 0x7c, 0xb2, 0x54, 0x82, 0xdf,
+    0x20, 0xfe, 0xf4, 0x03, 0x69, 0xd9, 0x81, 0xf2, 0x79, 0x29, 0x0b, 0x2d, 0x33, 0xae, 0x8f, 0xd8,
+    0xf8, 0xa5, 0xac, 0x54, 0x8a, 0x6c, 0xf8, 0x49, 0xac, 0x51, 0x4b, 0xb9, 0x2c, 0xa4, 0xdd, 0x69,
+    0x60, 0x31, 0x12, 0x0c, 0x0a, 0x1c, 0x3f, 0xef, 0x27, 0x9f, 0x83, 0x04, 0x44, 0x89, 0x41, 0x6a,
+    0x1a, 0x35, 0xf5, 0x6d, 0x9f, 0xfb, 0x43, 0xcc, 0x13, 0xc5, 0xa3, 0xb4, 0x42, 0xf9, 0xbc, 0xe8,
+    0x09, 0xdb, 0x03, 0x16, 0x0d, 0x6e, 0x0d, 0x46, 0x31, 0x70, 0x54, 0x5a, 0x57, 0x76, 0xa2, 0x79,
+    0xa0, 0xd6, 0x57, 0xbc, 0xec, 0x86, 0x6a, 0x2b, 0xd2, 0x4a, 0xfc, 0xd5, 0xdc, 0x97, 0x40, 0x7d,
+    0x0a, 0xcf, 0xe8, 0xf7, 0x6e, 0x06, 0x13, 0x52, 0x60, 0xc7, 0x35, 0x64, 0xec, 0x4b, 0x83, 0x17,
+    0xc3, 0xae, 0x3a, 0x60, 0xfd, 0x27, 0xb9, 0xf2, 0xf1, 0xae, 0x7a, 0x24, 0xba, 0xd6, 0x11, 0xfe,
+    0xaa, 0x97, 0xbd, 0x95, 0xc9, 0x00, 0x19, 0x73, 0x56, 0xc8, 0xa2, 0x93, 0x19, 0x46, 0x01, 0x64,
+    0x53, 0x07, 0x96, 0xb5, 0x75, 0x76, 0x23, 0x36, 0x0b, 0x9e, 0xe9, 0xc7, 0x39, 0x76, 0x1e, 0xcb,
+    0xb0, 0xd2, 0xdd, 0xa6, 0xd1, 0x92, 0xf5, 0x88, 0x3a, 0x5e, 0x56, 0x40, 0x82, 0xa2, 0x23, 0x63,
+    0x27, 0x10, 0xec, 0xd9, 0x5e, 0x6f, 0xf7, 0xad, 0xfa, 0x7f, 0xb3, 0xb4, 0xa7, 0x61, 0xcf, 0xf1,
+    0xcb, 0x41, 0xc7, 0x37, 0x48, 0xb8, 0x94, 0x59, 0xf4, 0x09, 0x71, 0x09, 0x2b, 0xa5, 0x49, 0x74,
+    0x29, 0xd3, 0x7e, 0x83, 0x69, 0x47, 0x46, 0x12, 0x92, 0x9a, 0xfb, 0xbd, 0x41, 0x71, 0xee, 0x9b,
+    0x73, 0x74, 0xbd, 0x5b, 0xc1, 0x3e, 0x34, 0xfc, 0x80, 0xba, 0xe0, 0xeb, 0x93, 0x36, 0x5c, 0xc6,
+    0xa9, 0xca, 0xd7, 0x5c, 0x89, 0x8e, 0xa7, 0x6b, 0x3c, 0x36, 0xb2, 0x1c, 0x02, 0xbf, 0x83, 0x0d,
+    0x73, 0x38, 0x33, 0xe2, 0x34, 0x13, 0x9f, 0x50, 0x72, 0x8f, 0xcf, 0xed, 0x2f, 0x87, 0xcb, 0xfd,
+    0xf3, 0x78, 0xfd, 0x56, 0xc9, 0x95, 0x12, 0x5a, 0x3f, 0xbe, 0x2f, 0xee, 0xb3, 0xb9, 0x2d, 0x16,
+    0x20, 0x9b, 0x7c, 0x92, 0xb3, 0x9a, 0xf6, 0xd3, 0x6f, 0xf2, 0x2d, 0x33, 0x10, 0x96, 0x5e, 0xcb,
+    0xdb, 0xc6, 0xec, 0x31, 0x79, 0xf0, 0xa2, 0x97, 0x07, 0xa7, 0xd3, 0x7a, 0xec, 0x3c, 0x9d, 0xba,
+    0xb9, 0xf8, 0x94, 0x66, 0xb9, 0x7a, 0x22, 0x8d, 0xd2, 0x5b, 0x16, 0xc2, 0x16, 0xbd, 0x18, 0x6d,
+    0x06, 0x88, 0xd1, 0x76, 0x42, 0x3d, 0x4d, 0x8e, 0xf7, 0xcd, 0xb5, 0xa0, 0x6c, 0xd9, 0xd0, 0xbd,
+    0x58, 0x1a, 0x2d, 0x46, 0xe8, 0xba, 0xa3, 0xb3, 0xd3, 0x29, 0x6e, 0x5b, 0xc4, 0xd6, 0x1e, 0x2d,
+    0x3c, 0x6f, 0xed, 0x62, 0xb9, 0x2c, 0x89, 0xb5, 0xf0, 0xc3, 0x0a, 0x0c, 0xf3, 0xe8, 0x9c, 0x08,
+    0x23, 0x06, 0xb4, 0x0f, 0x45, 0x82, 0x3a, 0x12, 0x6a, 0x31, 0x7a, 0x45, 0x7a, 0x20, 0x3b, 0xf2,
+    0x9c, 0x17, 0x51, 0x10, 0x04, 0x23, 0xdb, 0x7c, 0x1d, 0xde, 0xd0, 0x15, 0x28, 0x25, 0x86, 0x0d,
+    0x88, 0x92, 0x71, 0xdc, 0xdd, 0xa9, 0xc6, 0x14, 0x59, 0x84, 0x59, 0x1a, 0xde, 0x2c, 0x46, 0x5a,
+    0x14, 0xd1, 0xcb, 0x3c, 0xf2, 0xfc, 0xd1, 0xd9, 0x15, 0x2e, 0xd1, 0x44, 0xad, 0xd8, 0xd3, 0xa9,
+    0x63, 0x6c, 0x59, 0x32, 0x85, 0x29, 0x1f, 0x37, 0xcc, 0x2a, 0xde, 0x14, 0xd4, 0x21, 0x33, 0x6d,
+    0x31, 0x38, 0xee, 0xf5, 0x6b, 0x7b, 0x4d, 0x38, 0x53, 0xe2, 0xf0, 0x11, 0x2c, 0xd3, 0x62, 0xc4,
+    0xec, 0xd1, 0x61, 0x31, 0x7a, 0xdd, 0xd4, 0x66, 0x9a, 0xf3, 0xd5, 0xa3, 0x05, 0xfe, 0xc8, 0x8b,
+    0x34, 0x16, 0xda, 0xb4, 0x84, 0xfe, 0xa9, 0xe5, 0x56, 0xea, 0x3b, 0x91, 0x09, 0xae, 0x05, 0xb2,
+    0xd6, 0xf1, 0x39, 0xea, 0x01, 0xe1, 0x25, 0x0c, 0xa5, 0x79, 0xa4, 0xd9, 0xe0, 0x5a, 0xde, 0xe0,
+    0xb4, 0xb5, 0x1b, 0x97, 0xcb, 0xeb, 0x6f, 0x99, 0x71, 0xcf, 0xfb, 0x61, 0x68, 0x76, 0xbe, 0x12,
+    0x06, 0xce, 0x67, 0x26, 0x11, 0xcc, 0x1d, 0xaf, 0x50, 0x8b, 0x26, 0x61, 0x7f, 0x5b, 0x8b, 0xe5,
+    0x1f, 0x69, 0x93, 0x60, 0x4c, 0x1a, 0xfe, 0x87, 0x13, 0xf5, 0x91, 0xf0, 0x55, 0x65, 0xc4, 0x8d,
+    0x68, 0x9c, 0x44, 0x51, 0x7c, 0x6f, 0x9f, 0xb0, 0xe6, 0xd1, 0xc7, 0x03, 0x59, 0x36, 0x10, 0xe1,
+    0x2c, 0x6b, 0x10, 0x63, 0x44, 0x33, 0xf2, 0x62, 0x04, 0x88, 0x18, 0x01, 0x82, 0xb2, 0x0a, 0xba,
+    0xe3, 0x2a, 0x49, 0xa3, 0x48, 0x14, 0x36, 0xcb, 0x1d, 0x5b, 0x27, 0x23, 0xac, 0x0c, 0x82, 0x07,
+    0xaa, 0x84, 0xcd, 0x3e, 0xed, 0x4b, 0x1d, 0xaa, 0xb4, 0x34, 0xdb, 0x65, 0xa8, 0x3c, 0x6d, 0x1c,
+    0x4c, 0xb2, 0x05, 0x8b, 0x90, 0xc5, 0x39, 0xc0, 0x34, 0x58, 0x09, 0xf3, 0x2a, 0x13, 0x74, 0xf9,
+    0xdd, 0xfd, 0x79, 0xe4, 0x8d, 0x9b, 0x5a, 0x18, 0xb7, 0x60, 0xd0, 0x2d, 0x75, 0x68, 0x74, 0x60,
+    0xa9, 0x65, 0xe8, 0xaf, 0xa3, 0x21, 0xf9, 0xc0, 0x2a, 0x90, 0xfb, 0x6b, 0x2e, 0x2e, 0x7f, 0xf8,
+    0xe3, 0xe2, 0xfc, 0xc7, 0xf3, 0x6b, 0xac, 0x84, 0x67, 0x66, 0xed, 0x19, 0x1f, 0xb1, 0xc6, 0x78,
+    0x13, 0xde, 0x08, 0xb2, 0xa3, 0xa8, 0x68, 0x54, 0xdd, 0xd0, 0xa6, 0x53, 0x76, 0x41, 0x4d, 0x28,
+    0xb4, 0x23, 0x2a, 0xb0, 0x0e, 0xc3, 0x07, 0x19, 0xac, 0x0d, 0xe6, 0xda, 0x1c, 0xae, 0x2f, 0xec,
+    0x30, 0xcd, 0x38, 0x01, 0xcd, 0x95, 0x13, 0x82, 0x2a, 0x6c, 0x8a, 0x5c, 0xb3, 0x95, 0xb4, 0xed,
+    0x99, 0xf2, 0xa6, 0x2d, 0x54, 0xe3, 0x00, 0xcf, 0xd6, 0xfc, 0x3e, 0x60, 0x3f, 0x23, 0x8b, 0x20,
+    0x94, 0xa5, 0x86, 0x79, 0xc8, 0x47, 0xd6, 0x94, 0xe0, 0x51, 0xa3, 0x53, 0x24, 0xd7, 0x85, 0xbf,
+    0x15, 0x18, 0x63, 0x96, 0xae, 0x45, 0x4a, 0x36, 0x85, 0x77, 0x83, 0x8d, 0xdc, 0xb8, 0x2a, 0xec,
+    0x41, 0x91, 0xb4, 0x2d, 0x70, 0x66, 0xf4, 0xfc, 0x0e, 0xd6, 0x6f, 0xad, 0x14, 0xeb, 0xad, 0xc2,
+    0xde, 0x78, 0xad, 0xe7, 0xd3, 0xe9, 0x98, 0x3d, 0x85, 0x6b, 0x43, 0x4e, 0x12, 0x82, 0x44, 0xc2,
+    0x69, 0x4f, 0xd9, 0x78, 0x5a, 0x1b, 0x3e, 0xee, 0x34, 0x31, 0x27, 0x29, 0xc0, 0x7c, 0x5e, 0x8a,
+    0x02, 0x02, 0xb1, 0xd5, 0xe2, 0x8c, 0xe9, 0x44, 0xae, 0x5f, 0x53, 0xd0, 0xbc, 0xb1, 0x9b, 0xe9,
+    0x45, 0xa3, 0x8a, 0x88, 0xf6, 0x4a, 0xc8, 0x91, 0x8c, 0x40, 0x08, 0x08, 0x11, 0x24, 0x83, 0x97,
+    0x90, 0x18, 0x5d, 0xc8, 0x95, 0x27, 0x02, 0x14, 0x04, 0xdf, 0xb7, 0x2c, 0xcc, 0xa4, 0x16, 0x9b,
+    0x9d, 0x77, 0xed, 0xdc, 0xb5, 0xb5, 0xea, 0x1e, 0x3e, 0x2c, 0xb9, 0xaf, 0x2a, 0x86, 0xf3, 0x8d,
+    0xb6, 0x47, 0x4c, 0x09, 0xa3, 0xee, 0x31, 0xaf, 0x01, 0xa7, 0xbb, 0xaa, 0xdb, 0xf5, 0xc2, 0x5c,
+    0xa7, 0xb9, 0x40, 0xe4, 0xbc, 0x7a, 0xd1, 0x11, 0x9a, 0xe4, 0x6c, 0xd6, 0x61, 0x7d, 0x68, 0xf7,
+    0xb5, 0x7e, 0xa0, 0xb6, 0xc6, 0x52, 0xf3, 0xe8, 0x86, 0xcb, 0xa5, 0x2e, 0x37, 0xdf, 0xd9, 0x83,
+    0x25, 0x4c, 0x41, 0x6a, 0x07, 0x28, 0x43, 0x99, 0x65, 0xd7, 0xb2, 0xb4, 0xe1, 0x5a, 0x05, 0xc0,
+    0x13, 0xa4, 0xfe, 0x1b, 0xdb, 0xa7, 0xd9, 0x59, 0x9b, 0xa7, 0x7e, 0x36, 0x61, 0x9d, 0xd7, 0x26,
+    0xc4, 0x41, 0xdb, 0xbd, 0x74, 0x2f, 0x04, 0xd8, 0xd3, 0x85, 0x3d, 0xf2, 0x05, 0x4a, 0x58, 0x54,
+    0xf4, 0xa6, 0xbf, 0xa9, 0xe9, 0x0a, 0x67, 0xb1, 0xae, 0xd9, 0x69, 0xcc, 0xbc, 0xce, 0xda, 0x20,
+    0x13, 0xc5, 0x0a, 0x28, 0x78, 0xb6, 0x2d, 0x30, 0xbf, 0x27, 0x7f, 0xd1, 0x7d, 0x12, 0x68, 0x60,
+    0xa0, 0xf0, 0x26, 0xdb, 0xa2, 0x9c, 0xb2, 0x67, 0x03, 0x9b, 0x35, 0x96, 0xfb, 0x1d, 0xc3, 0xfb,
+    0x46, 0x0e, 0x7a, 0xd9, 0x42, 0x53, 0x80, 0xa9, 0xfb, 0xd5, 0x2d, 0x36, 0xbd, 0x48, 0x35, 0xf6,
+    0x16, 0xca, 0x1b, 0xdd, 0x88, 0xfb, 0xd2, 0x02, 0xe5, 0xd1, 0x26, 0x10, 0x9e, 0x20, 0x96, 0xae,
+    0xff, 0x49, 0x07, 0x4b, 0x08, 0xb0, 0x84, 0x2d, 0x16, 0x0b, 0xe6, 0x5a, 0xf8, 0xc8, 0x1f, 0xc8,
+    0x37, 0xc7, 0x08, 0xc1, 0xf4, 0xfb, 0xbd, 0x88, 0x79, 0x95, 0xa1, 0x00, 0x87, 0x12, 0xa7, 0xee,
+    0xdb, 0x9d, 0x44, 0xd9, 0x5a, 0xe0, 0x9f, 0x0c, 0x64, 0xca, 0x66, 0xd9, 0x60, 0x8e, 0x00, 0xe7,
+    0xe1, 0x15, 0x67, 0xb0, 0xc5, 0xfc, 0xc0, 0xa8, 0x34, 0xf7, 0x7a, 0x3e, 0xf5, 0x9e, 0x80, 0xea,
+    0x53, 0x6e, 0x57, 0xaa, 0x68, 0x6d, 0xd3, 0x58, 0x5b, 0x17, 0xcd, 0x17, 0x5f, 0x34, 0x75, 0x06,
+    0x94, 0x8b, 0xee, 0xaf, 0x0c, 0x35, 0x26, 0xb2, 0x7f, 0x83, 0x19, 0xc1, 0xe5, 0xdb, 0x57, 0x3f,
+    0xf9, 0x7b, 0xcb, 0x2e, 0x20, 0x75, 0x3d, 0xda, 0xab, 0xef, 0x80, 0x96, 0x96, 0xd0, 0x79, 0x3c,
+    0xee, 0x73, 0x34, 0xea, 0x0d, 0xfb, 0xa7, 0x46, 0x50, 0x82, 0x3e, 0x40, 0xad, 0x5e, 0x0b, 0xa5,
+    0x5d, 0x2b, 0xa6, 0xd6, 0x5c, 0xc3, 0xe4, 0x58, 0xd7, 0x40, 0x7d, 0x02, 0x64, 0x8e, 0x39, 0x06,
+    0x8c, 0x08, 0xe7, 0x2f, 0xa5, 0x2d, 0x83, 0xd0, 0x0e, 0x3f, 0xb9, 0x66, 0x5f, 0xde, 0xdd, 0xed,
+    0x0e, 0xb5, 0xc2, 0x84, 0x40, 0x04, 0x92, 0xfd, 0x4d, 0xb8, 0x20, 0x44, 0x14, 0x45, 0x28, 0x23,
+    0xf1, 0xfe, 0xdd, 0x39, 0xe6, 0xab, 0x12, 0x27, 0xb3, 0xc2, 0x58, 0xb3, 0xfc, 0x9e, 0xd2, 0x01,
+    0xb6, 0x2f, 0x3c, 0x45, 0x60, 0xa4, 0x6c, 0xb2, 0x7b, 0xbe, 0x7b, 0x44, 0xd7, 0xc3, 0x10, 0x65,
+    0x4f, 0x23, 0x1b, 0x04, 0x18, 0x9f, 0x31, 0xda, 0x90, 0x42, 0x09, 0xe0, 0xfd, 0xad, 0xa0, 0x1b,
+    0xbb, 0xf6, 0x29, 0xb3, 0x32, 0x02, 0xf0, 0x69, 0xea, 0x16, 0x1e, 0x11, 0x7d, 0xf6, 0x0d, 0x7c,
+    0xc7, 0xe6, 0x96, 0xd3, 0x1f, 0x70, 0x73, 0x13, 0x52, 0x15, 0xc8, 0x1b, 0xff, 0x11, 0x4e, 0xdf,
+    0x05, 0x45, 0x5a, 0x45, 0x3b, 0xd4, 0x53, 0x25, 0xc3, 0x88, 0x69, 0xec, 0x6e, 0xcd, 0x03, 0xe7,
+    0xd4, 0xb9, 0x55, 0x19, 0xdc, 0x34, 0xa3, 0x23, 0x10, 0xd4, 0x8c, 0xbd, 0xf1, 0x2f, 0x93, 0x9a,
+    0x6b, 0x42, 0x99, 0x53, 0x69, 0x28, 0xfb, 0xd7, 0x5f, 0xf0, 0x8a, 0xb6, 0x77, 0x43, 0xca, 0x3e,
+    0x0c, 0x39, 0x14, 0xad, 0x08, 0xc1, 0x10, 0xfd, 0xc6, 0x52, 0xb8, 0xf7, 0xa1, 0xec, 0x95, 0x52,
+    0x52, 0xed, 0x18, 0xff, 0xb0, 0xd3, 0xb9, 0x37, 0x23, 0xa8, 0x1b, 0xb6, 0xe6, 0x36, 0x43, 0x54,
+    0x67, 0x82, 0x64, 0xba, 0x2a, 0x4b, 0x60, 0xa8, 0xb6, 0xd4, 0xab, 0x37, 0xdf, 0x4e, 0x9e, 0xbd,
+    0xf8, 0xea, 0x88, 0x61, 0xf4, 0xd3, 0x4d, 0x2f, 0x4f, 0xd2, 0x12, 0xf7, 0x6d, 0xc9, 0x36, 0xd5,
+    0xd0, 0x23, 0xd1, 0xfb, 0xec, 0x78, 0x7b, 0xd2, 0x9e, 0x0b, 0x13, 0xe8, 0x09, 0x71, 0xeb, 0x84,
+    0xdb, 0xae, 0xae, 0x44, 0x28, 0x30, 0x42, 0x68, 0x2b, 0x4b, 0x89, 0xb8, 0xd2, 0x74, 0xcd, 0xf2,
+    0x54, 0xe7, 0x64, 0xe0, 0xb6, 0x7d, 0x73, 0x7d, 0x5f, 0x84, 0xdb, 0x8a, 0xef, 0x4e, 0x88, 0x83,
+    0x85, 0x8f, 0x89, 0xfb, 0xe0, 0x04, 0x65, 0x27, 0xf4, 0xb1, 0x1f, 0xd0, 0x8c, 0xad, 0x7f, 0x9d,
+    0xfd, 0x7e, 0x32, 0x20, 0xa3, 0xf1, 0x04, 0xb1, 0x1e, 0x16, 0xd6, 0x4c, 0xe7, 0x1f, 0x11, 0xb8,
+    0x19, 0x4c, 0x0f, 0x0a, 0x6b, 0xe6, 0xd5, 0xb1, 0x3f, 0x24, 0xc3, 0x0e, 0xd1, 0x87, 0x05, 0xd8,
+    0x51, 0x1e, 0xaa, 0xd8, 0xac, 0xee, 0x77, 0x8f, 0x27, 0xe4, 0x1b, 0xe4, 0xdd, 0x93, 0xb6, 0x7d,
+    0x0d, 0xf6, 0xed, 0x64, 0x54, 0x22, 0x69, 0x94, 0xe0, 0x9b, 0xd1, 0xcb, 0xc5, 0xd4, 0xc6, 0x2b,
+    0x35, 0x7a, 0xf7, 0xac, 0x31, 0xd4, 0x14, 0x9f, 0x58, 0x65, 0x87, 0x44, 0xbb, 0x13, 0x1f, 0xe5,
+    0xc6, 0xe6, 0x8c, 0x31, 0xf6, 0x3b, 0xb8, 0x4b, 0xe3, 0x27, 0xb0, 0xa9, 0x19, 0x55, 0x8e, 0x5c,
+    0xbe, 0xf5, 0x8b, 0x14, 0xe3, 0xc8, 0x00, 0x86, 0xec, 0x86, 0x10, 0xcb, 0xfe, 0x79, 0x75, 0xf9,
+    0x53, 0x60, 0xb1, 0xce, 0xe3, 0x6b, 0x9e, 0xee, 0x86, 0xb7, 0x06, 0xa6, 0x81, 0x0a, 0x8c, 0xa5,
+    0x62, 0x5e, 0x9d, 0x53, 0x55, 0x8a, 0x39, 0x54, 0xc6, 0x5b, 0xc3, 0xed, 0x13, 0x4d, 0xce, 0xfc,
+    0xf5, 0x77, 0x7f, 0x0f, 0x90, 0xd5, 0x26, 0x78, 0x96, 0x97, 0x14, 0x30, 0xcd, 0x02, 0xe4, 0x0a,
+    0x9a, 0x41, 0x49, 0x75, 0x5c, 0x82, 0x60, 0x92, 0x40, 0xa3, 0xe0, 0x80, 0x13, 0x53, 0x04, 0xaf,
+    0x94, 0x25, 0x4d, 0x70, 0xe8, 0x2d, 0x08, 0x57, 0x40, 0xff, 0xd7, 0x3a, 0x80, 0x65, 0x24, 0x15,
+    0xfb, 0x37, 0x1e, 0x72, 0x5b, 0xd1, 0xcd, 0x6b, 0xfb, 0x26, 0xf9, 0xc4, 0xbd, 0x6d, 0x3e, 0xe9,
+    0x34, 0x8b, 0x7e, 0xfb, 0x78, 0x60, 0x16, 0x5b, 0xd0, 0xdd, 0x87, 0xac, 0xe9, 0x87, 0xf1, 0x7d,
+    0x41, 0x7d, 0x90, 0x2f, 0xb3, 0x2d, 0x6c, 0x8c, 0xfd, 0x43, 0xfd, 0xc9, 0x66, 0x85, 0xf5, 0x08,
+    0x25, 0x20, 0x5d, 0x04, 0x3a, 0xe1, 0x00, 0x96, 0xa1, 0x24, 0x69, 0xaa, 0x8a, 0x80, 0x83, 0x15,
+    0x92, 0x39, 0x4e, 0x1b, 0x11, 0x42, 0xd7, 0x96, 0x5f, 0x06, 0xea, 0xe4, 0x3f, 0x95, 0x40, 0x5e,
+    0xb8, 0x89, 0xfe, 0xfd, 0xbb, 0x8b, 0x2b, 0xc1, 0x55, 0x98, 0xbc, 0xe5, 0x0a, 0x87, 0x13, 0xef,
+    0x83, 0x93, 0x34, 0x67, 0x2d, 0x05, 0x1a, 0x64, 0xab, 0x1f, 0xba, 0x1b, 0x97, 0x73, 0x73, 0xfb,
+    0xf7, 0x61, 0xb0, 0x1c, 0xef, 0x12, 0x55, 0x6f, 0xf2, 0xcb, 0x8f, 0x17, 0x6f, 0x8c, 0x29, 0xdf,
+    0x09, 0xec, 0xac, 0x7b, 0x13, 0x0e, 0xf8, 0x02, 0x3a, 0x12, 0x78, 0xe3, 0xb7, 0x97, 0x57, 0xd7,
+    0x63, 0x4c, 0x91, 0x53, 0x1c, 0x89, 0xbf, 0x21, 0x3b, 0xac, 0xa6, 0x03, 0xec, 0xd8, 0xbf, 0x16,
+    0xf6, 0xc6, 0x36, 0x11, 0xea, 0x1f, 0xa8, 0x96, 0x89, 0x2b, 0xef, 0x23, 0x57, 0x35, 0x03, 0xeb,
+    0xaa, 0x32, 0x93, 0x3c, 0xc2, 0x49, 0xa0, 0x05, 0x37, 0xb6, 0x59, 0x7c, 0x70, 0x83, 0x5b, 0x3d,
+    0x9b, 0x52, 0xdf, 0xae, 0x0c, 0xc5, 0xce, 0xdf, 0x00, 0xd3, 0xa6, 0x11, 0x82, 0x09, 0x32, 0x30,
+    0x1c, 0xfc, 0x83, 0x4e, 0x85, 0x18, 0x43, 0x51, 0x21, 0xd0, 0x37, 0x3b, 0x69, 0x0f, 0xee, 0x1b,
+    0xbb, 0x0a, 0x62, 0x1e, 0x38, 0xec, 0x10, 0x11, 0x62, 0x31, 0x1e, 0x68, 0x71, 0x4d, 0x9d, 0xda,
+    0x0d, 0x5f, 0x43, 0xae, 0xc1, 0x00, 0x8a, 0x9e, 0x35, 0x74, 0x60, 0x7a, 0x6f, 0xcd, 0xa9, 0xfb,
+    0x6a, 0x37, 0xbb, 0x7a, 0x8a, 0xcf, 0xf6, 0xd0, 0xdd, 0x31, 0x1f, 0x0c, 0x38, 0x26, 0x6a, 0x31,
+    0xe4, 0x6c, 0x94, 0x22, 0x32, 0x6a, 0xb8, 0x67, 0x12, 0x14, 0xd9, 0x43, 0x37, 0x1d, 0x6d, 0x5a,
+    0x6f, 0x45, 0xb7, 0x53, 0xe8, 0x46, 0xdf, 0x5c, 0xaf, 0xfc, 0xde, 0x0b, 0x51, 0x10, 0x3a, 0x93,
+    0x3f, 0xd8, 0x4e, 0x06, 0x98, 0xec, 0xbb, 0xbd, 0xa0, 0x79, 0xff, 0xb7, 0xe8, 0xbd, 0x40, 0x45,
+    0x8b, 0x56, 0xcd, 0xf1, 0x6a, 0xab, 0x90, 0x3f, 0x20, 0xca, 0x12, 0x20, 0xa1, 0x75, 0x1e, 0xdb,
+    0x77, 0x22, 0x1c, 0xde, 0xba, 0xe3, 0xc9, 0x87, 0xde, 0x31, 0xae, 0xe5, 0x9f, 0xcd, 0xb9, 0xfa,
+    0xa4, 0x79, 0x47, 0x59, 0xbf, 0x13, 0x39, 0x9d, 0xba, 0xb7, 0x93, 0xa7, 0x53, 0xf7, 0xcf, 0xfd,
+    0xff, 0x01, 0x0d, 0x4b, 0x6d, 0xbd, 0xed, 0x1f, 0x00, 0x00,
+};
+static const WebAsset WEB_ASSET_INDEX_HTML = {"text/html", WEB_ASSET_INDEX_HTML_GZ, sizeof(WEB_ASSET_INDEX_HTML_GZ), "\"fd523e97bbba6c04\""};
+
+// provision.html: 4780 -> 1460 bytes
+static const uint8_t WEB_ASSET_PROVISION_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x58, 0x51, 0x8f, 0xda, 0x46,
+    0x10, 0x7e, 0xcf, 0xaf, 0x98, 0x3a, 0xaa, 0xb0, 0x55, 0x6c, 0xe0, 0x2e, 0x89, 0x2a, 0x0e, 0xa8,
+    0x94, 0xe4, 0x52, 0x45, 0x8a, 0x92, 0x53, 0xb9, 0x34, 0xad, 0xd4, 0x97, 0xc5, 0x1e, 0xe3, 0xcd,
+    0xd9, 0xbb, 0xd6, 0xee, 0xc2, 0x1d, 0x8d, 0xee, 0xbf, 0x77, 0xd6, 0x36, 0x60, 0x8c, 0xcd, 0x71,
+    0x35, 0x12, 0xd8, 0x3b, 0x3b, 0xb3, 0x33, 0xdf, 0xcc, 0x7c, 0xbb, 0x66, 0xf2, 0xd3, 0xfb, 0x2f,
+    0xef, 0x6e, 0xff, 0xbe, 0xb9, 0x86, 0xc4, 0x64, 0xe9, 0xec, 0xc5, 0xc4, 0xfe, 0x40, 0xca, 0xc4,
+    0x72, 0xea, 0xa0, 0x70, 0xec, 0x00, 0xb2, 0x68, 0xf6, 0x02, 0xe8, 0x9a, 0x64, 0x68, 0x18, 0x84,
+    0x09, 0x53, 0x1a, 0xcd, 0xd4, 0x59, 0x99, 0xd8, 0xff, 0xd5, 0xa9, 0x8b, 0x04, 0xcb, 0x70, 0xea,
+    0xac, 0x39, 0xde, 0xe7, 0x52, 0x19, 0x07, 0x42, 0x29, 0x0c, 0x0a, 0x9a, 0x7a, 0xcf, 0x23, 0x93,
+    0x4c, 0x23, 0x5c, 0xf3, 0x10, 0xfd, 0xe2, 0xa1, 0x0f, 0x5c, 0x70, 0xc3, 0x59, 0xea, 0xeb, 0x90,
+    0xa5, 0x38, 0x1d, 0x6d, 0x0d, 0x19, 0x6e, 0x52, 0x9c, 0xfd, 0x85, 0xdf, 0x10, 0xbe, 0xcc, 0xe1,
+    0x1b, 0xff, 0xc0, 0x61, 0x8e, 0x66, 0x95, 0x4f, 0x06, 0xa5, 0xa4, 0x9c, 0xa5, 0xcd, 0x66, 0x7b,
+    0x6f, 0xaf, 0xb1, 0x92, 0xd2, 0xc0, 0x8f, 0xdd, 0xb3, 0xbd, 0x7c, 0x7f, 0xb1, 0x1c, 0xc3, 0xcb,
+    0xd1, 0x85, 0xfd, 0x5c, 0x35, 0x44, 0xb1, 0x15, 0xe1, 0xd0, 0x7e, 0x9a, 0x22, 0x2e, 0xf2, 0x95,
+    0xa9, 0x74, 0xd1, 0x7e, 0x9a, 0x13, 0x58, 0x18, 0x52, 0x50, 0x24, 0x1e, 0x0e, 0x17, 0x61, 0xf4,
+    0xaa, 0x29, 0x5e, 0x48, 0x15, 0xa1, 0x22, 0xf1, 0xe5, 0xe5, 0xe5, 0x5e, 0xf6, 0xb8, 0xbb, 0x5b,
+    0xc8, 0x68, 0xd3, 0x70, 0x75, 0xc1, 0xc2, 0xbb, 0xa5, 0x92, 0x2b, 0x11, 0xf9, 0xa1, 0x4c, 0x25,
+    0x29, 0xaf, 0x99, 0x72, 0x6d, 0x00, 0xde, 0xa1, 0xf5, 0x03, 0x69, 0xdc, 0x94, 0xc6, 0x04, 0xb7,
+    0x1f, 0xb3, 0x8c, 0xa7, 0x9b, 0x31, 0xf4, 0xe6, 0xb8, 0x94, 0x08, 0x5f, 0x3f, 0xf6, 0xfa, 0x70,
+    0xcb, 0x12, 0x99, 0xb1, 0x3e, 0xfc, 0x8e, 0x02, 0xd7, 0xf4, 0xfb, 0x27, 0xaa, 0x88, 0x09, 0xba,
+    0xd1, 0x4c, 0x68, 0x5f, 0xa3, 0xe2, 0xf1, 0xa1, 0xa5, 0x88, 0xeb, 0x3c, 0x65, 0x64, 0x25, 0x4e,
+    0xf1, 0xe1, 0x50, 0xf4, 0x7d, 0xa5, 0x0d, 0x8f, 0x37, 0x7e, 0x95, 0xdb, 0x31, 0x58, 0x30, 0x50,
+    0x1d, 0x4e, 0xca, 0x98, 0x5a, 0x72, 0x31, 0x86, 0x06, 0xb8, 0x39, 0x8b, 0x22, 0x2e, 0x08, 0xd9,
+    0x8b, 0x61, 0xde, 0x30, 0xbb, 0x90, 0x0f, 0xbe, 0xe6, 0xff, 0x16, 0xd2, 0x12, 0x41, 0x02, 0xf2,
+    0xa1, 0x0d, 0xbf, 0xc0, 0xae, 0xcc, 0xb8, 0x40, 0xd5, 0x40, 0xb1, 0xa8, 0xab, 0x31, 0x8c, 0x86,
+    0xc3, 0x9f, 0x9b, 0xde, 0x3c, 0xf8, 0x95, 0xf0, 0xd5, 0xe1, 0xca, 0x7b, 0xab, 0xc9, 0xa8, 0x61,
+    0xad, 0x00, 0xf3, 0x1e, 0xf9, 0x32, 0xa1, 0x18, 0x2f, 0x87, 0x8d, 0x48, 0x52, 0x34, 0x14, 0xb4,
+    0xaf, 0x73, 0x16, 0x16, 0x2e, 0x8f, 0x9a, 0xf1, 0x1c, 0x64, 0xaa, 0xac, 0x98, 0x46, 0xb6, 0x0c,
+    0x3e, 0x18, 0x9f, 0xa5, 0x7c, 0x29, 0x8e, 0x31, 0xdc, 0xfb, 0xf5, 0x52, 0xa0, 0xb9, 0x97, 0xea,
+    0x4e, 0x53, 0x4e, 0xd6, 0x0d, 0x17, 0x77, 0x70, 0x8e, 0x2e, 0x8e, 0xe1, 0x2c, 0x8b, 0x90, 0xfc,
+    0x02, 0x2d, 0x53, 0x1e, 0x6d, 0x2b, 0xaa, 0x18, 0xf7, 0xda, 0x26, 0xfb, 0x8a, 0x45, 0x7c, 0xa5,
+    0xc7, 0xf0, 0xba, 0x69, 0xac, 0xcc, 0x26, 0xe9, 0x1a, 0x23, 0xb3, 0x31, 0xbc, 0x39, 0x8a, 0x75,
+    0xa5, 0xb4, 0x0d, 0x36, 0x97, 0xfc, 0xb8, 0x14, 0x9e, 0x53, 0x4a, 0x16, 0x4e, 0xf4, 0x17, 0x14,
+    0x31, 0xa2, 0x78, 0x12, 0x8d, 0x71, 0x22, 0xd7, 0xb6, 0x08, 0xb6, 0xfe, 0xb7, 0x42, 0x5e, 0x53,
+    0x2e, 0x1a, 0xfb, 0xdc, 0x9a, 0xd9, 0x63, 0xdb, 0x05, 0x87, 0x91, 0xb9, 0x55, 0x6c, 0x47, 0xbe,
+    0x1b, 0xcc, 0xe7, 0x65, 0xa6, 0x83, 0x18, 0xb6, 0x1c, 0xf5, 0x7c, 0x7a, 0xa0, 0x1e, 0x43, 0x5a,
+    0xfc, 0xcd, 0x73, 0xfb, 0xcf, 0x5e, 0x72, 0x65, 0x52, 0xea, 0xbb, 0x31, 0x08, 0x29, 0xb0, 0x2d,
+    0x3d, 0x85, 0x5b, 0xe3, 0x58, 0x86, 0x2b, 0x7d, 0x7e, 0x5a, 0x16, 0x2b, 0x2a, 0x2b, 0x71, 0x7e,
+    0x2f, 0x9f, 0x02, 0xff, 0x44, 0xd6, 0xb6, 0xb8, 0x1f, 0xfa, 0x7e, 0x56, 0xc6, 0x3a, 0x92, 0xd0,
+    0xda, 0xd5, 0xa7, 0xf9, 0xfb, 0x80, 0x54, 0x16, 0x32, 0x8d, 0x9e, 0x91, 0xa1, 0xce, 0x2e, 0xab,
+    0xb5, 0x47, 0xa6, 0x97, 0x0d, 0x20, 0x0f, 0xf0, 0x3a, 0x0a, 0xed, 0x14, 0x07, 0x15, 0xda, 0xa4,
+    0x9a, 0x54, 0xee, 0xb6, 0x31, 0xe7, 0x64, 0x50, 0x6d, 0xc4, 0x93, 0x41, 0x79, 0x4c, 0x98, 0xd8,
+    0xdd, 0xad, 0xda, 0xa3, 0x2d, 0x61, 0x85, 0x29, 0xd3, 0x7a, 0xea, 0xec, 0x28, 0xdb, 0xd9, 0xef,
+    0xd9, 0x93, 0x64, 0x34, 0xab, 0x6f, 0xef, 0xf4, 0xb8, 0x97, 0x59, 0x5d, 0x1e, 0x4d, 0x9d, 0x6d,
+    0xbf, 0x3b, 0xb3, 0x79, 0xc8, 0x84, 0xa0, 0xdc, 0x06, 0x41, 0x30, 0x19, 0x90, 0xb8, 0x36, 0xb9,
+    0x6c, 0x6c, 0xb3, 0xc9, 0xe9, 0xf0, 0x61, 0x23, 0x72, 0x0a, 0x55, 0xad, 0x79, 0xe4, 0x00, 0x71,
+    0x4f, 0x88, 0x09, 0x21, 0x8d, 0x6a, 0xea, 0xcc, 0xe7, 0x1f, 0xdf, 0x3b, 0xc0, 0x56, 0x46, 0x86,
+    0x32, 0xcb, 0x89, 0xc3, 0x49, 0x41, 0xc6, 0xb1, 0xd3, 0x61, 0x2b, 0x27, 0xdf, 0x69, 0xf5, 0xa8,
+    0xb4, 0xb7, 0x7f, 0x3a, 0xb0, 0x79, 0x53, 0x0d, 0x83, 0x8b, 0x59, 0x6e, 0x36, 0x94, 0x43, 0x05,
+    0x32, 0x47, 0xe1, 0xd5, 0xad, 0x56, 0x35, 0x2e, 0x45, 0x98, 0xf2, 0xf0, 0x8e, 0x7c, 0x63, 0x6b,
+    0x74, 0x69, 0xc6, 0x3b, 0x29, 0x04, 0x86, 0x66, 0x32, 0x28, 0x27, 0xb4, 0x00, 0x40, 0x19, 0x75,
+    0x66, 0xb5, 0x80, 0xeb, 0xb7, 0x3a, 0x54, 0x3c, 0x37, 0x7b, 0x25, 0x42, 0x59, 0x1b, 0x48, 0x39,
+    0x7d, 0x4d, 0x21, 0xa2, 0x2e, 0xcc, 0x28, 0xa5, 0xc1, 0x12, 0xcd, 0x75, 0x8a, 0xf6, 0xf6, 0xed,
+    0xe6, 0x63, 0xe4, 0xf6, 0xb6, 0x90, 0xf6, 0x6a, 0xb5, 0x59, 0x6a, 0xda, 0xea, 0x39, 0xa5, 0x49,
+    0x72, 0xab, 0xb4, 0xd3, 0x8a, 0x57, 0x22, 0x34, 0x9c, 0xe2, 0x4a, 0x25, 0x8b, 0x3e, 0x57, 0x66,
+    0x5d, 0xaf, 0xb9, 0x91, 0xa2, 0x09, 0x13, 0xb7, 0x37, 0xc8, 0x95, 0x5c, 0x73, 0x4d, 0xd3, 0x07,
+    0x7b, 0x0f, 0x02, 0x93, 0xa0, 0x70, 0x15, 0x4c, 0x67, 0xa0, 0x82, 0xef, 0x5a, 0x0a, 0xd7, 0xab,
+    0xc6, 0x22, 0x3b, 0x76, 0x68, 0xa8, 0xd8, 0x77, 0x29, 0xb8, 0xc0, 0xe6, 0xf8, 0x5d, 0xb9, 0x67,
+    0x58, 0x77, 0x83, 0xad, 0xbd, 0x20, 0x45, 0xb1, 0x34, 0x09, 0xfc, 0x06, 0xbd, 0x1e, 0xd0, 0x09,
+    0xe8, 0xb3, 0x84, 0xdd, 0x7e, 0x11, 0xdb, 0xfe, 0xed, 0x5d, 0x1d, 0x19, 0xac, 0x69, 0x53, 0xe6,
+    0xae, 0x19, 0xb9, 0x2a, 0xda, 0x97, 0xde, 0xe3, 0xa4, 0xe4, 0x7d, 0x1d, 0xa6, 0x50, 0x21, 0x33,
+    0x58, 0x21, 0xe5, 0xf6, 0x28, 0x3f, 0x3d, 0xef, 0xea, 0x84, 0xba, 0x3d, 0x25, 0x9f, 0xd0, 0xa7,
+    0x4d, 0x50, 0x74, 0x19, 0xb0, 0xaa, 0x8d, 0xf0, 0x45, 0x60, 0x0b, 0xfd, 0xd4, 0x7a, 0x5c, 0xc4,
+    0xf2, 0x7f, 0xae, 0x67, 0x55, 0x8f, 0xd6, 0x53, 0xb4, 0x20, 0xfc, 0x02, 0x3d, 0x88, 0xde, 0x66,
+    0x3d, 0xba, 0x71, 0x45, 0x60, 0x0b, 0x7e, 0x07, 0x3b, 0xfc, 0xb3, 0xfa, 0x31, 0xfa, 0xf0, 0x7a,
+    0x74, 0xf1, 0xd8, 0x65, 0x96, 0x00, 0x0c, 0x58, 0x4e, 0x3a, 0x91, 0x6b, 0x23, 0xea, 0x17, 0xeb,
+    0x9c, 0x98, 0x5b, 0xf5, 0x0d, 0xad, 0x4e, 0xd5, 0xd5, 0x99, 0x9c, 0x22, 0x9d, 0x5d, 0xb5, 0x6b,
+    0x41, 0xa2, 0x7a, 0x5b, 0xb3, 0x74, 0x85, 0x4f, 0xa0, 0x76, 0xd2, 0xce, 0x96, 0x05, 0xc8, 0x56,
+    0xb1, 0xcf, 0xb9, 0x1d, 0x6e, 0x3f, 0xb6, 0x0f, 0x17, 0xf5, 0x5b, 0x86, 0xfe, 0x2e, 0xe1, 0x69,
+    0xe4, 0x52, 0x78, 0x2d, 0x16, 0x1e, 0x5b, 0xc6, 0x78, 0x0c, 0x6e, 0x14, 0xe8, 0x8a, 0x06, 0x3d,
+    0xa0, 0x77, 0xb0, 0x5b, 0x9e, 0x21, 0x6d, 0xca, 0x6e, 0xbd, 0xff, 0xfa, 0x44, 0xd4, 0xc3, 0x61,
+    0x43, 0xff, 0xd1, 0x0b, 0x42, 0x66, 0xdb, 0xb0, 0xc4, 0xef, 0xb4, 0xaa, 0x57, 0x67, 0xf9, 0xe3,
+    0x66, 0x2f, 0xb9, 0xab, 0x91, 0x83, 0xb2, 0xd2, 0x8a, 0x57, 0x1b, 0x02, 0x17, 0xef, 0xe1, 0xeb,
+    0x1f, 0x9f, 0xe6, 0xc8, 0x54, 0x98, 0xdc, 0x30, 0xc5, 0xb2, 0x23, 0x98, 0xec, 0xcc, 0x6d, 0x09,
+    0x94, 0xb9, 0xe9, 0x9f, 0x97, 0xbb, 0xc0, 0x28, 0x9e, 0xb9, 0xde, 0x29, 0x73, 0xbb, 0x14, 0xf5,
+    0xcf, 0x4a, 0x63, 0x61, 0xb6, 0x61, 0x8f, 0x98, 0xae, 0x51, 0xf6, 0xbd, 0x8a, 0xaa, 0xcb, 0x1d,
+    0xa8, 0x41, 0x24, 0xc7, 0x14, 0x67, 0x41, 0xa2, 0xf5, 0x7f, 0x00, 0xbd, 0x17, 0x27, 0x32, 0xa2,
+    0xae, 0xb8, 0xf9, 0x32, 0xbf, 0xa5, 0x11, 0xeb, 0xe9, 0xb8, 0x04, 0xea, 0xd1, 0x3b, 0xca, 0xf1,
+    0x01, 0x1f, 0xca, 0x3b, 0x6a, 0xa9, 0x5c, 0xa6, 0xe9, 0xdc, 0x30, 0x43, 0x95, 0x76, 0x39, 0xf4,
+    0xa8, 0xbd, 0x54, 0xe1, 0x98, 0x5b, 0xd1, 0xa4, 0xb1, 0x53, 0x8f, 0xbd, 0x35, 0x5e, 0x8b, 0xed,
+    0x7a, 0x05, 0x9c, 0x08, 0x90, 0x52, 0x7c, 0xad, 0x94, 0x54, 0xbd, 0x27, 0xea, 0xa0, 0xe6, 0x19,
+    0xe5, 0x04, 0xf5, 0x27, 0x8c, 0xcd, 0xd3, 0xdc, 0xaf, 0x0b, 0x8d, 0x53, 0xcc, 0xaf, 0xdb, 0x3b,
+    0xdc, 0x96, 0xbf, 0xb6, 0xef, 0x7e, 0xd6, 0x49, 0x8c, 0xbc, 0x0e, 0x12, 0xe8, 0x0e, 0x0c, 0x23,
+    0x30, 0x12, 0x2c, 0x61, 0xe9, 0xa2, 0xf9, 0x2d, 0x85, 0x05, 0xf0, 0xbe, 0xf8, 0x4f, 0x02, 0xe8,
+    0xdc, 0xa8, 0x50, 0xd3, 0xe9, 0x2f, 0x31, 0x26, 0x1f, 0x0f, 0x06, 0xe5, 0x34, 0x9e, 0xb7, 0xb4,
+    0x26, 0x60, 0xaa, 0xb1, 0x70, 0x67, 0x17, 0x36, 0xcc, 0x60, 0xd8, 0xe5, 0x50, 0xad, 0xd7, 0x4a,
+    0xe8, 0xdb, 0x70, 0x03, 0x1f, 0x46, 0x5e, 0xdf, 0x1e, 0x77, 0x87, 0x5e, 0xe7, 0x92, 0x67, 0x07,
+    0xfc, 0x59, 0x1a, 0xd8, 0x01, 0x05, 0x1b, 0x34, 0x57, 0x10, 0x26, 0x48, 0xfc, 0x49, 0xf8, 0xc2,
+    0xb6, 0xf2, 0x81, 0x09, 0x02, 0x44, 0x6d, 0x80, 0x2d, 0xe9, 0x64, 0xd6, 0xb2, 0x33, 0x3e, 0x9e,
+    0xc9, 0x20, 0xe7, 0x45, 0xd5, 0x5e, 0x4c, 0x87, 0x07, 0x87, 0xab, 0xed, 0x99, 0xb2, 0x3a, 0xd7,
+    0xd0, 0xb1, 0xa8, 0x38, 0x4d, 0xd2, 0xd9, 0xb0, 0xf8, 0x6f, 0xea, 0x3f, 0x11, 0x5f, 0x9c, 0x66,
+    0xac, 0x12, 0x00, 0x00,
+};
+static const WebAsset WEB_ASSET_PROVISION_HTML = {"text/html", WEB_ASSET_PROVISION_HTML_GZ, sizeof(WEB_ASSET_PROVISION_HTML_GZ), "\"040b106a2bdf1de3\""};
@@ -13,6 +13,13 @@
 #include "Wifi.h"
 #include "../../../SystemController/SystemController.h"
 
+#include <esp_wifi.h>
+
+const Wifi::PowerSettings Wifi::POWER_PROFILES[] = {
+    /* PERFORMANCE */ {"performance", WIFI_PS_NONE,      1,  WIFI_POWER_19_5dBm},
+    /* BALANCED    */ {"balanced",    WIFI_PS_MIN_MODEM, 3,  WIFI_POWER_17dBm},
+    /* LOWPOWER    */ {"lowpower",    WIFI_PS_MAX_MODEM, 10, WIFI_POWER_11dBm},
+};
 
 Wifi::Wifi(SystemController& controller)
       : Module(controller,
@@ -39,16 +46,105 @@ Wifi::Wifi(SystemController& controller)
     });
     commands_storage.push_back({
         "scan",
-        "List available WiFi networks",
+        "List available WiFi networks (cached results are reused for 30 s)",
         std::string("$") + lower(module_name) + " scan",
         0,
-        [this](std::string_view){ scan(true); }
+        [this](std::string_view){ scan_cli(); }
+    });
+    commands_storage.push_back({
+        "add",
+        "Store a network to auto-connect to: <ssid> <password|-> <priority 0-255>",
+        std::string("$") + lower(module_name) + " add \"Home Net\" secret123 5",
+        3,
+        [this](std::string_view args){ add_network_cli(args); }
+    });
+    commands_storage.push_back({
+        "forget",
+        "Remove a stored network",
+        std::string("$") + lower(module_name) + " forget \"Home Net\"",
+        1,
+        [this](std::string_view args){ forget_network_cli(args); }
+    });
+    commands_storage.push_back({
+        "networks",
+        "List stored networks",
+        std::string("$") + lower(module_name) + " networks",
+        0,
+        [this](std::string_view){ print_networks(); }
+    });
+    commands_storage.push_back({
+        "ip_reuse",
+        "Reuse the cached IP lease on fast reconnect, skipping DHCP: <on|off>",
+        std::string("$") + lower(module_name) + " ip_reuse on",
+        1,
+        [this](std::string_view args){ set_ip_reuse(args); }
+    });
+    commands_storage.push_back({
+        "stats",
+        "Show link quality histograms (RSSI, connect time, ping RTT) and disconnect reasons",
+        std::string("$") + lower(module_name) + " stats",
+        0,
+        [this](std::string_view){ print_stats(); }
+    });
+    commands_storage.push_back({
+        "roam",
+        "Roam to a stronger AP of the same network when RSSI stays below: <dBm|off>",
+        std::string("$") + lower(module_name) + " roam -75",
+        1,
+        [this](std::string_view args){ set_roam_threshold(args); }
+    });
+    commands_storage.push_back({
+        "ping_monitor",
+        "Ping the gateway every 30 s to track round-trip time: <on|off>",
+        std::string("$") + lower(module_name) + " ping_monitor on",
+        1,
+        [this](std::string_view args){ set_ping_monitor(args); }
+    });
+    commands_storage.push_back({
+        "power",
+        "Select radio power profile: <performance|balanced|lowpower>",
+        std::string("$") + lower(module_name) + " power performance",
+        1,
+        [this](std::string_view args){ set_power_cli(args); }
+    });
+    commands_storage.push_back({
+        "probe",
+        "Measure gateway round-trip latency with the current power profile",
+        std::string("$") + lower(module_name) + " probe",
+        0,
+        [this](std::string_view){ start_probe(); }
+    });
+    commands_storage.push_back({
+        "portal",
+        "Open or close the SoftAP provisioning portal: <on|off>",
+        std::string("$") + lower(module_name) + " portal on",
+        1,
+        [this](std::string_view args){ set_portal_cli(args); }
+    });
+    commands_storage.push_back({
+        "discover",
+        "List other XeWe OS devices on the network (mDNS)",
+        std::string("$") + lower(module_name) + " discover",
+        0,
+        [this](std::string_view){ start_discovery(); }
     });
 }
 
 void Wifi::begin_routines_required (const ModuleConfig& cfg) {
     WiFi.mode(WIFI_STA);
-    WiFi.setHostname(controller.system.get_device_name().c_str());
+    resolve_hostname();
+    WiFi.setHostname(hostname.c_str());
+    // reconnects are driven by the state machine in loop(), not by the driver
+    WiFi.setAutoReconnect(false);
+    if (!event_handler_attached) {
+        WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info) { on_wifi_event(event, info); });
+        event_handler_attached = true;
+    }
+    power_profile = static_cast<PowerProfile>(min<uint8_t>(controller.nvs.read_uint8(nvs_key, "power", static_cast<uint8_t>(PowerProfile::BALANCED)),
+                                                           static_cast<uint8_t>(PowerProfile::COUNT) - 1));
+    apply_power_profile();
+    load_known_networks();
+    load_link_cache();
     disconnect(false);
     delay(100);
 }
@@ -59,29 +155,91 @@ void Wifi::begin_routines_init (const ModuleConfig& cfg) {
 }
 
 void Wifi::begin_routines_regular (const ModuleConfig& cfg) {
-    connect(false);
+    if (!connect(false)) start_provisioning();
 }
 
 void Wifi::loop () {
-    // enforce Wifi connection if the module is active
-    while (WiFi.status() != WL_CONNECTED) {
-        // Optimized: Use get_yn with 1 attempt (retry_count=1) to act as a timed prompt
-        bool user_disabled = controller.serial_port.get_yn(
-            "Wifi connection lost\nReconnecting in 5 seconds\nDisable WiFi module?",
-            1,      // retry_count
-            5000,   // timeout_ms
-            false   // default_value
+    const uint8_t events = pending_events.exchange(0);
+
+    if (events & EVT_DISCONNECTED) {
+        const uint8_t reason = pending_reason.load();
+        DBG_PRINTF(Wifi, "loop(): disconnected, reason=%u, state=%s\n", reason, link_state_name(link_state));
+        if (reason != WIFI_REASON_ASSOC_LEAVE) reason_tally.add(reason);
+        if (link_state == LinkState::CONNECTED) {
+            link_lost_count++;
+            last_disconnect_reason = reason;
+            failed_sequences = 0;
+            controller.serial_port.printf("WiFi connection lost (%s); reconnecting", reason_name(reason));
+            next_attempt_ms = millis() + BACKOFF_BASE_MS;
+            set_link_state(LinkState::BACKOFF);
+        } else if (link_state == LinkState::CONNECTING && reason != WIFI_REASON_ASSOC_LEAVE) {
+            // ASSOC_LEAVE is our own disconnect() echoing back from the driver
+            fail_attempt(reason);
+        }
+    }
+
+    if ((events & EVT_GOT_IP) && link_state != LinkState::IDLE && link_state != LinkState::CONNECTED
+        && WiFi.status() == WL_CONNECTED) {
+        DBG_PRINTLN(Wifi, "loop(): got ip");
+        const uint32_t assoc_at = assoc_at_ms.load();
+        const uint32_t ip_at    = got_ip_at_ms.load();
+        timing.fast_path = fast_attempt;
+        timing.reused_ip = static_ip_active;
+        timing.assoc_ms  = assoc_at - attempt_started_ms;
+        timing.ip_ms     = ip_at - assoc_at;
+        timing.total_ms  = ip_at - sequence_started_ms;
+
+        failed_sequences = 0;
+        connect_hist.add(timing.total_ms);
+        weak_samples = 0;
+        set_link_state(LinkState::CONNECTED);
+        controller.serial_port.printf("Joined %s\nLocal ip: %s\nMac: %s\nConnected in %s",
+            target_ssid.c_str(),
+            get_local_ip().c_str(),
+            get_mac_address().c_str(),
+            format_timing(timing).c_str()
         );
+        save_link_cache();
+        record_success();
+    }
+
+    const uint32_t now = millis();
+    if (scan_running) poll_scan(now);
+    if (link_state == LinkState::CONNECTED) sample_link(now);
+    if (probe_session && probe_done.load()) finish_probe();
+    if (discovery) poll_discovery();
 
-        if (user_disabled) {
-            disable(true);
+    if (provisioning) {
+        dns_server.processNextRequest();
+        if (link_state == LinkState::CONNECTED) {
+            if (portal_close_at_ms == 0) portal_close_at_ms = now + PORTAL_CLOSE_DELAY_MS;
+            else if ((int32_t)(now - portal_close_at_ms) >= 0) stop_provisioning();
+        } else {
+            portal_close_at_ms = 0;
         }
-        connect(true);
+    }
+
+    switch (link_state) {
+        case LinkState::CONNECTING:
+            if (now - attempt_started_ms >= (fast_attempt ? FAST_CONNECT_TIMEOUT_MS : CONNECT_TIMEOUT_MS)) fail_attempt(0);
+            break;
+        case LinkState::BACKOFF:
+            if ((int32_t)(now - next_attempt_ms) >= 0) begin_sequence();
+            break;
+        default:
+            break;
     }
 }
 
 void Wifi::reset (const bool verbose, const bool do_restart, const bool keep_enabled) {
+    stop_provisioning();
+    stop_mdns();
     disconnect(false);
+    target_ssid.clear();
+    target_password.clear();
+    link_cache = LinkCache{};
+    known_networks.clear();
+    candidates.clear();
     Module::reset(verbose, do_restart, keep_enabled);
 }
 
@@ -92,75 +250,117 @@ std::string Wifi::status(bool verbose) const {
     Module::status(verbose);
 
     std::string status_string {};
-    if (is_disconnected(true)) {
-        status_string = "disconnected";
-    } else if (is_connected()) {
+    if (is_connected()) {
         status_string = "Connected to " + get_ssid()
                       + "\nLocal ip: " + get_local_ip()
                       + "\nMac: " + get_mac_address();
-        if (verbose) {
-            controller.serial_port.print(status_string);
+    } else {
+        status_string = std::string("Disconnected (") + link_state_name(link_state) + ")";
+        if (last_disconnect_reason != 0) {
+            status_string += std::string("\nLast reason: ") + reason_name(last_disconnect_reason)
+                           + " (" + std::to_string(last_disconnect_reason) + ")";
         }
+        if (link_state == LinkState::BACKOFF) {
+            const int32_t wait_ms = (int32_t)(next_attempt_ms - millis());
+            status_string += "\nNext attempt in " + std::to_string(wait_ms > 0 ? wait_ms / 1000 : 0) + " s"
+                           + "\nFailed rounds: " + std::to_string(failed_sequences);
+        }
+    }
+    status_string += "\nKnown networks: " + std::to_string(known_networks.size());
+    if (timing.total_ms > 0) {
+        status_string += "\nLast connect: " + format_timing(timing);
+    }
+    if (link_lost_count > 0) {
+        status_string += "\nLink losses: " + std::to_string(link_lost_count);
+    }
+    if (provisioning) {
+        status_string += "\nProvisioning portal: http://" + get_portal_ip();
+    }
+    status_string += std::string("\nPower profile: ") + POWER_PROFILES[static_cast<size_t>(power_profile)].name;
+    if (verbose) {
+        controller.serial_port.print(status_string);
     }
     return status_string;
 }
 
+void Wifi::status_json(xewe::json::Writer& out) const {
+    out.field("state", link_state_name(link_state));
+    out.field("connected", is_connected());
+    if (is_connected()) {
+        out.field("ssid", get_ssid(false));
+        out.field("ip", get_local_ip(false));
+        out.field("rssi", static_cast<int>(WiFi.RSSI()));
+    }
+    out.field("mac", get_mac_address(false));
+    out.field("hostname", hostname);
+    out.field("known_networks", known_networks.size());
+    out.field("last_disconnect_reason", last_disconnect_reason);
+    out.field("failed_rounds", failed_sequences);
+    out.field("link_losses", link_lost_count);
+    out.field("last_connect_ms", timing.total_ms);
+    out.field("power_profile", POWER_PROFILES[static_cast<size_t>(power_profile)].name);
+    out.field("provisioning", provisioning);
+}
+
+void Wifi::write_metrics(xewe::metrics::Writer& out) const {
+    out.gauge("wifi_connected", "1 while associated with an IP.", is_connected() ? 1U : 0U);
+    if (is_connected()) out.gauge("wifi_rssi_dbm", "Signal strength of the current AP.", static_cast<int>(WiFi.RSSI()));
+    out.counter("wifi_connects_total", "Successful connections.", connect_hist.count());
+    out.counter("wifi_link_losses_total", "Connections lost after being established.", link_lost_count);
+    out.counter("wifi_roams_total", "Roams to a stronger BSSID.", roam_count);
+    out.gauge("wifi_failed_rounds", "Consecutive failed connect rounds.", failed_sequences);
+}
+
 bool Wifi::connect(bool prompt_for_credentials) {
     DBG_PRINTF(Wifi, "connect(prompt_for_credentials=%d)\n", prompt_for_credentials);
     if (is_disabled(true)) return false;
     if (is_connected(true)) return true;
 
-    // First debug is already present
-
-    std::string ssid, pwd;
-    if (read_stored_credentials(ssid, pwd)) {
-        DBG_PRINTLN(Wifi, "connect(): stored credentials found");
+    // known networks that keep failing fall through to the prompt when the user asked for it
+    const bool known_failing = link_state == LinkState::BACKOFF && failed_sequences > 0;
+    if (!known_networks.empty() && !(prompt_for_credentials && known_failing)) {
+        DBG_PRINTLN(Wifi, "connect(): known networks found");
+        controller.serial_port.printf("Connecting to the best of %u known network(s)", (unsigned)known_networks.size());
+        failed_sequences = 0;
+        begin_sequence();
+        return true;
+    }
 
-        controller.serial_port.print("Stored WiFi credentials found");
-        if (join(ssid, pwd, 10000, 3)) {
-            DBG_PRINTLN(Wifi, "connect(): join() succeeded with stored credentials");
-            return true;
-        } else {
-            DBG_PRINTLN(Wifi, "connect(): join() failed with stored credentials");
-            controller.serial_port.print("Stored WiFi credentials not valid.");
-            if (!prompt_for_credentials) {
-                controller.serial_port.print("Use '$wifi reset' to reset credentials");
-            }
-        }
-    } else {
-        DBG_PRINTLN(Wifi, "connect(): no stored credentials");
+    if (known_networks.empty()) {
+        DBG_PRINTLN(Wifi, "connect(): no known networks");
         controller.serial_port.print("Stored WiFi credentials not found");
-        if (!prompt_for_credentials) {
-            controller.serial_port.print("Type '$wifi connect' to select a new network");
-        }
+    } else {
+        controller.serial_port.print("Stored WiFi networks not reachable.");
+    }
+    if (!prompt_for_credentials) {
+        controller.serial_port.print("Type '$wifi connect' to select a new network\nor '$wifi add' to store one");
+        return false;
     }
 
+    std::string ssid, pwd;
+    while (is_disconnected()) {
+        DBG_PRINTLN(Wifi, "connect(): prompting for credentials");
+        uint8_t prompt_status = prompt_credentials(ssid, pwd);
+        DBG_PRINTF(Wifi, "connect(): prompt_credentials returned %d\n", prompt_status);
 
-    if (prompt_for_credentials) {
-        while (is_disconnected()) {
-            DBG_PRINTLN(Wifi, "connect(): prompting for credentials");
-            uint8_t prompt_status = prompt_credentials(ssid, pwd);
-            DBG_PRINTF(Wifi, "connect(): prompt_credentials returned %d\n", prompt_status);
-
-            if (prompt_status == 1) { // User exit
-                DBG_PRINTLN(Wifi, "connect(): user terminated setup");
-                controller.serial_port.print("Terminated WiFi setup");
-                return false;
-            } else if (prompt_status == 2) { // Rescan
-                DBG_PRINTLN(Wifi, "connect(): invalid choice, retrying");
-                continue;
-            } else if (prompt_status == 3) { // Invalid
-                DBG_PRINTLN(Wifi, "connect(): invalid choice, retrying");
-                controller.serial_port.print("Invalid choice");
-                continue;
-            } else {
-                DBG_PRINTLN(Wifi, "connect(): attempting join() with user credentials");
-                if (join(ssid, pwd, 10000, 1)) {
-                    DBG_PRINTLN(Wifi, "connect(): join() succeeded with user credentials");
-                    controller.nvs.write_str(nvs_key, "ssid", ssid);
-                    controller.nvs.write_str(nvs_key, "psw", pwd);
-                    return true;
-                }
+        if (prompt_status == 1) { // User exit
+            DBG_PRINTLN(Wifi, "connect(): user terminated setup");
+            controller.serial_port.print("Terminated WiFi setup");
+            return false;
+        } else if (prompt_status == 2) { // Rescan
+            DBG_PRINTLN(Wifi, "connect(): invalid choice, retrying");
+            continue;
+        } else if (prompt_status == 3) { // Invalid
+            DBG_PRINTLN(Wifi, "connect(): invalid choice, retrying");
+            controller.serial_port.print("Invalid choice");
+            continue;
+        } else {
+            DBG_PRINTLN(Wifi, "connect(): attempting join() with user credentials");
+            if (join(ssid, pwd, 10000)) {
+                DBG_PRINTLN(Wifi, "connect(): join() succeeded with user credentials");
+                add_network(ssid, pwd);
+                record_success();
+                return true;
             }
         }
     }
@@ -170,23 +370,1003 @@ bool Wifi::connect(bool prompt_for_credentials) {
 bool Wifi::disconnect(bool verbose) {
     DBG_PRINTLN(Wifi, "disconnect()");
     if (is_disabled(verbose)) return true;
-    if (is_disconnected(verbose)) return true;
 
-    DBG_PRINTLN(Wifi, "disconnect(): start");
+    const bool was_active = link_state != LinkState::IDLE;
+    set_link_state(LinkState::IDLE);
+    failed_sequences = 0;
+
+    if (!was_active && is_disconnected(verbose)) return true;
+
+    // the resulting STA_DISCONNECTED event is ignored in IDLE, so no reconnect follows
     WiFi.disconnect();
-    unsigned long start = millis();
-    constexpr unsigned long timeout = 5000;
-    while (WiFi.status() == WL_CONNECTED && millis() - start < timeout) {
-        delay(100);
-    }
-    bool done = (WiFi.status() != WL_CONNECTED);
-    DBG_PRINTF(Wifi, "disconnect(): %s\n", done ? "success" : "timeout/failure");
+    DBG_PRINTLN(Wifi, "disconnect(): requested");
 
     if (verbose) controller.serial_port.print("WiFi disconnected");
-    return done;
+    return true;
+}
+
+void Wifi::on_link_change(link_listener_t listener) {
+    link_listeners.push_back(std::move(listener));
+}
+
+// Runs on the WiFi event task: only record what happened, loop() acts on it.
+void Wifi::on_wifi_event(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+            assoc_at_ms.store(millis());
+            pending_events.fetch_or(EVT_CONNECTED);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            got_ip_at_ms.store(millis());
+            pending_events.fetch_or(EVT_GOT_IP);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            pending_reason.store(info.wifi_sta_disconnected.reason);
+            pending_events.fetch_or(EVT_DISCONNECTED);
+            break;
+        default:
+            break;
+    }
+}
+
+// A sequence tries the cached AP first (no scan), otherwise one async scan ranks the
+// known networks and each is tried in order; only a fully failed sequence backs off.
+void Wifi::begin_sequence() {
+    sequence_started_ms = millis();
+    timing = ConnectTiming{};
+    candidates.clear();
+    candidate_pos = 0;
+
+    const int cached = find_network(link_cache.ssid);
+    if (cached >= 0 && link_cache.channel != 0) {
+        Candidate c;
+        c.network = static_cast<uint8_t>(cached);
+        c.channel = link_cache.channel;
+        c.cached  = true;
+        memcpy(c.bssid, link_cache.bssid, sizeof(c.bssid));
+        candidates.push_back(c);
+        start_attempt();
+        return;
+    }
+    if (scan_fresh()) {
+        rank_candidates();
+        next_candidate();
+        return;
+    }
+    start_rank_scan();
+}
+
+void Wifi::start_rank_scan() {
+    DBG_PRINTLN(Wifi, "start_rank_scan()");
+    set_link_state(LinkState::SCANNING);
+    if (!start_scan(true)) {
+        // radio busy; try the stored networks without channel hints
+        rank_candidates();
+        next_candidate();
+    }
+}
+
+// score = rssi + 4 * priority, +10 for the network that connected most recently.
+// Networks missing from the scan table (hidden, or scan failed) are kept at the end.
+void Wifi::rank_candidates() {
+    candidates.clear();
+    candidate_pos = 0;
+
+    uint32_t newest = 0;
+    for (const auto& net : known_networks) newest = max(newest, net.last_success);
+
+    for (size_t i = 0; i < known_networks.size(); ++i) {
+        const KnownNetwork& net = known_networks[i];
+        Candidate c;
+        c.network = static_cast<uint8_t>(i);
+        for (uint8_t j = 0; j < scan_count; ++j) {
+            const ScanEntry& e = scan_table[j];
+            if (net.ssid != e.ssid) continue;
+            c.rssi    = e.rssi;
+            c.channel = e.channel;
+            memcpy(c.bssid, e.bssid, sizeof(c.bssid));
+            break;
+        }
+        const int16_t history = (newest != 0 && net.last_success == newest) ? 10 : 0;
+        c.score = (c.channel != 0 ? c.rssi : -1000) + 4 * net.priority + history;
+        candidates.push_back(c);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    DBG_PRINTF(Wifi, "rank_candidates(): %u in table, %u candidates\n", scan_count, (unsigned)candidates.size());
+}
+
+void Wifi::next_candidate() {
+    if (candidate_pos < candidates.size()) {
+        start_attempt();
+    } else {
+        fail_sequence();
+    }
+}
+
+void Wifi::start_attempt() {
+    // interactive join() sets the target itself and leaves the candidate list empty
+    const Candidate* c = candidate_pos < candidates.size() ? &candidates[candidate_pos] : nullptr;
+    if (c) {
+        target_ssid     = known_networks[c->network].ssid;
+        target_password = known_networks[c->network].password;
+    }
+    if (target_ssid.empty()) {
+        set_link_state(LinkState::IDLE);
+        return;
+    }
+    attempt_started_ms = millis();
+
+    fast_attempt = c && c->cached;
+    const bool reuse_ip = fast_attempt && ip_reuse && link_cache.ip != 0;
+    DBG_PRINTF(Wifi, "start_attempt(): ssid='%s', channel=%u, fast=%d, reuse_ip=%d\n",
+               target_ssid.c_str(), c ? c->channel : 0, fast_attempt, reuse_ip);
+
+    if (reuse_ip) {
+        WiFi.config(IPAddress(link_cache.ip), IPAddress(link_cache.gateway),
+                    IPAddress(link_cache.subnet), IPAddress(link_cache.dns));
+        static_ip_active = true;
+    } else if (static_ip_active) {
+        WiFi.config(IPAddress(), IPAddress(), IPAddress()); // back to DHCP
+        static_ip_active = false;
+    }
+
+    set_link_state(LinkState::CONNECTING);
+    // WiFi.begin() only writes the STA config here (connect=false); the listen interval
+    // is patched into it before the association is started
+    if (c && c->channel != 0) {
+        // channel and BSSID are known (cache or ranking scan): associate directly
+        WiFi.begin(target_ssid.c_str(), target_password.c_str(), c->channel, c->bssid, false);
+    } else {
+        WiFi.begin(target_ssid.c_str(), target_password.c_str(), 0, nullptr, false);
+    }
+    apply_listen_interval();
+    esp_wifi_connect();
+}
+
+void Wifi::fail_attempt(uint8_t reason) {
+    DBG_PRINTF(Wifi, "fail_attempt(reason=%u, fast=%d)\n", reason, fast_attempt);
+    last_disconnect_reason = reason;
+    WiFi.disconnect();
+
+    if (!auto_retry) {
+        set_link_state(LinkState::IDLE);
+        return;
+    }
+    if (fast_attempt) {
+        // cached AP gone or moved: rank everything with one scan right away, no backoff
+        timing.fast_fail_ms = millis() - attempt_started_ms;
+        fast_attempt = false;
+        start_rank_scan();
+        return;
+    }
+    candidate_pos++;
+    next_candidate();
+}
+
+void Wifi::fail_sequence() {
+    failed_sequences++;
+    if (failed_sequences >= PORTAL_AFTER_FAILURES) start_provisioning();
+
+    const uint8_t  shift   = failed_sequences > 7 ? 6 : failed_sequences - 1;
+    // STA retries hop the shared radio channel and drop portal clients, so space them out
+    const uint32_t wait_ms = provisioning ? BACKOFF_MAX_MS : min(BACKOFF_BASE_MS << shift, BACKOFF_MAX_MS);
+    next_attempt_ms = millis() + wait_ms;
+    set_link_state(LinkState::BACKOFF);
+    controller.serial_port.printf("No known WiFi network joined (%s); retrying in %lu s",
+        reason_name(last_disconnect_reason), (unsigned long)(wait_ms / 1000));
+}
+
+void Wifi::record_success() {
+    const int idx = find_network(target_ssid);
+    if (idx < 0) return;
+    KnownNetwork& net = known_networks[idx];
+    if (net.last_success != 0 && net.last_success == success_seq) return; // already the newest, skip the flash write
+
+    net.last_success = ++success_seq;
+    controller.nvs.write_uint32(nvs_key, "ok_seq", success_seq);
+    controller.nvs.write_uint32(nvs_key, "n_ok_" + std::to_string(idx), net.last_success);
+}
+
+void Wifi::set_link_state(LinkState state) {
+    if (state == link_state) return;
+    DBG_PRINTF(Wifi, "set_link_state(): %s -> %s\n", link_state_name(link_state), link_state_name(state));
+    if (link_state == LinkState::CONNECTED) {
+        stop_ping();
+        if (probe_session) finish_probe();
+    }
+    link_state = state;
+    if (state == LinkState::CONNECTED) {
+        if (ping_monitor) start_ping();
+        start_mdns();
+    }
+    for (auto& listener : link_listeners) {
+        if (listener) listener(state);
+    }
+}
+
+bool Wifi::add_network(std::string_view ssid, std::string_view password, uint8_t priority) {
+    if (is_disabled(true)) return false;
+    if (ssid.empty() || ssid.size() > 32 || password.size() > 63) return false;
+
+    const int idx = find_network(ssid);
+    if (idx >= 0) {
+        known_networks[idx].password = std::string(password);
+        known_networks[idx].priority = priority;
+    } else {
+        if (known_networks.size() >= MAX_KNOWN_NETWORKS) return false;
+        known_networks.push_back(KnownNetwork{std::string(ssid), std::string(password), priority, 0});
+    }
+    save_known_networks();
+    return true;
+}
+
+bool Wifi::forget_network(std::string_view ssid) {
+    if (is_disabled(true)) return false;
+
+    const int idx = find_network(ssid);
+    if (idx < 0) return false;
+    known_networks.erase(known_networks.begin() + idx);
+    save_known_networks();
+
+    // a running sequence still has to start the candidates after candidate_pos, by
+    // index into known_networks: drop the forgotten one and shift the rest. The ones
+    // up to candidate_pos have been started already and are not read again.
+    size_t kept = std::min(candidate_pos + 1, candidates.size());
+    for (size_t i = kept; i < candidates.size(); ++i) {
+        Candidate c = candidates[i];
+        if (c.network == idx) continue;
+        if (c.network > idx) c.network--;
+        candidates[kept++] = c;
+    }
+    candidates.resize(kept);
+    return true;
+}
+
+void Wifi::load_known_networks() {
+    known_networks.clear();
+    success_seq = controller.nvs.read_uint32(nvs_key, "ok_seq");
+
+    const uint8_t count = min(controller.nvs.read_uint8(nvs_key, "net_cnt"), MAX_KNOWN_NETWORKS);
+    for (uint8_t i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+        KnownNetwork net;
+        net.ssid         = controller.nvs.read_str(nvs_key, "n_ssid_" + n);
+        net.password     = controller.nvs.read_str(nvs_key, "n_psw_" + n);
+        net.priority     = controller.nvs.read_uint8(nvs_key, "n_pri_" + n);
+        net.last_success = controller.nvs.read_uint32(nvs_key, "n_ok_" + n);
+        if (!net.ssid.empty()) known_networks.push_back(std::move(net));
+    }
+
+    // migrate the single-network layout used by earlier builds
+    std::string legacy_ssid = controller.nvs.read_str(nvs_key, "ssid");
+    if (!legacy_ssid.empty()) {
+        if (find_network(legacy_ssid) < 0 && known_networks.size() < MAX_KNOWN_NETWORKS) {
+            known_networks.push_back(KnownNetwork{legacy_ssid, controller.nvs.read_str(nvs_key, "psw"), 0, 0});
+            save_known_networks();
+        }
+        controller.nvs.remove(nvs_key, "ssid");
+        controller.nvs.remove(nvs_key, "psw");
+    }
+    DBG_PRINTF(Wifi, "load_known_networks(): %u networks\n", (unsigned)known_networks.size());
+}
+
+void Wifi::save_known_networks() {
+    const uint8_t old_count = controller.nvs.read_uint8(nvs_key, "net_cnt");
+    for (size_t i = 0; i < known_networks.size(); ++i) {
+        const std::string n = std::to_string(i);
+        controller.nvs.write_str(nvs_key, "n_ssid_" + n, known_networks[i].ssid);
+        controller.nvs.write_str(nvs_key, "n_psw_" + n, known_networks[i].password);
+        controller.nvs.write_uint8(nvs_key, "n_pri_" + n, known_networks[i].priority);
+        controller.nvs.write_uint32(nvs_key, "n_ok_" + n, known_networks[i].last_success);
+    }
+    for (size_t i = known_networks.size(); i < old_count; ++i) {
+        const std::string n = std::to_string(i);
+        controller.nvs.remove(nvs_key, "n_ssid_" + n);
+        controller.nvs.remove(nvs_key, "n_psw_" + n);
+        controller.nvs.remove(nvs_key, "n_pri_" + n);
+        controller.nvs.remove(nvs_key, "n_ok_" + n);
+    }
+    controller.nvs.write_uint8(nvs_key, "net_cnt", static_cast<uint8_t>(known_networks.size()));
+}
+
+int Wifi::find_network(std::string_view ssid) const {
+    if (ssid.empty()) return -1;
+    for (size_t i = 0; i < known_networks.size(); ++i) {
+        if (known_networks[i].ssid == ssid) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void Wifi::add_network_cli(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::vector<std::string> parts = split_args(args);
+    uint8_t priority = 0;
+    if (parts.size() != 3 || !parse_int<uint8_t>(parts[2], priority)) {
+        controller.serial_port.print("Error: expected <ssid> <password|-> <priority 0-255>");
+        return;
+    }
+    const std::string password = (parts[1] == "-") ? std::string() : parts[1];
+    if (find_network(parts[0]) < 0 && known_networks.size() >= MAX_KNOWN_NETWORKS) {
+        controller.serial_port.printf("Error: network list full (%u); use '$wifi forget' first", (unsigned)MAX_KNOWN_NETWORKS);
+        return;
+    }
+    if (!add_network(parts[0], password, priority)) {
+        controller.serial_port.print("Error: SSID must be 1-32 chars, password at most 63");
+        return;
+    }
+    controller.serial_port.printf("Stored network '%s' with priority %u", parts[0].c_str(), (unsigned)priority);
+}
+
+void Wifi::forget_network_cli(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::vector<std::string> parts = split_args(args);
+    if (parts.size() != 1 || !forget_network(parts[0])) {
+        controller.serial_port.print("Error: no stored network '" + std::string(args) + "'");
+        return;
+    }
+    controller.serial_port.print("Forgot network '" + parts[0] + "'");
+}
+
+void Wifi::print_networks() const {
+    if (is_disabled(true)) return;
+    if (known_networks.empty()) {
+        controller.serial_port.print("No stored networks; use '$wifi add'");
+        return;
+    }
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"SSID", "Priority", "Last Success"});
+    vector<string> string_storage;
+    string_storage.reserve(known_networks.size() * 2);
+    for (const auto& net : known_networks) {
+        string_storage.push_back(std::to_string(net.priority));
+        string_view priority_view = string_storage.back();
+        string_storage.push_back(net.last_success == 0 ? "never"
+                                 : (net.last_success == success_seq ? "latest"
+                                    : std::to_string(success_seq - net.last_success) + " connects ago"));
+        string_view success_view = string_storage.back();
+        table_data.push_back({net.ssid, priority_view, success_view});
+    }
+    controller.serial_port.print_table(table_data, "Stored Networks");
+}
+
+void Wifi::load_link_cache() {
+    link_cache = LinkCache{};
+    ip_reuse   = controller.nvs.read_bool(nvs_key, "ip_reuse");
+    roam_threshold = -static_cast<int8_t>(controller.nvs.read_uint8(nvs_key, "roam_dbm", -ROAM_THRESHOLD_DEFAULT));
+    ping_monitor   = controller.nvs.read_bool(nvs_key, "ping_mon");
+
+    std::string ssid = controller.nvs.read_str(nvs_key, "c_ssid");
+    if (ssid.empty()) return;
+    if (!from_hex(controller.nvs.read_str(nvs_key, "c_bssid"), link_cache.bssid, sizeof(link_cache.bssid))) return;
+
+    link_cache.ssid    = std::move(ssid);
+    link_cache.channel = controller.nvs.read_uint8(nvs_key, "c_chan");
+    link_cache.ip      = controller.nvs.read_uint32(nvs_key, "c_ip");
+    link_cache.gateway = controller.nvs.read_uint32(nvs_key, "c_gw");
+    link_cache.subnet  = controller.nvs.read_uint32(nvs_key, "c_mask");
+    link_cache.dns     = controller.nvs.read_uint32(nvs_key, "c_dns");
+    DBG_PRINTF(Wifi, "load_link_cache(): ssid='%s', channel=%u\n", link_cache.ssid.c_str(), link_cache.channel);
+}
+
+// Only touches flash for fields that changed, so a stable network costs no writes.
+void Wifi::save_link_cache() {
+    LinkCache fresh;
+    fresh.ssid    = target_ssid;
+    fresh.channel = static_cast<uint8_t>(WiFi.channel());
+    fresh.ip      = static_cast<uint32_t>(WiFi.localIP());
+    fresh.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+    fresh.subnet  = static_cast<uint32_t>(WiFi.subnetMask());
+    fresh.dns     = static_cast<uint32_t>(WiFi.dnsIP(0));
+    if (const uint8_t* bssid = WiFi.BSSID()) memcpy(fresh.bssid, bssid, sizeof(fresh.bssid));
+
+    if (fresh.ssid != link_cache.ssid)
+        controller.nvs.write_str(nvs_key, "c_ssid", fresh.ssid);
+    if (memcmp(fresh.bssid, link_cache.bssid, sizeof(fresh.bssid)) != 0)
+        controller.nvs.write_str(nvs_key, "c_bssid", to_hex(fresh.bssid, sizeof(fresh.bssid)));
+    if (fresh.channel != link_cache.channel) controller.nvs.write_uint8(nvs_key, "c_chan", fresh.channel);
+    if (fresh.ip      != link_cache.ip)      controller.nvs.write_uint32(nvs_key, "c_ip", fresh.ip);
+    if (fresh.gateway != link_cache.gateway) controller.nvs.write_uint32(nvs_key, "c_gw", fresh.gateway);
+    if (fresh.subnet  != link_cache.subnet)  controller.nvs.write_uint32(nvs_key, "c_mask", fresh.subnet);
+    if (fresh.dns     != link_cache.dns)     controller.nvs.write_uint32(nvs_key, "c_dns", fresh.dns);
+
+    link_cache = std::move(fresh);
+}
+
+void Wifi::set_ip_reuse(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::string mode = to_lower(std::string(args));
+    if (mode != "on" && mode != "off") {
+        controller.serial_port.print("Error: expected 'on' or 'off'");
+        return;
+    }
+    ip_reuse = (mode == "on");
+    controller.nvs.write_bool(nvs_key, "ip_reuse", ip_reuse);
+    controller.serial_port.printf("IP lease reuse %s", ip_reuse ? "enabled" : "disabled");
+}
+
+// Low-rate link sampling, roughly one RSSI read per MONITOR_INTERVAL_MS; ping results
+// arrive from the esp_ping task through atomics and are folded in here.
+void Wifi::sample_link(uint32_t now) {
+    const uint32_t rtt = pending_rtt_ms.exchange(0);
+    if (rtt != 0) rtt_hist.add(rtt - 1);
+    ping_timeouts += pending_ping_timeouts.exchange(0);
+
+    if (now - last_sample_ms < MONITOR_INTERVAL_MS) return;
+    last_sample_ms = now;
+
+    const int8_t rssi = static_cast<int8_t>(WiFi.RSSI());
+    rssi_hist.add(rssi);
+
+    if (roam_threshold == 0 || rssi >= roam_threshold) {
+        weak_samples = 0;
+        return;
+    }
+    if (++weak_samples < ROAM_LOW_SAMPLES) return;
+    if (last_roam_check_ms != 0 && now - last_roam_check_ms < ROAM_COOLDOWN_MS) return;
+    last_roam_check_ms = now;
+    weak_samples       = 0;
+
+    DBG_PRINTF(Wifi, "sample_link(): rssi %d below %d, looking for a better AP\n", rssi, roam_threshold);
+    if (scan_fresh()) {
+        evaluate_roam();
+    } else if (start_scan(false)) {
+        roam_pending = true;
+    }
+}
+
+// The scan table keeps the strongest BSSID per SSID, so the row for our SSID is the best roam target.
+void Wifi::evaluate_roam() {
+    if (link_state != LinkState::CONNECTED) return;
+
+    const int idx = find_network(target_ssid);
+    const uint8_t* current = WiFi.BSSID();
+    if (idx < 0 || !current) return;
+
+    const int8_t rssi = static_cast<int8_t>(WiFi.RSSI());
+    for (uint8_t i = 0; i < scan_count; ++i) {
+        const ScanEntry& e = scan_table[i];
+        if (target_ssid != e.ssid) continue;
+        if (memcmp(e.bssid, current, sizeof(e.bssid)) == 0) return;
+        if (e.rssi < rssi + ROAM_HYSTERESIS_DB) return;
+
+        controller.serial_port.printf("Roaming to %s (%d dBm -> %d dBm, ch %u)",
+            to_hex(e.bssid, sizeof(e.bssid)).c_str(), rssi, e.rssi, e.channel);
+        roam_count++;
+
+        Candidate c;
+        c.network = static_cast<uint8_t>(idx);
+        c.channel = e.channel;
+        c.rssi    = e.rssi;
+        memcpy(c.bssid, e.bssid, sizeof(c.bssid));
+        candidates.assign(1, c);
+        candidate_pos       = 0;
+        sequence_started_ms = millis();
+        timing              = ConnectTiming{};
+        start_attempt();
+        return;
+    }
+}
+
+void Wifi::start_ping() {
+    if (ping_session) return;
+
+    const esp_ping_config_t config = gateway_ping_config(ESP_PING_COUNT_INFINITE, PING_INTERVAL_MS);
+
+    esp_ping_callbacks_t callbacks = {};
+    callbacks.cb_args = this;
+    callbacks.on_ping_success = [](esp_ping_handle_t handle, void* args) {
+        uint32_t elapsed_ms = 0;
+        esp_ping_get_profile(handle, ESP_PING_PROF_TIMEGAP, &elapsed_ms, sizeof(elapsed_ms));
+        static_cast<Wifi*>(args)->pending_rtt_ms.store(elapsed_ms + 1);
+    };
+    callbacks.on_ping_timeout = [](esp_ping_handle_t, void* args) {
+        static_cast<Wifi*>(args)->pending_ping_timeouts.fetch_add(1);
+    };
+
+    if (esp_ping_new_session(&config, &callbacks, &ping_session) != ESP_OK) {
+        DBG_PRINTLN(Wifi, "start_ping(): session not created");
+        ping_session = nullptr;
+        return;
+    }
+    esp_ping_start(ping_session);
+}
+
+void Wifi::stop_ping() {
+    if (!ping_session) return;
+    esp_ping_stop(ping_session);
+    esp_ping_delete_session(ping_session);
+    ping_session = nullptr;
+}
+
+esp_ping_config_t Wifi::gateway_ping_config(uint32_t count, uint32_t interval_ms) {
+    esp_ping_config_t config = ESP_PING_DEFAULT_CONFIG();
+    config.count       = count;
+    config.interval_ms = interval_ms;
+    config.target_addr.type = IPADDR_TYPE_V4;
+    ip_addr_set_ip4_u32(&config.target_addr, static_cast<uint32_t>(WiFi.gatewayIP()));
+    return config;
+}
+
+void Wifi::apply_power_profile() {
+    const PowerSettings& p = POWER_PROFILES[static_cast<size_t>(power_profile)];
+    DBG_PRINTF(Wifi, "apply_power_profile(): %s\n", p.name);
+    WiFi.setSleep(p.sleep);
+    WiFi.setTxPower(p.tx_power);
+}
+
+// WiFi.begin() rewrites the STA config without a listen interval, so patch it in before
+// the connect is issued; the driver reads it when it sends the association request.
+void Wifi::apply_listen_interval() {
+    wifi_config_t config;
+    if (esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK) return;
+
+    const uint16_t listen_interval = POWER_PROFILES[static_cast<size_t>(power_profile)].listen_interval;
+    if (config.sta.listen_interval == listen_interval) return;
+    config.sta.listen_interval = listen_interval;
+    esp_wifi_set_config(WIFI_IF_STA, &config);
+}
+
+bool Wifi::set_power_profile(PowerProfile profile) {
+    if (profile >= PowerProfile::COUNT) return false;
+    power_profile = profile;
+    controller.nvs.write_uint8(nvs_key, "power", static_cast<uint8_t>(profile));
+    apply_power_profile();
+    return true;
+}
+
+void Wifi::set_power_cli(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    const std::string name = to_lower(std::string(args));
+    for (size_t i = 0; i < static_cast<size_t>(PowerProfile::COUNT); ++i) {
+        if (name != POWER_PROFILES[i].name) continue;
+        const uint16_t old_interval = POWER_PROFILES[static_cast<size_t>(power_profile)].listen_interval;
+        set_power_profile(static_cast<PowerProfile>(i));
+        controller.serial_port.printf("Power profile: %s", POWER_PROFILES[i].name);
+        if (POWER_PROFILES[i].listen_interval != old_interval && is_connected())
+            controller.serial_port.print("Listen interval applies from the next connection");
+        return;
+    }
+    controller.serial_port.print("Error: expected 'performance', 'balanced' or 'lowpower'");
+}
+
+// Latency probe: PROBE_COUNT pings to the gateway, run by the esp_ping task. Results
+// are kept per power profile so `$wifi probe` after each `$wifi power` builds a comparison.
+void Wifi::start_probe() {
+    if (is_disabled(true)) return;
+    if (link_state != LinkState::CONNECTED) {
+        controller.serial_port.print("Error: not connected");
+        return;
+    }
+    if (probe_session) {
+        controller.serial_port.print("Probe already running");
+        return;
+    }
+
+    probe_received.store(0);
+    probe_sum_ms.store(0);
+    probe_min_ms.store(UINT32_MAX);
+    probe_max_ms.store(0);
+    probe_done.store(false);
+
+    const esp_ping_config_t config = gateway_ping_config(PROBE_COUNT, PROBE_INTERVAL_MS);
+    esp_ping_callbacks_t callbacks = {};
+    callbacks.cb_args = this;
+    callbacks.on_ping_success = [](esp_ping_handle_t handle, void* args) {
+        Wifi* self = static_cast<Wifi*>(args);
+        uint32_t elapsed_ms = 0;
+        esp_ping_get_profile(handle, ESP_PING_PROF_TIMEGAP, &elapsed_ms, sizeof(elapsed_ms));
+        self->probe_received.fetch_add(1);
+        self->probe_sum_ms.fetch_add(elapsed_ms);
+        // only the ping task writes these, so load/store is enough
+        if (elapsed_ms < self->probe_min_ms.load()) self->probe_min_ms.store(elapsed_ms);
+        if (elapsed_ms > self->probe_max_ms.load()) self->probe_max_ms.store(elapsed_ms);
+    };
+    callbacks.on_ping_end = [](esp_ping_handle_t, void* args) {
+        static_cast<Wifi*>(args)->probe_done.store(true);
+    };
+
+    if (esp_ping_new_session(&config, &callbacks, &probe_session) != ESP_OK) {
+        probe_session = nullptr;
+        controller.serial_port.print("Error: could not start ping session");
+        return;
+    }
+    esp_ping_start(probe_session);
+    controller.serial_port.printf("Probing gateway latency (%u pings, %s profile)...",
+        PROBE_COUNT, POWER_PROFILES[static_cast<size_t>(power_profile)].name);
+}
+
+void Wifi::finish_probe() {
+    const bool completed = probe_done.load();
+    esp_ping_stop(probe_session);
+    esp_ping_delete_session(probe_session);
+    probe_session = nullptr;
+    if (!completed) {
+        controller.serial_port.print("Latency probe aborted: link lost");
+        return;
+    }
+
+    ProbeResult& r = probe_results[static_cast<size_t>(power_profile)];
+    r.sent     = PROBE_COUNT;
+    r.received = static_cast<uint8_t>(probe_received.load());
+    r.min_ms   = r.received ? probe_min_ms.load() : 0;
+    r.max_ms   = probe_max_ms.load();
+    r.avg_ms   = r.received ? probe_sum_ms.load() / r.received : 0;
+    print_probes();
+}
+
+void Wifi::print_probes() const {
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"Profile", "Min ms", "Avg ms", "Max ms", "Loss %"});
+    vector<string> string_storage;
+    string_storage.reserve(static_cast<size_t>(PowerProfile::COUNT) * 4);
+    for (size_t i = 0; i < static_cast<size_t>(PowerProfile::COUNT); ++i) {
+        const ProbeResult& r = probe_results[i];
+        if (r.sent == 0) continue;
+        string_storage.push_back(std::to_string(r.min_ms));
+        string_view min_view = string_storage.back();
+        string_storage.push_back(std::to_string(r.avg_ms));
+        string_view avg_view = string_storage.back();
+        string_storage.push_back(std::to_string(r.max_ms));
+        string_view max_view = string_storage.back();
+        string_storage.push_back(std::to_string((r.sent - r.received) * 100 / r.sent));
+        string_view loss_view = string_storage.back();
+        table_data.push_back({POWER_PROFILES[i].name, min_view, avg_view, max_view, loss_view});
+    }
+    controller.serial_port.print_table(table_data, "Gateway Latency");
+}
+
+// The portal runs the SoftAP next to STA (AP+STA), so stored networks keep being retried
+// and every other module keeps running; DNS answers every name with the AP address.
+void Wifi::start_provisioning() {
+    if (provisioning) return;
+
+    std::string ap_ssid = controller.system.get_device_name();
+    ap_ssid = (ap_ssid.empty() ? std::string("xewe") : ap_ssid) + "-setup";
+    WiFi.mode(WIFI_AP_STA);
+    if (!WiFi.softAP(ap_ssid.c_str())) {
+        controller.serial_port.print("Error: could not start provisioning access point");
+        WiFi.mode(WIFI_STA);
+        return;
+    }
+    dns_server.start(DNS_PORT, "*", WiFi.softAPIP());
+    provisioning       = true;
+    portal_close_at_ms = 0;
+    controller.serial_port.printf("WiFi provisioning portal open\nJoin '%s' and browse to http://%s",
+        ap_ssid.c_str(), get_portal_ip().c_str());
+    if (!controller.web_interface.is_enabled())
+        controller.serial_port.print("Note: Web_Interface is disabled; the portal pages need it");
+}
+
+void Wifi::stop_provisioning() {
+    if (!provisioning) return;
+
+    dns_server.stop();
+    WiFi.softAPdisconnect(true);
+    WiFi.mode(WIFI_STA);
+    provisioning = false;
+    controller.serial_port.print("WiFi provisioning portal closed");
+}
+
+bool Wifi::provision(std::string_view ssid, std::string_view password) {
+    if (!add_network(ssid, password, 0)) return false;
+    // newest credentials first: skip the cached AP and backoff, rank right away
+    link_cache.channel = 0;
+    failed_sequences   = 0;
+    portal_close_at_ms = 0;
+    if (link_state != LinkState::CONNECTED) begin_sequence();
+    return true;
+}
+
+std::string Wifi::get_portal_ip() const {
+    const IPAddress ip = WiFi.softAPIP();
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return std::string(buf);
+}
+
+bool Wifi::is_portal_address(uint32_t ip) const {
+    return provisioning && ip != 0 && ip == static_cast<uint32_t>(WiFi.softAPIP());
+}
+
+// Serves the portal's network list from the scan table; a stale table triggers a
+// background rescan and the page simply polls again.
+std::string Wifi::scan_results_json() {
+    if (!scan_fresh()) start_scan(false);
+
+    std::string json = "{\"scanning\":";
+    json += scan_running ? "true" : "false";
+    json += ",\"networks\":[";
+    for (uint8_t i = 0; i < scan_count; ++i) {
+        const ScanEntry& e = scan_table[i];
+        if (i) json += ',';
+        json += "{\"ssid\":\"" + json_escape(e.ssid) + "\",\"rssi\":" + std::to_string(e.rssi)
+              + ",\"open\":" + (e.auth == WIFI_AUTH_OPEN ? "true" : "false") + "}";
+    }
+    json += "]}";
+    return json;
+}
+
+void Wifi::set_portal_cli(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::string mode = to_lower(std::string(args));
+    if (mode == "on")       start_provisioning();
+    else if (mode == "off") stop_provisioning();
+    else                    controller.serial_port.print("Error: expected 'on' or 'off'");
+}
+
+// mDNS labels allow [a-z0-9-] only; anything else in the device name becomes '-'.
+// Without a usable name the MAC tail keeps units on one network distinct.
+void Wifi::resolve_hostname() {
+    hostname.clear();
+    for (char c : to_lower(controller.system.get_device_name())) {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+        if (valid) hostname.push_back(c);
+        else if (!hostname.empty() && hostname.back() != '-') hostname.push_back('-');
+    }
+    while (!hostname.empty() && hostname.back() == '-') hostname.pop_back();
+    if (hostname.size() > 63) hostname.resize(63);
+
+    if (hostname.empty()) {
+        uint8_t mac[6];
+        WiFi.macAddress(mac);
+        hostname = "xewe-" + to_lower(to_hex(mac + 3, 3));
+    }
+}
+
+// Started on the first connection and refreshed on every reconnect, so the TXT
+// record follows modules that were enabled or disabled since.
+void Wifi::start_mdns() {
+    if (!mdns_started) {
+        if (!MDNS.begin(hostname.c_str())) {
+            DBG_PRINTLN(Wifi, "start_mdns(): responder failed to start");
+            return;
+        }
+        MDNS.setInstanceName(controller.system.get_device_name().c_str());
+        MDNS.addService("xewe", "tcp", 80);
+        if (controller.web_interface.is_enabled()) MDNS.addService("http", "tcp", 80);
+        mdns_started = true;
+    }
+
+    std::string modules;
+    for (Module* m : controller.get_modules()) {
+        if (!m || !m->is_enabled()) continue;
+        std::string name = to_lower(std::string(m->get_module_name()));
+        if (modules.size() + name.size() + 1 > 200) break;    // TXT values are capped at 255 bytes
+        if (!modules.empty()) modules += ',';
+        modules += name;
+    }
+    MDNS.addServiceTxt("xewe", "tcp", "version", TO_STRING(BUILD_VERSION));
+    MDNS.addServiceTxt("xewe", "tcp", "modules", modules.c_str());
+    DBG_PRINTF(Wifi, "start_mdns(): %s.local, modules=%s\n", hostname.c_str(), modules.c_str());
+}
+
+void Wifi::stop_mdns() {
+    if (discovery) {
+        mdns_query_async_delete(discovery);
+        discovery = nullptr;
+    }
+    if (!mdns_started) return;
+    MDNS.end();
+    mdns_started = false;
+}
+
+// PTR query for _xewe._tcp runs in the mDNS task; loop() collects the answers.
+void Wifi::start_discovery() {
+    if (is_disabled(true)) return;
+    if (!mdns_started) {
+        controller.serial_port.print("Error: not connected");
+        return;
+    }
+    if (discovery) {
+        controller.serial_port.print("Discovery already running");
+        return;
+    }
+    discovery = mdns_query_async_new(nullptr, "_xewe", "_tcp", MDNS_TYPE_PTR, DISCOVER_TIMEOUT_MS, DISCOVER_MAX_RESULTS, nullptr);
+    if (!discovery) {
+        controller.serial_port.print("Error: could not start mDNS query");
+        return;
+    }
+    controller.serial_port.printf("Looking for devices (%lu s)...", (unsigned long)(DISCOVER_TIMEOUT_MS / 1000));
 }
 
-bool Wifi::join(std::string_view ssid, std::string_view password, uint16_t timeout_ms, uint8_t retry_count) {
+void Wifi::poll_discovery() {
+    mdns_result_t* results = nullptr;
+    uint8_t count = 0;
+    if (!mdns_query_async_get_results(discovery, 0, &results, &count)) return;
+    mdns_query_async_delete(discovery);
+    discovery = nullptr;
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"Host", "Address", "Version", "Name"});
+    vector<string> string_storage;
+    string_storage.reserve(count * 3);
+    for (mdns_result_t* r = results; r; r = r->next) {
+        if (r->hostname && hostname == r->hostname) continue;
+
+        string_storage.push_back(std::string(r->hostname ? r->hostname : "?") + ".local");
+        string_view host_view = string_storage.back();
+
+        std::string address = "-";
+        for (mdns_ip_addr_t* a = r->addr; a; a = a->next) {
+            if (a->addr.type != ESP_IPADDR_TYPE_V4) continue;
+            const IPAddress ip(a->addr.u_addr.ip4.addr);
+            address = std::string(ip.toString().c_str()) + ":" + std::to_string(r->port);
+            break;
+        }
+        string_storage.push_back(std::move(address));
+        string_view address_view = string_storage.back();
+
+        std::string version = "-";
+        for (size_t t = 0; t < r->txt_count; ++t) {
+            if (r->txt[t].key && strcmp(r->txt[t].key, "version") == 0 && r->txt[t].value) version = r->txt[t].value;
+        }
+        string_storage.push_back(std::move(version));
+        string_view version_view = string_storage.back();
+
+        table_data.push_back({host_view, address_view, version_view, r->instance_name ? r->instance_name : ""});
+    }
+    if (results) mdns_query_results_free(results);
+
+    if (table_data.size() == 1) {
+        controller.serial_port.print("No other devices found");
+        return;
+    }
+    controller.serial_port.print_table(table_data, "XeWe Devices");
+}
+
+void Wifi::set_roam_threshold(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    int dbm = 0;
+    std::string value = to_lower(std::string(args));
+    if (value != "off" && (!parse_int<int>(value, dbm) || dbm < -95 || dbm > -40)) {
+        controller.serial_port.print("Error: expected 'off' or a threshold between -95 and -40 dBm");
+        return;
+    }
+    roam_threshold = static_cast<int8_t>(dbm);
+    weak_samples   = 0;
+    controller.nvs.write_uint8(nvs_key, "roam_dbm", static_cast<uint8_t>(-dbm));
+    if (roam_threshold == 0) controller.serial_port.print("Roaming disabled");
+    else                     controller.serial_port.printf("Roaming below %d dBm", roam_threshold);
+}
+
+void Wifi::set_ping_monitor(std::string_view args) {
+    if (is_disabled(true)) return;
+
+    std::string mode = to_lower(std::string(args));
+    if (mode != "on" && mode != "off") {
+        controller.serial_port.print("Error: expected 'on' or 'off'");
+        return;
+    }
+    ping_monitor = (mode == "on");
+    controller.nvs.write_bool(nvs_key, "ping_mon", ping_monitor);
+    if (ping_monitor && link_state == LinkState::CONNECTED) start_ping();
+    if (!ping_monitor) stop_ping();
+    controller.serial_port.printf("Gateway ping monitor %s", ping_monitor ? "enabled" : "disabled");
+}
+
+template <size_t N>
+void Wifi::print_histogram(const xewe::stats::Histogram<N>& hist, string_view title, string_view unit) const {
+    if (hist.count() == 0) {
+        controller.serial_port.printf("%.*s: no samples", (int)title.size(), title.data());
+        return;
+    }
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"Range", "Count", "%"});
+    vector<string> string_storage;
+    string_storage.reserve(hist.size() * 3);
+    for (size_t i = 0; i < hist.size(); ++i) {
+        string_storage.push_back(hist.label(i));
+        string_view label_view = string_storage.back();
+        string_storage.push_back(std::to_string(hist.count(i)));
+        string_view count_view = string_storage.back();
+        string_storage.push_back(std::to_string(hist.count(i) * 100 / hist.count()));
+        string_view percent_view = string_storage.back();
+        table_data.push_back({label_view, count_view, percent_view});
+    }
+    controller.serial_port.print_table(table_data, title);
+
+    const std::string u(unit);
+    controller.serial_port.printf("n=%lu min=%ld%s mean=%ld%s p90=%ld%s max=%ld%s",
+        (unsigned long)hist.count(),
+        (long)hist.min(), u.c_str(), (long)hist.mean(), u.c_str(),
+        (long)hist.percentile(90), u.c_str(), (long)hist.max(), u.c_str());
+}
+
+void Wifi::print_stats() const {
+    if (is_disabled(true)) return;
+
+    print_histogram(rssi_hist, "RSSI (dBm)", " dBm");
+    print_histogram(connect_hist, "Connect Time (ms)", " ms");
+    if (ping_monitor || rtt_hist.count() > 0) {
+        print_histogram(rtt_hist, "Gateway RTT (ms)", " ms");
+        controller.serial_port.printf("Ping timeouts: %lu", (unsigned long)ping_timeouts);
+    }
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"Disconnect Reason", "Code", "Count"});
+    vector<string> string_storage;
+    string_storage.reserve(reason_tally.size() * 2);
+    for (size_t i = 0; i < reason_tally.size(); ++i) {
+        string_storage.push_back(std::to_string(reason_tally.key(i)));
+        string_view code_view = string_storage.back();
+        string_storage.push_back(std::to_string(reason_tally.count(i)));
+        string_view count_view = string_storage.back();
+        table_data.push_back({reason_name(reason_tally.key(i)), code_view, count_view});
+    }
+    if (reason_tally.size() > 0) controller.serial_port.print_table(table_data, "Disconnects");
+
+    controller.serial_port.printf("Link losses: %lu\nRoams: %lu\nRoam threshold: %s",
+        (unsigned long)link_lost_count, (unsigned long)roam_count,
+        roam_threshold == 0 ? "off" : (std::to_string(roam_threshold) + " dBm").c_str());
+}
+
+std::string Wifi::format_timing(const ConnectTiming& t) const {
+    char buf[128];
+    int n = snprintf(buf, sizeof(buf), "%lu ms (%s",
+                     (unsigned long)t.total_ms, t.fast_path ? "fast path" : "scan");
+    if (t.fast_fail_ms > 0 && n > 0 && n < (int)sizeof(buf))
+        n += snprintf(buf + n, sizeof(buf) - n, ", fast path failed after %lu ms", (unsigned long)t.fast_fail_ms);
+    if (t.scan_ms > 0 && n > 0 && n < (int)sizeof(buf))
+        n += snprintf(buf + n, sizeof(buf) - n, ", scan %lu ms", (unsigned long)t.scan_ms);
+    if (n > 0 && n < (int)sizeof(buf))
+        snprintf(buf + n, sizeof(buf) - n, ", assoc %lu ms, %s %lu ms)",
+                 (unsigned long)t.assoc_ms, t.reused_ip ? "cached ip" : "dhcp", (unsigned long)t.ip_ms);
+    return std::string(buf);
+}
+
+const char* Wifi::link_state_name(LinkState state) {
+    switch (state) {
+        case LinkState::IDLE:       return "idle";
+        case LinkState::SCANNING:   return "scanning";
+        case LinkState::CONNECTING: return "connecting";
+        case LinkState::CONNECTED:  return "connected";
+        case LinkState::BACKOFF:    return "backoff";
+    }
+    return "unknown";
+}
+
+const char* Wifi::reason_name(uint8_t reason) {
+    switch (reason) {
+        case 0:                                 return "timeout";
+        case WIFI_REASON_AUTH_EXPIRE:           return "auth expired";
+        case WIFI_REASON_ASSOC_LEAVE:           return "left";
+        case WIFI_REASON_BEACON_TIMEOUT:        return "beacon timeout";
+        case WIFI_REASON_NO_AP_FOUND:           return "no AP found";
+        case WIFI_REASON_AUTH_FAIL:             return "auth failed";
+        case WIFI_REASON_ASSOC_FAIL:            return "assoc failed";
+        case WIFI_REASON_HANDSHAKE_TIMEOUT:     return "handshake timeout";
+        case WIFI_REASON_CONNECTION_FAIL:       return "connection failed";
+        default:                                return "other";
+    }
+}
+
+const char* Wifi::auth_name(uint8_t auth) {
+    switch (auth) {
+        case WIFI_AUTH_OPEN:            return "open";
+        case WIFI_AUTH_WEP:             return "WEP";
+        case WIFI_AUTH_WPA_PSK:         return "WPA";
+        case WIFI_AUTH_WPA2_PSK:        return "WPA2";
+        case WIFI_AUTH_WPA_WPA2_PSK:    return "WPA/WPA2";
+        case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2-EAP";
+        case WIFI_AUTH_WPA3_PSK:        return "WPA3";
+        case WIFI_AUTH_WPA2_WPA3_PSK:   return "WPA2/WPA3";
+        default:                        return "other";
+    }
+}
+
+// Interactive join used by the credential prompt: the state machine does the work,
+// this only waits for its verdict so the user can re-enter a wrong password.
+bool Wifi::join(std::string_view ssid, std::string_view password, uint16_t timeout_ms) {
     DBG_PRINTF(Wifi,
         "join(ssid='%.*s', password='%.*s')\n",
         int(ssid.size()), ssid.data(),
@@ -194,87 +1374,176 @@ bool Wifi::join(std::string_view ssid, std::string_view password, uint16_t timeo
     );
     if (is_disabled(true)) return false;
 
-    for(uint8_t retry_counter = 0; retry_counter < retry_count; retry_counter++){
-        // Optimized: Print "Joining [ssid]" without a newline (end="") so dots appear on same line
-        controller.serial_port.print(std::string("Joining ") + std::string(ssid), "");
+    controller.serial_port.print(std::string("Joining ") + std::string(ssid), "");
 
-        DBG_PRINTF(Wifi, "join(): ssid='%.*s'\n", int(ssid.size()), ssid.data());
-        WiFi.begin(ssid.data(), password.data());
-        unsigned long start = millis();
+    target_ssid     = std::string(ssid);
+    target_password = std::string(password);
+    candidates.clear();
+    candidate_pos   = 0;
+    auto_retry      = false;
+    sequence_started_ms = millis();
+    timing          = ConnectTiming{};
+    start_attempt();
 
-        while (millis() - start < timeout_ms) {
+    const uint32_t start = millis();
+    uint32_t next_dot = start;
+    while (link_state == LinkState::CONNECTING && millis() - start < timeout_ms) {
+        loop();
+        if ((int32_t)(millis() - next_dot) >= 0) {
             controller.serial_port.print(".", "");
-
-            if (WiFi.status() == WL_CONNECTED) {
-                DBG_PRINTLN(Wifi, "join(): connected");
-                controller.serial_port.print(""); // Finish the dot line
-                controller.serial_port.printf("\nJoined %s\nLocal ip: %s\nMac: %s",
-                    ssid.data(),
-                    get_local_ip().c_str(),
-                    get_mac_address().c_str()
-                );
-                return true;
-            }
-            delay(200);
+            next_dot += 500;
         }
-        WiFi.disconnect(true);
-        controller.serial_port.printf("\nUnable to join %s\n", ssid.data());
-        controller.serial_port.print("Check the password\ntry moving closer to router\nand restarting the router\nRetrying");
-        DBG_PRINTLN(Wifi, "join(): timeout, disconnected");
-    }
-    if (retry_count > 1) {
-        // Optimized: Use get_yn with 1 attempt/timeout
-        bool reset_credentials = controller.serial_port.get_yn("Would you like to reset credentials?", 1, 10000);
-        if (reset_credentials) reset();
+        yield();
     }
+    if (link_state == LinkState::CONNECTING) fail_attempt(0);
+    auto_retry = true;
+
+    controller.serial_port.print("");
+    if (link_state == LinkState::CONNECTED) return true;
 
+    controller.serial_port.printf("Unable to join %s (%s)", target_ssid.c_str(), reason_name(last_disconnect_reason));
+    controller.serial_port.print("Check the password\ntry moving closer to router\nand restarting the router");
+    DBG_PRINTLN(Wifi, "join(): failed");
     return false;
 }
 
-std::vector<std::string> Wifi::scan(bool verbose) {
-    DBG_PRINTF(Wifi, "scan(verbose=%d)\n", verbose);
-    if (is_disabled(true)) return {};
+// Scans always run async; results land in scan_table and are shared by
+// `$wifi scan`, the credential prompt and candidate ranking.
+bool Wifi::start_scan(bool force) {
+    DBG_PRINTF(Wifi, "start_scan(force=%d)\n", force);
+    if (scan_running) return true;
+    if (!force && scan_fresh()) return false;
 
-    DBG_PRINTLN(Wifi, "scan(): starting scan");
-    controller.serial_port.print("Scanning WiFi networks...");
-    int num_networks = WiFi.scanNetworks(true, true);
-    while (num_networks == WIFI_SCAN_RUNNING) {
-        delay(10);
-        num_networks = WiFi.scanComplete();
-    }
-    DBG_PRINTF(Wifi, "scan(): scan complete, %d networks found\n", num_networks);
-
-    std::vector<std::string> unique_ssid_list;
-    if (num_networks > 0) {
-        std::set<std::string> seen_ssids;
-        unique_ssid_list.reserve(num_networks);
-        for (int i = 0; i < num_networks; ++i) {
-            String cur = WiFi.SSID(i);
-            if (cur.isEmpty()) continue;
-            std::string ssid(cur.c_str());
-            if (seen_ssids.insert(ssid).second) {
-                unique_ssid_list.push_back(ssid);
-                DBG_PRINTF(Wifi, "scan(): adding [%s]\n", ssid.c_str());
-            }
-        }
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        DBG_PRINTLN(Wifi, "start_scan(): driver refused");
+        return false;
     }
+    scan_started_ms = millis();
+    scan_running    = true;
+    return true;
+}
 
-    if (verbose) {
-        for (size_t j = 0; j < unique_ssid_list.size(); ++j) {
-            // Optimized: Use printf instead of snprintf + print
-            controller.serial_port.printf("%zu. %s", j, unique_ssid_list[j].c_str());
+void Wifi::poll_scan(uint32_t now) {
+    int16_t found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) {
+        if (now - scan_started_ms < SCAN_TIMEOUT_MS) return;
+        found = WIFI_SCAN_FAILED;
+    }
+    DBG_PRINTF(Wifi, "poll_scan(): done, %d results in %lu ms\n", found, (unsigned long)(now - scan_started_ms));
+    scan_running = false;
+    store_scan_results(found);
+    WiFi.scanDelete();
+
+    if (link_state == LinkState::SCANNING) {
+        timing.scan_ms = now - scan_started_ms;
+        rank_candidates();
+        next_candidate();
+    }
+    if (scan_print_pending) {
+        scan_print_pending = false;
+        print_scan_table();
+    }
+    if (roam_pending) {
+        roam_pending = false;
+        evaluate_roam();
+    }
+}
+
+void Wifi::store_scan_results(int16_t found) {
+    scan_count   = 0;
+    scan_done_ms = 0;
+    if (found < 0) return;
+
+    for (int16_t i = 0; i < found; ++i) {
+        const String ssid = WiFi.SSID(i);
+        if (ssid.isEmpty()) continue;
+        const int8_t rssi = static_cast<int8_t>(WiFi.RSSI(i));
+
+        // one row per SSID, holding its strongest BSSID; when full, evict the weakest row
+        ScanEntry* slot = nullptr;
+        for (uint8_t j = 0; j < scan_count; ++j) {
+            if (strncmp(scan_table[j].ssid, ssid.c_str(), sizeof(ScanEntry::ssid)) == 0) { slot = &scan_table[j]; break; }
         }
+        if (slot) {
+            if (rssi <= slot->rssi) continue;
+        } else if (scan_count < SCAN_TABLE_SIZE) {
+            slot = &scan_table[scan_count++];
+        } else {
+            slot = &*std::min_element(scan_table.begin(), scan_table.end(),
+                                      [](const ScanEntry& a, const ScanEntry& b) { return a.rssi < b.rssi; });
+            if (rssi <= slot->rssi) continue;
+        }
+
+        strncpy(slot->ssid, ssid.c_str(), sizeof(slot->ssid) - 1);
+        slot->ssid[sizeof(slot->ssid) - 1] = '\0';
+        if (const uint8_t* bssid = WiFi.BSSID(i)) memcpy(slot->bssid, bssid, sizeof(slot->bssid));
+        slot->channel = static_cast<uint8_t>(WiFi.channel(i));
+        slot->rssi    = rssi;
+        slot->auth    = static_cast<uint8_t>(WiFi.encryptionType(i));
     }
+    std::sort(scan_table.begin(), scan_table.begin() + scan_count,
+              [](const ScanEntry& a, const ScanEntry& b) { return a.rssi > b.rssi; });
+    scan_done_ms = millis();
+}
 
-    WiFi.scanDelete();
-    DBG_PRINTLN(Wifi, "scan(): done");
-    return unique_ssid_list;
+bool Wifi::scan_fresh() const {
+    return scan_done_ms != 0 && millis() - scan_done_ms < SCAN_FRESH_MS;
 }
 
-std::string Wifi::get_local_ip() const {
+// interactive callers only (credential prompt); everything else polls from loop()
+bool Wifi::wait_for_scan() {
+    if (!scan_fresh() && !start_scan(true)) return false;
+    if (scan_running) controller.serial_port.print("Scanning WiFi networks...");
+    while (scan_running) {
+        delay(10);
+        poll_scan(millis());
+    }
+    return scan_done_ms != 0;
+}
+
+void Wifi::scan_cli() {
+    if (is_disabled(true)) return;
+
+    if (scan_fresh()) {
+        print_scan_table();
+        return;
+    }
+    if (!start_scan(true)) {
+        controller.serial_port.print("Error: scan could not be started; try again");
+        return;
+    }
+    scan_print_pending = true;
+    controller.serial_port.print("Scanning WiFi networks; results will follow");
+}
+
+void Wifi::print_scan_table() const {
+    if (scan_count == 0) {
+        controller.serial_port.print("No WiFi networks found");
+        return;
+    }
+
+    vector<vector<string_view>> table_data;
+    table_data.push_back({"#", "SSID", "RSSI", "Ch", "Auth"});
+    vector<string> string_storage;
+    string_storage.reserve(scan_count * 3);
+    for (uint8_t i = 0; i < scan_count; ++i) {
+        const ScanEntry& e = scan_table[i];
+        string_storage.push_back(std::to_string(i));
+        string_view index_view = string_storage.back();
+        string_storage.push_back(std::to_string(e.rssi));
+        string_view rssi_view = string_storage.back();
+        string_storage.push_back(std::to_string(e.channel));
+        string_view channel_view = string_storage.back();
+        table_data.push_back({index_view, e.ssid, rssi_view, channel_view, auth_name(e.auth)});
+    }
+    const uint32_t age_s = (millis() - scan_done_ms) / 1000;
+    controller.serial_port.print_table(table_data, "WiFi Networks (" + std::to_string(age_s) + " s old)");
+}
+
+std::string Wifi::get_local_ip(bool verbose) const {
     DBG_PRINTLN(Wifi, "get_local_ip()");
-    if (is_disabled(true)) return {};
-    if (is_disconnected(true)) return {};
+    if (is_disabled(verbose)) return {};
+    if (is_disconnected(verbose)) return {};
 
     auto ip = WiFi.localIP();
     char buf[16];
@@ -284,17 +1553,17 @@ std::string Wifi::get_local_ip() const {
     return std::string(buf);
 }
 
-std::string Wifi::get_ssid() const {
+std::string Wifi::get_ssid(bool verbose) const {
     DBG_PRINTLN(Wifi, "get_ssid()");
-    if (is_disabled(true)) return {};
-    if (is_disconnected(true)) return {};
-    return controller.nvs.read_str(nvs_key, "ssid");
+    if (is_disabled(verbose)) return {};
+    if (is_disconnected(verbose)) return {};
+    return target_ssid;
 }
 
-std::string Wifi::get_mac_address() const {
+std::string Wifi::get_mac_address(bool verbose) const {
     DBG_PRINTLN(Wifi, "get_mac_address()");
-    if (is_disabled(true)) return {};
-    if (is_disconnected(true)) return {};
+    if (is_disabled(verbose)) return {};
+    if (verbose && is_disconnected(true)) return {};
 
     uint8_t mac[6];
     WiFi.macAddress(mac);
@@ -307,21 +1576,12 @@ std::string Wifi::get_mac_address() const {
     return std::string(buf);
 }
 
-bool Wifi::read_stored_credentials(std::string& ssid, std::string& password) {
-    DBG_PRINTLN(Wifi, "read_stored_credentials()");
-    if (is_disabled(true)) return false;
-    DBG_PRINTLN(Wifi, "read_stored_credentials(): reading NVS");
-    ssid = controller.nvs.read_str(nvs_key, "ssid");
-    password = controller.nvs.read_str(nvs_key, "psw");
-    DBG_PRINTF(Wifi, "read_stored_credentials(): %s\n", ssid.length() > 0 ? "found" : "none");
-    return ssid.length() > 0;
-}
-
 uint8_t Wifi::prompt_credentials(std::string& ssid, std::string& password) {
     DBG_PRINTLN(Wifi, "prompt_credentials()");
     if (is_disabled(true)) return 2;
 
-    std::vector<std::string> networks = scan(true);
+    if (!wait_for_scan()) controller.serial_port.print("Scan failed");
+    print_scan_table();
 
     // Optimized: get_int handles parsing and retry logic directly
     // Min value -3 covers the menu options (-1, -2, -3) and max is high enough for network indices
@@ -338,12 +1598,13 @@ uint8_t Wifi::prompt_credentials(std::string& ssid, std::string& password) {
         return 1;
     } else if (choice == -2) {
         DBG_PRINTLN(Wifi, "prompt_credentials(): user rescan");
+        scan_done_ms = 0;
         return 2;
     } else if (choice == -3) {
         DBG_PRINTLN(Wifi, "prompt_credentials(): user custom ssid");
         ssid = controller.serial_port.get_string("Enter custom SSID: ");
-    } else if (choice >= 0 && choice < static_cast<int>(networks.size())) {
-        ssid = networks[choice];
+    } else if (choice >= 0 && choice < static_cast<int>(scan_count)) {
+        ssid = scan_table[choice].ssid;
         DBG_PRINTF(Wifi, "prompt_credentials(): selected ssid = %s\n", ssid.c_str());
     } else {
         DBG_PRINTLN(Wifi, "prompt_credentials(): invalid choice");
@@ -11,15 +11,27 @@
 #pragma once
 
 #include "../../Module/Module.h"
+#include "../../../XeWeStats.h"
 
 #include <WiFi.h>
-#include <set>
+#include <DNSServer.h>
+#include <ESPmDNS.h>
+#include <ping/ping_sock.h>
+#include <array>
+#include <atomic>
 
 struct WifiConfig : public ModuleConfig {};
 
 
 class Wifi : public Module {
 public:
+    // connection state machine; advanced only from loop(), fed by WiFi.onEvent()
+    enum class LinkState : uint8_t { IDLE, SCANNING, CONNECTING, CONNECTED, BACKOFF };
+    // radio power-save vs. latency tradeoff; BALANCED matches the driver default
+    enum class PowerProfile : uint8_t { PERFORMANCE, BALANCED, LOWPOWER, COUNT };
+
+    using link_listener_t       = function<void(LinkState state)>;
+
     explicit                    Wifi                        (SystemController& controller);
 
     // optional implementation
@@ -34,6 +46,8 @@ public:
                                                              const bool keep_enabled=true)    override;
 
     string                      status                      (const bool verbose=false)      const override;
+    void                        status_json                 (xewe::json::Writer& out)       const override;
+    void                        write_metrics               (xewe::metrics::Writer& out)    const override;
 
     // other methods
     bool                        connect                     (bool prompt_for_credentials);
@@ -41,19 +55,255 @@ public:
     bool                        is_connected                (bool verbose=false) const;
     bool                        is_disconnected             (bool verbose=false) const;
 
-    std::string                 get_local_ip                () const;
-    std::string                 get_ssid                    () const;
-    std::string                 get_mac_address             () const;
+    bool                        add_network                 (std::string_view ssid,
+                                                             std::string_view password,
+                                                             uint8_t priority=0);
+    bool                        forget_network              (std::string_view ssid);
+
+    LinkState                   get_link_state              ()                              const { return link_state; }
+    PowerProfile                get_power_profile           ()                              const { return power_profile; }
+    bool                        set_power_profile           (PowerProfile profile);
+    void                        on_link_change              (link_listener_t listener);
+    static const char*          link_state_name             (LinkState state);
+
+    // SoftAP provisioning portal; pages are served by WebInterface
+    bool                        is_provisioning             ()                              const { return provisioning; }
+    bool                        provision                   (std::string_view ssid,
+                                                             std::string_view password);
+    std::string                 get_portal_ip               () const;
+    // ip in network byte order, e.g. HttpServer::local_ip(): is it the SoftAP's own address
+    bool                        is_portal_address           (uint32_t ip) const;
+    std::string                 scan_results_json           ();
+
+    // verbose=false for JSON writers and other callers that must not print: no
+    // "Not connected" notice, and the MAC is returned whether connected or not
+    std::string                 get_local_ip                (bool verbose=true) const;
+    std::string                 get_ssid                    (bool verbose=true) const;
+    std::string                 get_mac_address             (bool verbose=true) const;
+    std::string                 get_hostname                () const                        { return hostname; }
 
 private:
-    std::vector<std::string>    scan                        (bool verbose);
+    static constexpr uint32_t   CONNECT_TIMEOUT_MS          = 15000;
+    static constexpr uint32_t   FAST_CONNECT_TIMEOUT_MS     = 5000;
+    static constexpr uint32_t   BACKOFF_BASE_MS             = 1000;
+    static constexpr uint32_t   BACKOFF_MAX_MS              = 60000;
+    static constexpr uint32_t   SCAN_TIMEOUT_MS             = 10000;
+    static constexpr uint32_t   SCAN_FRESH_MS               = 30000;
+    static constexpr uint8_t    SCAN_TABLE_SIZE             = 24;
+    static constexpr uint32_t   MONITOR_INTERVAL_MS         = 5000;
+    static constexpr uint32_t   PING_INTERVAL_MS            = 30000;
+    static constexpr int8_t     ROAM_THRESHOLD_DEFAULT      = -75;
+    static constexpr uint8_t    ROAM_LOW_SAMPLES            = 3;    // consecutive weak samples before looking
+    static constexpr uint8_t    ROAM_HYSTERESIS_DB          = 8;
+    static constexpr uint32_t   ROAM_COOLDOWN_MS            = 60000;
+    static constexpr uint8_t    PROBE_COUNT                 = 20;
+    static constexpr uint32_t   PROBE_INTERVAL_MS           = 250;
+    static constexpr uint8_t    PORTAL_AFTER_FAILURES       = 3;    // failed sequences before the portal opens
+    static constexpr uint32_t   PORTAL_CLOSE_DELAY_MS       = 10000;// lets the page show the new address
+    static constexpr uint16_t   DNS_PORT                    = 53;
+    static constexpr uint32_t   DISCOVER_TIMEOUT_MS         = 3000;
+    static constexpr uint8_t    DISCOVER_MAX_RESULTS        = 16;
+    static constexpr uint8_t    MAX_KNOWN_NETWORKS          = 5;
+
+    // bits set by the WiFi event task, consumed by loop()
+    static constexpr uint8_t    EVT_CONNECTED               = 1 << 0;
+    static constexpr uint8_t    EVT_GOT_IP                  = 1 << 1;
+    static constexpr uint8_t    EVT_DISCONNECTED            = 1 << 2;
+
+    // last good association; replayed first to skip the channel scan (and DHCP with ip_reuse)
+    struct LinkCache {
+        std::string             ssid;
+        uint8_t                 bssid[6]                    {};
+        uint8_t                 channel                     {0};
+        uint32_t                ip                          {0};
+        uint32_t                gateway                     {0};
+        uint32_t                subnet                      {0};
+        uint32_t                dns                         {0};
+    };
+
+    // one row of the scan table; strongest BSSID per SSID, sorted by RSSI
+    struct ScanEntry {
+        char                    ssid[33]                    {};
+        uint8_t                 bssid[6]                    {};
+        uint8_t                 channel                     {0};
+        int8_t                  rssi                        {0};
+        uint8_t                 auth                        {0};    // wifi_auth_mode_t
+    };
+
+    struct KnownNetwork {
+        std::string             ssid;
+        std::string             password;
+        uint8_t                 priority                    {0};
+        uint32_t                last_success                {0};    // success sequence number, 0 = never
+    };
+
+    // one planned association of a connect sequence, best first
+    struct Candidate {
+        uint8_t                 network                     {0};    // index into known_networks
+        uint8_t                 bssid[6]                    {};
+        uint8_t                 channel                     {0};    // 0 = not seen, let the driver scan
+        int8_t                  rssi                        {0};
+        int16_t                 score                       {0};
+        bool                    cached                      {false};
+    };
+
+    struct PowerSettings {
+        const char*             name;
+        wifi_ps_type_t          sleep;
+        uint16_t                listen_interval;                    // beacon intervals, used with max modem sleep
+        wifi_power_t            tx_power;
+    };
+
+    // last latency probe per profile, so the profiles can be compared side by side
+    struct ProbeResult {
+        uint8_t                 sent                        {0};
+        uint8_t                 received                    {0};
+        uint32_t                min_ms                      {0};
+        uint32_t                avg_ms                      {0};
+        uint32_t                max_ms                      {0};
+    };
+
+    struct ConnectTiming {
+        uint32_t                fast_fail_ms                {0};    // spent on a failed fast attempt
+        uint32_t                scan_ms                     {0};
+        uint32_t                assoc_ms                    {0};
+        uint32_t                ip_ms                       {0};
+        uint32_t                total_ms                    {0};
+        bool                    fast_path                   {false};
+        bool                    reused_ip                   {false};
+    };
+
+    bool                        start_scan                  (bool force);
+    void                        poll_scan                   (uint32_t now);
+    void                        store_scan_results          (int16_t found);
+    bool                        scan_fresh                  () const;
+    bool                        wait_for_scan               ();
+    void                        scan_cli                    ();
+    void                        print_scan_table            () const;
 
     bool                        join                        (std::string_view ssid,
                                                              std::string_view password,
-                                                             uint16_t timeout_ms=15000,
-                                                             uint8_t retry_count=1);
-    bool                        read_stored_credentials     (std::string& ssid,
-                                                             std::string& password);
+                                                             uint16_t timeout_ms=15000);
     uint8_t                     prompt_credentials          (std::string& ssid,
                                                              std::string& password);
+
+    void                        on_wifi_event               (WiFiEvent_t event,
+                                                             WiFiEventInfo_t info);
+    void                        begin_sequence              ();
+    void                        start_rank_scan             ();
+    void                        rank_candidates             ();
+    void                        next_candidate              ();
+    void                        start_attempt               ();
+    void                        fail_attempt                (uint8_t reason);
+    void                        fail_sequence               ();
+    void                        record_success              ();
+    void                        set_link_state              (LinkState state);
+    void                        load_known_networks         ();
+    void                        save_known_networks         ();
+    int                         find_network                (std::string_view ssid) const;
+    void                        add_network_cli             (std::string_view args);
+    void                        forget_network_cli          (std::string_view args);
+    void                        print_networks              () const;
+    void                        load_link_cache             ();
+    void                        save_link_cache             ();
+    void                        set_ip_reuse                (std::string_view args);
+    void                        sample_link                 (uint32_t now);
+    void                        evaluate_roam               ();
+    void                        start_ping                  ();
+    void                        stop_ping                   ();
+    void                        apply_power_profile         ();
+    void                        apply_listen_interval       ();
+    void                        set_power_cli               (std::string_view args);
+    void                        start_provisioning          ();
+    void                        stop_provisioning           ();
+    void                        set_portal_cli              (std::string_view args);
+    void                        resolve_hostname            ();
+    void                        start_mdns                  ();
+    void                        stop_mdns                   ();
+    void                        start_discovery             ();
+    void                        poll_discovery              ();
+    void                        start_probe                 ();
+    void                        finish_probe                ();
+    void                        print_probes                () const;
+    static esp_ping_config_t    gateway_ping_config         (uint32_t count,
+                                                             uint32_t interval_ms);
+    void                        set_roam_threshold          (std::string_view args);
+    void                        set_ping_monitor            (std::string_view args);
+    void                        print_stats                 () const;
+    template <size_t N>
+    void                        print_histogram             (const xewe::stats::Histogram<N>& hist,
+                                                             string_view title,
+                                                             string_view unit) const;
+    std::string                 format_timing               (const ConnectTiming& timing) const;
+    static const char*          reason_name                 (uint8_t reason);
+    static const char*          auth_name                   (uint8_t auth);
+
+    LinkState                   link_state                  {LinkState::IDLE};
+    std::string                 target_ssid;
+    std::string                 target_password;
+    uint32_t                    attempt_started_ms          {0};
+    uint32_t                    scan_started_ms             {0};
+    uint32_t                    next_attempt_ms             {0};
+    uint8_t                     failed_sequences            {0};
+    uint32_t                    link_lost_count             {0};
+    uint8_t                     last_disconnect_reason      {0};
+    uint32_t                    sequence_started_ms         {0};
+    bool                        fast_attempt                {false};
+    bool                        static_ip_active            {false};
+    bool                        ip_reuse                    {false};
+    LinkCache                   link_cache;
+    vector<KnownNetwork>        known_networks;
+    vector<Candidate>           candidates;
+    size_t                      candidate_pos               {0};
+    uint32_t                    success_seq                 {0};
+    ConnectTiming               timing;
+    array<ScanEntry, SCAN_TABLE_SIZE> scan_table;
+    uint8_t                     scan_count                  {0};
+    uint32_t                    scan_done_ms                {0};    // 0 = no usable results
+    bool                        scan_running                {false};
+    bool                        scan_print_pending          {false};
+    bool                        auto_retry                  {true};
+    bool                        event_handler_attached      {false};
+
+    std::atomic<uint8_t>        pending_events              {0};
+    std::atomic<uint8_t>        pending_reason              {0};
+    std::atomic<uint32_t>       assoc_at_ms                 {0};
+    std::atomic<uint32_t>       got_ip_at_ms                {0};
+
+    vector<link_listener_t>     link_listeners;
+
+    // link monitor; samples are taken from loop() only while connected
+    xewe::stats::Histogram<7>   rssi_hist                   {{-90, -80, -75, -70, -67, -60, -50}};
+    xewe::stats::Histogram<7>   connect_hist                {{250, 500, 1000, 2000, 4000, 8000, 15000}};
+    xewe::stats::Histogram<7>   rtt_hist                    {{5, 10, 20, 50, 100, 200, 500}};
+    xewe::stats::Tally<uint8_t, 8> reason_tally;
+    uint32_t                    last_sample_ms              {0};
+    int8_t                      roam_threshold              {ROAM_THRESHOLD_DEFAULT};   // 0 = roaming off
+    uint8_t                     weak_samples                {0};
+    uint32_t                    last_roam_check_ms          {0};
+    uint32_t                    roam_count                  {0};
+    bool                        roam_pending                {false};
+    bool                        ping_monitor                {false};
+    esp_ping_handle_t           ping_session                {nullptr};
+    uint32_t                    ping_timeouts               {0};
+    std::atomic<uint32_t>       pending_rtt_ms              {0};    // rtt + 1, 0 = no new sample
+    std::atomic<uint32_t>       pending_ping_timeouts       {0};
+
+    static const PowerSettings  POWER_PROFILES              [static_cast<size_t>(PowerProfile::COUNT)];
+    PowerProfile                power_profile               {PowerProfile::BALANCED};
+    ProbeResult                 probe_results               [static_cast<size_t>(PowerProfile::COUNT)];
+    esp_ping_handle_t           probe_session               {nullptr};
+    std::atomic<uint32_t>       probe_received              {0};
+    std::atomic<uint32_t>       probe_sum_ms                {0};
+    std::atomic<uint32_t>       probe_min_ms                {0};
+    std::atomic<uint32_t>       probe_max_ms                {0};
+    std::atomic<bool>           probe_done                  {false};
+
+    DNSServer                   dns_server;
+    bool                        provisioning                {false};
+    uint32_t                    portal_close_at_ms          {0};
+
+    std::string                 hostname;                           // <hostname>.local, also the DHCP name
+    bool                        mdns_started                {false};
+    mdns_search_once_t*         discovery                   {nullptr};
 };
@@ -20,6 +20,7 @@ SystemController::SystemController()
   , buttons(*this)
   , wifi(*this)
   , web_interface(*this)
+  , remote_console(*this)
 {
     modules.push_back(&serial_port);
     modules.push_back(&nvs);
@@ -29,6 +30,8 @@ SystemController::SystemController()
     modules.push_back(&buttons);
     modules.push_back(&wifi);
     modules.push_back(&web_interface);
+    modules.push_back(&remote_console);
+    loop_stats.resize(modules.size());
 }
 
 void SystemController::begin() {
@@ -42,6 +45,8 @@ void SystemController::begin() {
     wifi.begin                      (WifiConfig             {});
     web_interface.add_requirement   (wifi);
     web_interface.begin             (WebInterfaceConfig     {});
+    remote_console.add_requirement  (wifi);
+    remote_console.begin            (RemoteConsoleConfig    {});
 
     // should be initialized last to collect all cmds
     command_parser.begin            (CommandParserConfig    {});
@@ -51,12 +56,30 @@ void SystemController::begin() {
         system.restart();
     }
     serial_port.print_header("System Setup Complete");
+    system.confirm_boot();
 }
 
 void SystemController::loop() {
-    for (Module* m : modules) {
-        if (m && m->is_enabled())
-            m->loop();
+    for (size_t i = 0; i < modules.size(); ++i) {
+        Module* m = modules[i];
+        if (!m || !m->is_enabled()) continue;
+
+        const uint32_t started_us = micros();
+        m->loop();
+        const uint32_t elapsed_us = micros() - started_us;
+
+        LoopStats& stats = loop_stats[i];
+        stats.calls++;
+        stats.total_us += elapsed_us;
+        if (elapsed_us > stats.max_us) stats.max_us = elapsed_us;
+    }
+
+    loop_iterations++;
+    const uint32_t now = millis();
+    if (now - rate_window_start_ms >= 1000) {
+        loop_rate_hz           = static_cast<uint32_t>((loop_iterations - rate_window_start_iter) * 1000 / (now - rate_window_start_ms));
+        rate_window_start_iter = loop_iterations;
+        rate_window_start_ms   = now;
     }
 
     if (serial_port.has_line()) {
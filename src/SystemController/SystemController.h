@@ -19,12 +19,20 @@
 #include "../Modules/Hardware/Buttons/Buttons.h"
 #include "../Modules/Software/Wifi/Wifi.h"
 #include "../Modules/Software/WebInterface/WebInterface.h"
+#include "../Modules/Software/RemoteConsole/RemoteConsole.h"
 
 #include <array>
 #include <vector>
 
 class SystemController {
 public:
+    // time spent in one module's loop(), accumulated since boot
+    struct LoopStats {
+        uint32_t                calls                       {0};
+        uint64_t                total_us                    {0};
+        uint32_t                max_us                      {0};
+    };
+
     SystemController();
 
     void                        begin();
@@ -38,8 +46,17 @@ public:
     Buttons                     buttons;
     Wifi                        wifi;
     WebInterface                web_interface;
+    RemoteConsole               remote_console;
 
     vector<Module*>&            get_modules                 () { return modules; }
+    const LoopStats&            get_loop_stats              (size_t module_index)   const { return loop_stats[module_index]; }
+    uint64_t                    get_loop_iterations         ()                      const { return loop_iterations; }
+    uint32_t                    get_loop_rate               ()                      const { return loop_rate_hz; }
 private:
     vector<Module*>             modules                     {};
+    vector<LoopStats>           loop_stats                  {};
+    uint64_t                    loop_iterations             {0};
+    uint64_t                    rate_window_start_iter      {0};
+    uint32_t                    rate_window_start_ms        {0};
+    uint32_t                    loop_rate_hz                {0};
 };
\ No newline at end of file
@@ -0,0 +1,209 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace xewe::json {
+
+// Streaming JSON writer: tokens go straight to the sink as they are produced, so a
+// document of any size costs a fixed amount of memory. Commas and nesting are
+// tracked here; callers just describe the structure.
+class Writer {
+public:
+    using sink_t = std::function<void(std::string_view)>;
+
+    static constexpr uint8_t MAX_DEPTH = 32;
+
+    explicit Writer(sink_t sink) : sink(std::move(sink)) {}
+
+    Writer& begin_object()                  { open('{'); return *this; }
+    Writer& end_object()                    { close('}'); return *this; }
+    Writer& begin_array()                   { open('['); return *this; }
+    Writer& end_array()                     { close(']'); return *this; }
+
+    Writer& begin_object(std::string_view k) { key(k); return begin_object(); }
+    Writer& begin_array(std::string_view k)  { key(k); return begin_array(); }
+
+    Writer& key(std::string_view k) {
+        separate();
+        write_string(k);
+        sink(":");
+        pending_key = true;
+        return *this;
+    }
+
+    Writer& value(std::string_view v)       { separate(); write_string(v); return *this; }
+    Writer& value(const char* v)            { return v ? value(std::string_view(v)) : null(); }
+    Writer& value(const std::string& v)     { return value(std::string_view(v)); }
+    Writer& value(bool v)                   { separate(); sink(v ? "true" : "false"); return *this; }
+    Writer& null()                          { separate(); sink("null"); return *this; }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Writer& value(T v) {
+        char buf[24];
+        const int n = std::is_signed_v<T>
+            ? std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v))
+            : std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+        separate();
+        sink(std::string_view(buf, n > 0 ? static_cast<size_t>(n) : 0));
+        return *this;
+    }
+
+    Writer& value(double v, uint8_t decimals = 2) {
+        char buf[32];
+        const int n = std::snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        separate();
+        sink(std::string_view(buf, n > 0 ? static_cast<size_t>(n) : 0));
+        return *this;
+    }
+
+    template <typename T>
+    Writer& field(std::string_view k, const T& v) { key(k); return value(v); }
+
+private:
+    void open(char bracket) {
+        separate();
+        sink(std::string_view(&bracket, 1));
+        if (depth < MAX_DEPTH) has_items[depth] = false;
+        depth++;
+    }
+
+    void close(char bracket) {
+        if (depth > 0) depth--;
+        sink(std::string_view(&bracket, 1));
+        if (depth > 0 && depth <= MAX_DEPTH) has_items[depth - 1] = true;
+    }
+
+    // comma before every element but the first of its container; none after a key
+    void separate() {
+        if (pending_key) { pending_key = false; return; }
+        if (depth == 0 || depth > MAX_DEPTH) return;
+        if (has_items[depth - 1]) sink(",");
+        has_items[depth - 1] = true;
+    }
+
+    // unescaped runs are passed through as one piece
+    void write_string(std::string_view s) {
+        sink("\"");
+        size_t run = 0;
+        for (size_t i = 0; i < s.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(s[i]);
+            const char* escape = nullptr;
+            char unicode[7];
+            switch (c) {
+                case '"':  escape = "\\\""; break;
+                case '\\': escape = "\\\\"; break;
+                case '\n': escape = "\\n";  break;
+                case '\r': escape = "\\r";  break;
+                case '\t': escape = "\\t";  break;
+                default:
+                    if (c < 0x20) {
+                        std::snprintf(unicode, sizeof(unicode), "\\u%04x", c);
+                        escape = unicode;
+                    }
+            }
+            if (!escape) continue;
+            if (i > run) sink(s.substr(run, i - run));
+            sink(escape);
+            run = i + 1;
+        }
+        if (run < s.size()) sink(s.substr(run));
+        sink("\"");
+    }
+
+    sink_t  sink;
+    bool    has_items[MAX_DEPTH] {};
+    uint8_t depth       {0};
+    bool    pending_key {false};
+};
+
+// Parses a JSON array of strings (e.g. a command batch). Returns false on anything
+// else or when there are more than max_items entries.
+inline bool parse_string_array(std::string_view text, std::vector<std::string>& out, size_t max_items) {
+    size_t i = 0;
+    auto skip_ws = [&] { while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n')) ++i; };
+    auto hex = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    out.clear();
+    skip_ws();
+    if (i >= text.size() || text[i++] != '[') return false;
+    skip_ws();
+    if (i < text.size() && text[i] == ']') { ++i; skip_ws(); return i == text.size(); }
+
+    for (;;) {
+        skip_ws();
+        if (i >= text.size() || text[i++] != '"') return false;
+        std::string item;
+        for (;;) {
+            if (i >= text.size()) return false;
+            const char c = text[i++];
+            if (c == '"') break;
+            if (static_cast<unsigned char>(c) < 0x20) return false;
+            if (c != '\\') { item.push_back(c); continue; }
+            if (i >= text.size()) return false;
+            switch (text[i++]) {
+                case '"':  item.push_back('"');  break;
+                case '\\': item.push_back('\\'); break;
+                case '/':  item.push_back('/');  break;
+                case 'b':  item.push_back('\b'); break;
+                case 'f':  item.push_back('\f'); break;
+                case 'n':  item.push_back('\n'); break;
+                case 'r':  item.push_back('\r'); break;
+                case 't':  item.push_back('\t'); break;
+                case 'u': {
+                    if (i + 4 > text.size()) return false;
+                    uint32_t cp = 0;
+                    for (int k = 0; k < 4; ++k) {
+                        const int h = hex(text[i++]);
+                        if (h < 0) return false;
+                        cp = (cp << 4) | static_cast<uint32_t>(h);
+                    }
+                    // BMP only; surrogate pairs never show up in CLI commands
+                    if (cp < 0x80) {
+                        item.push_back(static_cast<char>(cp));
+                    } else if (cp < 0x800) {
+                        item.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                        item.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    } else {
+                        item.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                        item.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                        item.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                    }
+                    break;
+                }
+                default: return false;
+            }
+        }
+        if (out.size() >= max_items) return false;
+        out.push_back(std::move(item));
+
+        skip_ws();
+        if (i >= text.size()) return false;
+        const char sep = text[i++];
+        if (sep == ']') break;
+        if (sep != ',') return false;
+    }
+    skip_ws();
+    return i == text.size();
+}
+
+} // namespace xewe::json
@@ -0,0 +1,81 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+namespace xewe::metrics {
+
+// Prometheus text exposition (format 0.0.4) writer. Every line is formatted into a
+// stack buffer and handed to the sink, so rendering never touches the heap.
+// Metric names are prefixed with "xewe_"; label values are expected to be plain
+// identifiers (module names, status names) and are not escaped.
+class Writer {
+public:
+    using sink_t = std::function<void(std::string_view)>;
+
+    explicit Writer(sink_t sink) : sink(std::move(sink)) {}
+
+    // # HELP / # TYPE header; call once before the samples of a family
+    Writer& family(const char* name, const char* type, const char* help) {
+        line("# HELP xewe_%s %s\n# TYPE xewe_%s %s\n", name, help, name, type);
+        return *this;
+    }
+
+    template <typename T>
+    Writer& sample(const char* name, T value) {
+        return sample(name, nullptr, {}, value);
+    }
+
+    template <typename T>
+    Writer& sample(const char* name, const char* label, std::string_view label_value, T value) {
+        char labels[64] = "";
+        if (label) {
+            std::snprintf(labels, sizeof(labels), "{%s=\"%.*s\"}", label,
+                          static_cast<int>(label_value.size()), label_value.data());
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            line("xewe_%s%s %.6g\n", name, labels, static_cast<double>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            line("xewe_%s%s %lld\n", name, labels, static_cast<long long>(value));
+        } else {
+            line("xewe_%s%s %llu\n", name, labels, static_cast<unsigned long long>(value));
+        }
+        return *this;
+    }
+
+    // single-sample families
+    template <typename T>
+    Writer& gauge(const char* name, const char* help, T value) {
+        return family(name, "gauge", help).sample(name, value);
+    }
+
+    template <typename T>
+    Writer& counter(const char* name, const char* help, T value) {
+        return family(name, "counter", help).sample(name, value);
+    }
+
+private:
+    template <typename... Args>
+    void line(const char* fmt, Args... args) {
+        char buf[192];
+        const int n = std::snprintf(buf, sizeof(buf), fmt, args...);
+        if (n <= 0) return;
+        sink(std::string_view(buf, static_cast<size_t>(n) < sizeof(buf) ? static_cast<size_t>(n) : sizeof(buf) - 1));
+    }
+
+    sink_t sink;
+};
+
+} // namespace xewe::metrics
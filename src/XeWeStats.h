@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *  SPDX-License-Identifier: LicenseRef-PolyForm-NC-1.0.0-NoAI
+ *
+ *  Licensed under PolyForm Noncommercial 1.0.0 + No AI Use Addendum v1.0.
+ *  See: LICENSE and LICENSE-NO-AI.md in the project root for full terms.
+ *
+ *  Required Notice: Copyright 2025 Maxim Dokukin (https://maxdokukin.com)
+ *  https://github.com/maxdokukin/xewe-os
+ *********************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace xewe::stats {
+
+// Fixed-bucket histogram: N inclusive upper bounds (ascending) plus one overflow bucket.
+// No allocation, O(N) insert; meant for low-rate samples on the main loop.
+template <size_t N>
+class Histogram {
+public:
+    explicit constexpr Histogram(const std::array<int32_t, N>& bounds) : bounds(bounds) {}
+
+    void add(int32_t value) {
+        size_t i = 0;
+        while (i < N && value > bounds[i]) ++i;
+        counts[i]++;
+        if (total == 0 || value < lo) lo = value;
+        if (total == 0 || value > hi) hi = value;
+        sum += value;
+        total++;
+    }
+
+    void reset() {
+        counts.fill(0);
+        total = 0;
+        sum   = 0;
+        lo    = 0;
+        hi    = 0;
+    }
+
+    static constexpr size_t size() { return N + 1; }
+
+    uint32_t count()              const { return total; }
+    uint32_t count(size_t bucket) const { return counts[bucket]; }
+    int32_t  min()                const { return lo; }
+    int32_t  max()                const { return hi; }
+    int32_t  mean()               const { return total ? static_cast<int32_t>(sum / total) : 0; }
+
+    // upper bound of bucket i; the overflow bucket reports the largest sample seen
+    int32_t upper(size_t bucket) const { return bucket < N ? bounds[bucket] : hi; }
+
+    // bucket-resolution percentile (0-100): the upper bound of the bucket holding it
+    int32_t percentile(uint8_t p) const {
+        if (total == 0) return 0;
+        const uint64_t target = (static_cast<uint64_t>(total) * p + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < N + 1; ++i) {
+            seen += counts[i];
+            if (seen >= target && seen > 0) return upper(i) < hi ? upper(i) : hi;
+        }
+        return hi;
+    }
+
+    // "<= 50", "51..100", "> 400" style label for bucket i
+    std::string label(size_t bucket) const {
+        if (bucket == 0) return "<= " + std::to_string(bounds[0]);
+        if (bucket >= N) return "> " + std::to_string(bounds[N - 1]);
+        return std::to_string(bounds[bucket - 1] + 1) + ".." + std::to_string(bounds[bucket]);
+    }
+
+private:
+    std::array<int32_t, N>      bounds;
+    std::array<uint32_t, N + 1> counts {};
+    uint32_t                    total  {0};
+    int64_t                     sum    {0};
+    int32_t                     lo     {0};
+    int32_t                     hi     {0};
+};
+
+// Counts per small key (e.g. disconnect reason codes) in N fixed slots;
+// keys arriving after the table is full are folded into other().
+template <typename Key, size_t N>
+class Tally {
+public:
+    void add(Key key) {
+        for (size_t i = 0; i < used; ++i) {
+            if (keys[i] == key) { counts[i]++; return; }
+        }
+        if (used < N) {
+            keys[used]   = key;
+            counts[used] = 1;
+            used++;
+            return;
+        }
+        overflow++;
+    }
+
+    void reset() { used = 0; overflow = 0; }
+
+    size_t   size()            const { return used; }
+    Key      key(size_t i)     const { return keys[i]; }
+    uint32_t count(size_t i)   const { return counts[i]; }
+    uint32_t other()           const { return overflow; }
+
+private:
+    std::array<Key, N>          keys     {};
+    std::array<uint32_t, N>     counts   {};
+    size_t                      used     {0};
+    uint32_t                    overflow {0};
+};
+
+} // namespace xewe::stats
@@ -52,6 +52,44 @@ inline std::string to_hex(const uint8_t* b, size_t n) {
     for (size_t i = 0; i < n; i++) { s.push_back(k[b[i] >> 4]); s.push_back(k[b[i] & 0x0F]); }
     return s;
 }
+
+// Inverse of to_hex; returns false unless s holds exactly n bytes of hex.
+inline bool from_hex(std::string_view s, uint8_t* out, size_t n) {
+    if (s.size() != n * 2) return false;
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    for (size_t i = 0; i < n; i++) {
+        int hi = nibble(s[2 * i]), lo = nibble(s[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+// Escapes s for use inside a JSON string literal (quotes not included).
+inline std::string json_escape(std::string_view s) {
+    std::string out; out.reserve(s.size() + 8);
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* k = "0123456789abcdef";
+                    out += "\\u00"; out.push_back(k[(c >> 4) & 0x0F]); out.push_back(k[c & 0x0F]);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    return out;
+}
 // --------------------------------------------------------------------------------------
 // Small, header-only string utilities intended for embedded targets.
 // Keep allocations modest and avoid exceptions.
@@ -115,6 +153,28 @@ inline std::vector<std::string> split_by_token(std::string_view s, std::string_v
     return out;
 }
 
+// Split command arguments on spaces; a double-quoted token keeps its spaces (quotes stripped).
+inline std::vector<std::string> split_args(std::string_view s) {
+    std::vector<std::string> out;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
+        if (i >= s.size()) break;
+        if (s[i] == '"') {
+            size_t q = s.find('"', i + 1);
+            if (q == std::string_view::npos) q = s.size();
+            out.emplace_back(s.substr(i + 1, q - i - 1));
+            i = q + 1;
+        } else {
+            size_t j = i;
+            while (j < s.size() && !std::isspace(static_cast<unsigned char>(s[j]))) ++j;
+            out.emplace_back(s.substr(i, j - i));
+            i = j;
+        }
+    }
+    return out;
+}
+
 // Break a string into fixed-width chunks (character-based wrap).
 inline std::vector<std::string> wrap_fixed(std::string_view s, size_t width) {
     std::vector<std::string> out;